@@ -3,17 +3,104 @@
 #include <stdlib.h>
 #include <string.h>
 
-void remove_whitespace(char *str) {
-    char *dst = str;  // Destination pointer
-    char *src = str;  // Source pointer
+// The input is read through a fixed window and the testbench is written through a large
+// buffer, so memory use does not depend on the input size.
+// Both can be overridden with -D; make check shrinks them to cross every boundary.
+#ifndef INPUT_WINDOW_SIZE
+#define INPUT_WINDOW_SIZE (64 * 1024)
+#endif
+#ifndef OUTPUT_BUFFER_SIZE
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+#endif
 
-    while (*src) {
-        if (!isspace((unsigned char)*src)) {
-            *dst++ = *src;
+typedef struct {
+    FILE *file;
+    char data[OUTPUT_BUFFER_SIZE];
+    size_t used;
+} OutputBuffer;
+
+typedef struct {
+    FILE *file;
+    char data[INPUT_WINDOW_SIZE];
+    size_t pos;
+    size_t len;
+} InputWindow;
+
+static void out_flush(OutputBuffer *out) {
+    fwrite(out->data, 1, out->used, out->file);
+    out->used = 0;
+}
+
+static void out_write(OutputBuffer *out, const char *s, size_t len) {
+    if (out->used + len > OUTPUT_BUFFER_SIZE) {
+        out_flush(out);
+    }
+    memcpy(out->data + out->used, s, len);
+    out->used += len;
+}
+
+static void out_puts(OutputBuffer *out, const char *s) {
+    out_write(out, s, strlen(s));
+}
+
+// Decimal formatting without printf
+static void out_int(OutputBuffer *out, int value) {
+    char digits[12];
+    int n = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        digits[sizeof(digits) - 1 - n++] = '-';
+    }
+    out_write(out, digits + sizeof(digits) - n, n);
+}
+
+static void out_send_char(OutputBuffer *out, char ch) {
+    char line[] = "        send_char(\"?\");\n";
+
+    line[19] = ch;
+    out_write(out, line, sizeof(line) - 1);
+}
+
+// Next input byte, or EOF
+static int in_next(InputWindow *in) {
+    if (in->pos == in->len) {
+        in->len = fread(in->data, 1, INPUT_WINDOW_SIZE, in->file);
+        in->pos = 0;
+        if (in->len == 0) {
+            return EOF;
         }
-        src++;
     }
-    *dst = '\0';  // Null-terminate the modified string
+    return (unsigned char)in->data[in->pos++];
+}
+
+// One character of the input, prev_char is the character before it
+static void emit_char(OutputBuffer *out, char current_char, char prev_char) {
+    // Skip whitespace characters
+    if (current_char == ' ' || current_char == '\t' || current_char == '\n' || current_char == '\r') {
+        return;
+    }
+
+    // Check if the character should be skipped
+    if (!isalnum(current_char) && 
+    current_char != '<' && current_char != '>' && 
+    current_char != '=' && current_char != ';' && 
+    current_char != '(' && current_char != ')') {
+    return;
+    }
+
+    // Generate send_char statement for this character
+    if(prev_char == '-' && isdigit(current_char)) {
+        out_send_char(out, '-');
+        out_send_char(out, current_char);
+    }
+    else{
+        out_send_char(out, current_char);
+    }
 }
 
 void generate_testbench(const char *input_filename, const char *output_filename, int x) {
@@ -32,122 +119,125 @@ void generate_testbench(const char *input_filename, const char *output_filename,
         return;
     }
 
-    // Write testbench header
-    fprintf(output_file, "module if_else_parser_tb();\n\n");
-    fprintf(output_file, "    reg clk, rst;\n");
-    fprintf(output_file, "    reg signed [31:0] x;\n");
-    fprintf(output_file, "    reg [6:0] ascii_char;\n");
-    fprintf(output_file, "    reg char_valid;\n");
-    fprintf(output_file, "    wire signed [31:0] p;\n");
-    fprintf(output_file, "    wire parsing_done;\n");
-    fprintf(output_file, "    wire error_flag;\n\n");
-    fprintf(output_file, "    // Instantiate the parser\n");
-    fprintf(output_file, "    if_else_parser uut (\n");
-    fprintf(output_file, "        .clk(clk),\n");
-    fprintf(output_file, "        .rst(rst),\n");
-    fprintf(output_file, "        .x(x),\n");
-    fprintf(output_file, "        .ascii_char(ascii_char),\n");
-    fprintf(output_file, "        .char_valid(char_valid),\n");
-    fprintf(output_file, "        .p(p),\n");
-    fprintf(output_file, "        .parsing_done(parsing_done),\n");
-    fprintf(output_file, "        .error_flag(error_flag)\n");
-    fprintf(output_file, "    );\n\n");
-    fprintf(output_file, "    // Generate a clock: 10 ns period\n");
-    fprintf(output_file, "    always #5 clk = ~clk;\n\n");
-    fprintf(output_file, "    // Task to send a character for one cycle.\n");
-    fprintf(output_file, "    task send_char(input [6:0] ch);\n");
-    fprintf(output_file, "    begin\n");
-    fprintf(output_file, "        ascii_char = ch;\n");
-    fprintf(output_file, "        char_valid = 1;\n");
-    fprintf(output_file, "        #5;\n");
-    fprintf(output_file, "        #5; // full clock cycle complete\n");
-    fprintf(output_file, "        char_valid = 0;\n");
-    fprintf(output_file, "    end\n");
-    fprintf(output_file, "    endtask\n\n");
-
-    // Read input file to a buffer
-    fseek(input_file, 0, SEEK_END);
-    long file_size = ftell(input_file);
-    fseek(input_file, 0, SEEK_SET);
-    
-    char *input_buffer = (char *)malloc(file_size + 1);
-    if (!input_buffer) {
+    OutputBuffer *out = malloc(sizeof(OutputBuffer));
+    InputWindow *in = malloc(sizeof(InputWindow));
+    if (!out || !in) {
         perror("Memory allocation failed");
+        free(out);
+        free(in);
         fclose(input_file);
         fclose(output_file);
         return;
     }
-    
-    fread(input_buffer, 1, file_size, input_file);
-    input_buffer[file_size] = '\0';
+    out->file = output_file;
+    out->used = 0;
+    in->file = input_file;
+    in->pos = 0;
+    in->len = 0;
+
+    // Write testbench header
+    out_puts(out, "module if_else_parser_tb();\n\n");
+    out_puts(out, "    reg clk, rst;\n");
+    out_puts(out, "    reg signed [31:0] x;\n");
+    out_puts(out, "    reg [6:0] ascii_char;\n");
+    out_puts(out, "    reg char_valid;\n");
+    out_puts(out, "    wire signed [31:0] p;\n");
+    out_puts(out, "    wire parsing_done;\n");
+    out_puts(out, "    wire error_flag;\n\n");
+    out_puts(out, "    // Instantiate the parser\n");
+    out_puts(out, "    if_else_parser uut (\n");
+    out_puts(out, "        .clk(clk),\n");
+    out_puts(out, "        .rst(rst),\n");
+    out_puts(out, "        .x(x),\n");
+    out_puts(out, "        .ascii_char(ascii_char),\n");
+    out_puts(out, "        .char_valid(char_valid),\n");
+    out_puts(out, "        .p(p),\n");
+    out_puts(out, "        .parsing_done(parsing_done),\n");
+    out_puts(out, "        .error_flag(error_flag)\n");
+    out_puts(out, "    );\n\n");
+    out_puts(out, "    // Generate a clock: 10 ns period\n");
+    out_puts(out, "    always #5 clk = ~clk;\n\n");
+    out_puts(out, "    // Task to send a character for one cycle.\n");
+    out_puts(out, "    task send_char(input [6:0] ch);\n");
+    out_puts(out, "    begin\n");
+    out_puts(out, "        ascii_char = ch;\n");
+    out_puts(out, "        char_valid = 1;\n");
+    out_puts(out, "        #5;\n");
+    out_puts(out, "        #5; // full clock cycle complete\n");
+    out_puts(out, "        char_valid = 0;\n");
+    out_puts(out, "    end\n");
+    out_puts(out, "    endtask\n\n");
 
-    // Remove whitespace characters from the input buffer
-    remove_whitespace(input_buffer);
-    
     // Write the initial test setup
-    fprintf(output_file, "    // Test stimulus: sending the code from input.v\n");
-    fprintf(output_file, "    initial begin\n");
-    fprintf(output_file, "        clk = 0;\n");
-    fprintf(output_file, "        rst = 1;\n");
+    out_puts(out, "    // Test stimulus: sending the code from input.v\n");
+    out_puts(out, "    initial begin\n");
+    out_puts(out, "        clk = 0;\n");
+    out_puts(out, "        rst = 1;\n");
 
-    fprintf(output_file, "        x = %d;\n", x);
+    out_puts(out, "        x = ");
+    out_int(out, x);
+    out_puts(out, ";\n");
     
-    fprintf(output_file, "        char_valid = 0;\n");
-    fprintf(output_file, "        #20;\n");
-    fprintf(output_file, "        rst = 0;\n\n");
-
-    // Process each character from the input file
-    for (int i = 0; i < file_size; i++) {
-        char current_char = input_buffer[i];
-        char prev_char = i > 0 ? input_buffer[i - 1] : '\0';
-        
-        // Skip whitespace characters
-        if (current_char == ' ' || current_char == '\t' || current_char == '\n' || current_char == '\r') {
-            continue;
-        }
+    out_puts(out, "        char_valid = 0;\n");
+    out_puts(out, "        #20;\n");
+    out_puts(out, "        rst = 0;\n\n");
 
-        // Check if the character should be skipped
-        if (!isalnum(current_char) && 
-        current_char != '<' && current_char != '>' && 
-        current_char != '=' && current_char != ';' && 
-        current_char != '(' && current_char != ')') {
-        continue;
+    // Process each character from the input file. Whitespace is dropped as the input
+    // streams by; the input ends at the first NUL byte. Only the non-whitespace
+    // characters count towards the length of the compacted input.
+    long compacted = 0;
+    char prev_char = '\0';
+    int c;
+    while ((c = in_next(in)) != EOF && c != '\0') {
+        if (isspace(c)) {
+            continue;
         }
-        
-        // Generate send_char statement for this character
-        // fprintf(output_file, "        send_char(\"%c\");\n", current_char);
+        emit_char(out, (char)c, prev_char);
+        prev_char = (char)c;
+        compacted++;
+    }
 
-        if(prev_char == '-' && isdigit(current_char)) {
-            fprintf(output_file, "        send_char(\"-\");\n");
-            fprintf(output_file, "        send_char(\"%c\");\n", current_char);
-        }
-        else{
-            fprintf(output_file, "        send_char(\"%c\");\n", current_char);
+    // The testbench used to compact the whitespace in place and then walk the whole
+    // original length, so the original bytes after the compacted part (and its NUL
+    // terminator) are sent as well. Replay them from the file to keep the output the same.
+    if (fseek(input_file, compacted + 1, SEEK_SET) == 0) {
+        in->pos = 0;
+        in->len = 0;
+        prev_char = '\0';
+        while ((c = in_next(in)) != EOF) {
+            emit_char(out, (char)c, prev_char);
+            prev_char = (char)c;
         }
     }
 
     // Write the closing part of the testbench
-    fprintf(output_file, "\n        // Wait some cycles for the parser to finish processing\n");
-    fprintf(output_file, "        if (parsing_done && !error_flag)\n");
-    fprintf(output_file, "            $display(\"Test passed. p = %%d\", p);\n");
-    fprintf(output_file, "        else if (error_flag)\n");
-    fprintf(output_file, "            $display(\"Unexpected error.\");\n");
-    fprintf(output_file, "        else if(!error_flag && !parsing_done)\n");
-    fprintf(output_file, "            $display(\"Parsing failed, you might be assigning non-integer values, or having different identifiers assigned in the input snippet.\");\n");
-    fprintf(output_file, "        $finish;\n");
-    fprintf(output_file, "    end\n\n");
-    fprintf(output_file, "endmodule\n");
+    out_puts(out, "\n        // Wait some cycles for the parser to finish processing\n");
+    out_puts(out, "        if (parsing_done && !error_flag)\n");
+    out_puts(out, "            $display(\"Test passed. p = %d\", p);\n");
+    out_puts(out, "        else if (error_flag)\n");
+    out_puts(out, "            $display(\"Unexpected error.\");\n");
+    out_puts(out, "        else if(!error_flag && !parsing_done)\n");
+    out_puts(out, "            $display(\"Parsing failed, you might be assigning non-integer values, or having different identifiers assigned in the input snippet.\");\n");
+    out_puts(out, "        $finish;\n");
+    out_puts(out, "    end\n\n");
+    out_puts(out, "endmodule\n");
 
     // Clean up
-    free(input_buffer);
+    out_flush(out);
+    free(out);
+    free(in);
     fclose(input_file);
     fclose(output_file);
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+    // Optional arguments: input file and generated testbench file
+    const char *input_filename = argc > 1 ? argv[1] : "input.v";
+    const char *output_filename = argc > 2 ? argv[2] : "if_else_parser_tb_gen.v";
+
     int x;
     printf("Enter the user input x: ");
     scanf("%d", &x);
-    generate_testbench("input.v", "if_else_parser_tb_gen.v", x);
+    generate_testbench(input_filename, output_filename, x);
     return 0;
 }
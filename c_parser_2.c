@@ -3,222 +3,396 @@
 #include <stdlib.h>
 #include <string.h>
 
-void generate_testbench(const char *input_filename, const char *output_filename, int x_value) {
-    // Open input file
-    FILE *input_file = fopen(input_filename, "r");
-    if (!input_file) {
-        perror("Failed to open input file");
-        return;
+// The input is read through a fixed window and the output is written through a large
+// buffer, so memory use does not depend on the input size.
+// Both can be overridden with -D; make check shrinks them to cross every boundary.
+#ifndef INPUT_WINDOW_SIZE
+#define INPUT_WINDOW_SIZE (64 * 1024)
+#endif
+#ifndef OUTPUT_BUFFER_SIZE
+#define OUTPUT_BUFFER_SIZE (1024 * 1024)
+#endif
+
+typedef struct {
+    FILE *file;
+    char data[OUTPUT_BUFFER_SIZE];
+    size_t used;
+} OutputBuffer;
+
+typedef struct {
+    FILE *file;
+    char data[INPUT_WINDOW_SIZE];
+    size_t pos;
+    size_t len;
+} InputWindow;
+
+static void out_flush(OutputBuffer *out) {
+    fwrite(out->data, 1, out->used, out->file);
+    out->used = 0;
+}
+
+static void out_write(OutputBuffer *out, const char *s, size_t len) {
+    if (out->used + len > OUTPUT_BUFFER_SIZE) {
+        out_flush(out);
     }
+    memcpy(out->data + out->used, s, len);
+    out->used += len;
+}
 
-    // Open output file
-    FILE *output_file = fopen(output_filename, "w");
-    if (!output_file) {
-        perror("Failed to open output file");
-        fclose(input_file);
-        return;
+static void out_puts(OutputBuffer *out, const char *s) {
+    out_write(out, s, strlen(s));
+}
+
+// Decimal formatting without printf
+static void out_int(OutputBuffer *out, int value) {
+    char digits[12];
+    int n = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) {
+        digits[sizeof(digits) - 1 - n++] = '-';
     }
+    out_write(out, digits + sizeof(digits) - n, n);
+}
 
-    // Write testbench header
-    fprintf(output_file, "module if_else_parser_tb();\n\n");
-    fprintf(output_file, "    reg clk, rst;\n");
-    fprintf(output_file, "    reg signed [31:0] x;\n");
-    fprintf(output_file, "    reg [6:0] ascii_char;\n");
-    fprintf(output_file, "    reg char_valid;\n");
-    fprintf(output_file, "    wire signed [31:0] p;\n");
-    fprintf(output_file, "    wire [16*7-1:0] assignment_var;\n");
-    fprintf(output_file, "    wire [3:0] assignment_var_length;\n");
-    fprintf(output_file, "    wire parsing_done;\n");
-    fprintf(output_file, "    wire error_flag;\n");
-    fprintf(output_file, "    wire [3:0] error_code;\n\n");
-    
-    fprintf(output_file, "    // Error codes\n");
-    fprintf(output_file, "    parameter NO_ERROR          = 4'd0,\n");
-    fprintf(output_file, "              INVALID_KEYWORD   = 4'd1,\n");
-    fprintf(output_file, "              VAR_MISMATCH      = 4'd2,\n");
-    fprintf(output_file, "              INVALID_CHAR      = 4'd3,\n");
-    fprintf(output_file, "              MISSING_SEMICOLON = 4'd4,\n");
-    fprintf(output_file, "              MISSING_OPERATOR  = 4'd5,\n");
-    fprintf(output_file, "              SYNTAX_ERROR      = 4'd6,\n");
-    fprintf(output_file, "              PAREN_MISMATCH    = 4'd7;\n\n");
-    
-    fprintf(output_file, "    // Instantiate the parser\n");
-    fprintf(output_file, "    if_else_parser_2 uut (\n");
-    fprintf(output_file, "        .clk(clk),\n");
-    fprintf(output_file, "        .rst(rst),\n");
-    fprintf(output_file, "        .x(x),\n");
-    fprintf(output_file, "        .ascii_char(ascii_char),\n");
-    fprintf(output_file, "        .char_valid(char_valid),\n");
-    fprintf(output_file, "        .p(p),\n");
-    fprintf(output_file, "        .assignment_var(assignment_var),\n");
-    fprintf(output_file, "        .assignment_var_length(assignment_var_length),\n");
-    fprintf(output_file, "        .parsing_done(parsing_done),\n");
-    fprintf(output_file, "        .error_flag(error_flag),\n");
-    fprintf(output_file, "        .error_code(error_code)\n");
-    fprintf(output_file, "    );\n\n");
-    fprintf(output_file, "    // Generate a clock: 10 ns period\n");
-    fprintf(output_file, "    always #5 clk = ~clk;\n\n");
-    fprintf(output_file, "    // Task to send a character for one cycle.\n");
-    fprintf(output_file, "    task send_char(input [6:0] ch);\n");
-    fprintf(output_file, "    begin\n");
-    fprintf(output_file, "        ascii_char = ch;\n");
-    fprintf(output_file, "        char_valid = 1;\n");
-    fprintf(output_file, "        #5;\n");
-    fprintf(output_file, "        #5; // full clock cycle complete\n");
-    fprintf(output_file, "        char_valid = 0;\n");
-    fprintf(output_file, "    end\n");
-    fprintf(output_file, "    endtask\n\n");
+// Next input byte without consuming it, or EOF
+static int in_peek(InputWindow *in) {
+    if (in->pos == in->len) {
+        in->len = fread(in->data, 1, INPUT_WINDOW_SIZE, in->file);
+        in->pos = 0;
+        if (in->len == 0) {
+            return EOF;
+        }
+    }
+    return (unsigned char)in->data[in->pos];
+}
 
-    // write the extract_var_name function
-    fprintf(output_file, "    // Helper function to extract variable name from packed format\n");
-    fprintf(output_file, "    function [8*16:1] extract_var_name;\n");
-    fprintf(output_file, "        input [16*7-1:0] packed_var;\n");
-    fprintf(output_file, "        input [3:0] length;\n");
-    fprintf(output_file, "        reg [6:0] char;\n");
-    fprintf(output_file, "        integer i;\n");
-    fprintf(output_file, "    begin\n");
-    fprintf(output_file, "        extract_var_name = 0;\n");
-    fprintf(output_file, "        for (i = 0; i < length; i = i + 1) begin\n");
-    fprintf(output_file, "            char = (packed_var >> (i*7)) & 7'h7F;\n");
-    fprintf(output_file, "            extract_var_name[8*(length-i) -: 8] = char;\n");
-    fprintf(output_file, "        end\n");
-    fprintf(output_file, "    end\n");
-    fprintf(output_file, "    endfunction\n\n");
-
-    // Read input file to a buffer
-    fseek(input_file, 0, SEEK_END);
-    long file_size = ftell(input_file);
-    fseek(input_file, 0, SEEK_SET);
-    
-    char *input_buffer = (char *)malloc(file_size + 1);
-    if (!input_buffer) {
-        perror("Memory allocation failed");
-        fclose(input_file);
-        fclose(output_file);
-        return;
+static int in_next(InputWindow *in) {
+    int c = in_peek(in);
+
+    if (c != EOF) {
+        in->pos++;
     }
-    
-    fread(input_buffer, 1, file_size, input_file);
-    input_buffer[file_size] = '\0';
-    
-    // Write the initial test setup
-    fprintf(output_file, "    // Test stimulus: sending the code from input.v\n");
-    fprintf(output_file, "    initial begin\n");
-    fprintf(output_file, "        clk = 0;\n");
-    fprintf(output_file, "        rst = 1;\n");
+    return c;
+}
 
-    fprintf(output_file, "        // Set the input value that will be used when evaluating the condition\n");
-    fprintf(output_file, "        x = %d;\n", x_value);
-    
-    fprintf(output_file, "        char_valid = 0;\n");
-    fprintf(output_file, "        #20;\n");
-    fprintf(output_file, "        rst = 0;\n\n");
+// Set up the buffers for a generator, returns 0 if memory ran out
+static int open_buffers(OutputBuffer **out, InputWindow **in, FILE *output_file, FILE *input_file) {
+    *out = malloc(sizeof(OutputBuffer));
+    *in = malloc(sizeof(InputWindow));
+    if (!*out || !*in) {
+        perror("Memory allocation failed");
+        free(*out);
+        free(*in);
+        return 0;
+    }
+    (*out)->file = output_file;
+    (*out)->used = 0;
+    (*in)->file = input_file;
+    (*in)->pos = 0;
+    (*in)->len = 0;
+    return 1;
+}
 
-    fprintf(output_file, "        // Send each character of the if-else code to the parser\n");
-    
-    // Process each character from the input file
-    int i = 0;
+// Pass every character of the if-else block to emit: from the first "if" up to the "end"
+// that closes the else branch. Carriage returns are dropped. The keyword checks look at
+// the last five input chars (carriage returns included), kept in recent.
+static void emit_if_else(InputWindow *in, void (*emit)(OutputBuffer *out, char ch), OutputBuffer *out) {
+    long i = 0;
     int found_if = 0;
     int found_complete_if_else = 0;
     int block_depth = 0;
+    char recent[5] = {0};
+    int c;
 
-    while (i < file_size) {
-        char ch = input_buffer[i++];
+    while ((c = in_next(in)) != EOF) {
+        char ch = (char)c;
+        i++;
+        memmove(recent, recent + 1, 4);
+        recent[4] = ch;
         
         // Detect beginning of "if" statement
-        if (!found_if && i < file_size && ch == 'i' && input_buffer[i] == 'f') {
+        if (!found_if && ch == 'i' && in_peek(in) == 'f') {
             found_if = 1;
         }
         
         if (found_if) {
             // Track block depth with braces
-            if (ch == '{' || (i >= 5 && strncmp(&input_buffer[i-5], "begin", 5) == 0)) {
+            if (ch == '{' || (i >= 5 && memcmp(recent, "begin", 5) == 0)) {
                 block_depth++;
             }
-            else if (ch == '}' || (i >= 3 && strncmp(&input_buffer[i-3], "end", 3) == 0)) {
+            else if (ch == '}' || (i >= 3 && memcmp(recent + 2, "end", 3) == 0)) {
                 block_depth--;
-                if (block_depth == 0 && found_complete_if_else) {
-                    // End of if-else structure reached - but keep emitting until we're done
-                    // i += 3; // Skip "end" so we include it
-                }
             }
             
             // Detect else keyword
-            if (i >= 4 && strncmp(&input_buffer[i-4], "else", 4) == 0) {
+            if (i >= 4 && memcmp(recent + 1, "else", 4) == 0) {
                 found_complete_if_else = 1;
             }
             
-            // Output character with proper escaping
-            if (ch == '\n') {
-                fprintf(output_file, "        send_char(\"\\n\");\n");
-            } 
-            else if (ch == '\t') {
-                fprintf(output_file, "        send_char(\"\\t\");\n");
-            }
-            else if (ch == '\r') {
-                // Skip carriage returns
+            // Skip carriage returns
+            if (ch == '\r') {
                 continue;
             }
-            else if (ch == ' ') {
-                fprintf(output_file, "        send_char(\" \");\n");
-            }
-            else if (isprint(ch)) {
-                fprintf(output_file, "        send_char(\"%c\");\n", ch);
-            }
-            else {
-                fprintf(output_file, "        send_char(%d);\n", (int)ch);
-            }
+            emit(out, ch);
             
             // If we've completed the if-else structure and also processed the "end", THEN stop
             if (found_complete_if_else && block_depth == 0 && 
-                i >= 3 && strncmp(&input_buffer[i-3], "end", 3) == 0) {
+                i >= 3 && memcmp(recent + 2, "end", 3) == 0) {
                 break;
             }
         }
     }
+}
 
-    fprintf(output_file, "\n        // Wait for parsing to complete\n");
-    fprintf(output_file, "        wait(parsing_done || error_flag);\n");
-    fprintf(output_file, "        #20;\n\n");
-    fprintf(output_file, "        // Display results\n");
-    fprintf(output_file, "        if (parsing_done && !error_flag) begin\n");
-    fprintf(output_file, "            $display(\"Test passed! Value %%d assigned to the variable: %%s. (var length: %%d)\", \n");
-    fprintf(output_file, "                    p, extract_var_name(assignment_var, assignment_var_length),\n");
-    fprintf(output_file, "                    assignment_var_length);\n");
-    fprintf(output_file, "        end\n");
-    fprintf(output_file, "        else if (error_flag) begin\n");
-    fprintf(output_file, "            $display(\"Error: %%s (%%0d)\", \n");
-    fprintf(output_file, "                    error_code == 0 ? \"No Error\" :\n");
-    fprintf(output_file, "                    error_code == 1 ? \"Invalid Keyword. One of more of the keywords 'begin', 'end', 'if', 'else' are missing or misspelled.\" :\n");
-    fprintf(output_file, "                    error_code == 2 ? \"Variable Mismatch. The variable names in the true and false branch assignments do not match.\" :\n");
-    fprintf(output_file, "                    error_code == 3 ? \"Invalid Character. You may have entered a character that is not allowed.\" :\n");
-    fprintf(output_file, "                    error_code == 4 ? \"Missing Semicolon\" :\n");
-    fprintf(output_file, "                    error_code == 5 ? \"Missing Operator\" :\n");
-    fprintf(output_file, "                    error_code == 6 ? \"There seems to be a Syntax Error, incorrect use of parantheses, or use of illegal characters.\" :\n");
-    fprintf(output_file, "                    error_code == 7 ? \"Parenthesis Mismatch. You may have mismatched parentheses, or parantheses at invalid places.\" : \"Unknown Error\",\n");
-    fprintf(output_file, "                    error_code);\n");
-    fprintf(output_file, "        end\n");
-    fprintf(output_file, "        else begin\n");
-    fprintf(output_file, "            $display(\"Parsing not finished.\");\n");
-    fprintf(output_file, "        end\n");
-    fprintf(output_file, "        $finish;\n");
-    fprintf(output_file, "    end\n\n");
-    fprintf(output_file, "endmodule\n");
+// Legacy testbench: one send_char() statement per character, with proper escaping
+static void emit_send_char(OutputBuffer *out, char ch) {
+    if (ch == '\n') {
+        out_puts(out, "        send_char(\"\\n\");\n");
+    } 
+    else if (ch == '\t') {
+        out_puts(out, "        send_char(\"\\t\");\n");
+    }
+    else if (ch == ' ') {
+        out_puts(out, "        send_char(\" \");\n");
+    }
+    else if (isprint(ch)) {
+        char line[] = "        send_char(\"?\");\n";
+        line[19] = ch;
+        out_write(out, line, sizeof(line) - 1);
+    }
+    else {
+        out_puts(out, "        send_char(");
+        out_int(out, (int)ch);
+        out_puts(out, ");\n");
+    }
+}
+
+// Stimulus file: one hex byte per line, for $readmemh in if_else_parser_tb.v
+static void emit_hex(OutputBuffer *out, char ch) {
+    static const char hex[] = "0123456789abcdef";
+    char line[3];
+
+    line[0] = hex[(unsigned char)ch >> 4];
+    line[1] = hex[(unsigned char)ch & 0xf];
+    line[2] = '\n';
+    out_write(out, line, sizeof(line));
+}
+
+void generate_testbench(const char *input_filename, const char *output_filename, int x_value) {
+    // Open input file
+    FILE *input_file = fopen(input_filename, "r");
+    if (!input_file) {
+        perror("Failed to open input file");
+        return;
+    }
+
+    // Open output file
+    FILE *output_file = fopen(output_filename, "w");
+    if (!output_file) {
+        perror("Failed to open output file");
+        fclose(input_file);
+        return;
+    }
+
+    OutputBuffer *out;
+    InputWindow *in;
+    if (!open_buffers(&out, &in, output_file, input_file)) {
+        fclose(input_file);
+        fclose(output_file);
+        return;
+    }
+
+    // Write testbench header
+    out_puts(out, "module if_else_parser_tb();\n\n");
+    out_puts(out, "    reg clk, rst;\n");
+    out_puts(out, "    reg signed [31:0] x;\n");
+    out_puts(out, "    reg [6:0] ascii_char;\n");
+    out_puts(out, "    reg char_valid;\n");
+    out_puts(out, "    wire signed [31:0] p;\n");
+    out_puts(out, "    wire [16*7-1:0] assignment_var;\n");
+    out_puts(out, "    wire [3:0] assignment_var_length;\n");
+    out_puts(out, "    wire parsing_done;\n");
+    out_puts(out, "    wire error_flag;\n");
+    out_puts(out, "    wire [3:0] error_code;\n\n");
+    
+    out_puts(out, "    // Error codes\n");
+    out_puts(out, "    parameter NO_ERROR          = 4'd0,\n");
+    out_puts(out, "              INVALID_KEYWORD   = 4'd1,\n");
+    out_puts(out, "              VAR_MISMATCH      = 4'd2,\n");
+    out_puts(out, "              INVALID_CHAR      = 4'd3,\n");
+    out_puts(out, "              MISSING_SEMICOLON = 4'd4,\n");
+    out_puts(out, "              MISSING_OPERATOR  = 4'd5,\n");
+    out_puts(out, "              SYNTAX_ERROR      = 4'd6,\n");
+    out_puts(out, "              PAREN_MISMATCH    = 4'd7;\n\n");
+    
+    out_puts(out, "    // Instantiate the parser\n");
+    out_puts(out, "    if_else_parser_2 uut (\n");
+    out_puts(out, "        .clk(clk),\n");
+    out_puts(out, "        .rst(rst),\n");
+    out_puts(out, "        .x(x),\n");
+    out_puts(out, "        .ascii_char(ascii_char),\n");
+    out_puts(out, "        .char_valid(char_valid),\n");
+    out_puts(out, "        .p(p),\n");
+    out_puts(out, "        .assignment_var(assignment_var),\n");
+    out_puts(out, "        .assignment_var_length(assignment_var_length),\n");
+    out_puts(out, "        .parsing_done(parsing_done),\n");
+    out_puts(out, "        .error_flag(error_flag),\n");
+    out_puts(out, "        .error_code(error_code)\n");
+    out_puts(out, "    );\n\n");
+    out_puts(out, "    // Generate a clock: 10 ns period\n");
+    out_puts(out, "    always #5 clk = ~clk;\n\n");
+    out_puts(out, "    // Task to send a character for one cycle.\n");
+    out_puts(out, "    task send_char(input [6:0] ch);\n");
+    out_puts(out, "    begin\n");
+    out_puts(out, "        ascii_char = ch;\n");
+    out_puts(out, "        char_valid = 1;\n");
+    out_puts(out, "        #5;\n");
+    out_puts(out, "        #5; // full clock cycle complete\n");
+    out_puts(out, "        char_valid = 0;\n");
+    out_puts(out, "    end\n");
+    out_puts(out, "    endtask\n\n");
+
+    // write the extract_var_name function
+    out_puts(out, "    // Helper function to extract variable name from packed format\n");
+    out_puts(out, "    function [8*16:1] extract_var_name;\n");
+    out_puts(out, "        input [16*7-1:0] packed_var;\n");
+    out_puts(out, "        input [3:0] length;\n");
+    out_puts(out, "        reg [6:0] char;\n");
+    out_puts(out, "        integer i;\n");
+    out_puts(out, "    begin\n");
+    out_puts(out, "        extract_var_name = 0;\n");
+    out_puts(out, "        for (i = 0; i < length; i = i + 1) begin\n");
+    out_puts(out, "            char = (packed_var >> (i*7)) & 7'h7F;\n");
+    out_puts(out, "            extract_var_name[8*(length-i) -: 8] = char;\n");
+    out_puts(out, "        end\n");
+    out_puts(out, "    end\n");
+    out_puts(out, "    endfunction\n\n");
+
+    // Write the initial test setup
+    out_puts(out, "    // Test stimulus: sending the code from input.v\n");
+    out_puts(out, "    initial begin\n");
+    out_puts(out, "        clk = 0;\n");
+    out_puts(out, "        rst = 1;\n");
+
+    out_puts(out, "        // Set the input value that will be used when evaluating the condition\n");
+    out_puts(out, "        x = ");
+    out_int(out, x_value);
+    out_puts(out, ";\n");
+    
+    out_puts(out, "        char_valid = 0;\n");
+    out_puts(out, "        #20;\n");
+    out_puts(out, "        rst = 0;\n\n");
+
+    out_puts(out, "        // Send each character of the if-else code to the parser\n");
+    
+    // Send each character of the if-else block
+    emit_if_else(in, emit_send_char, out);
+
+    out_puts(out, "\n        // Wait for parsing to complete\n");
+    out_puts(out, "        wait(parsing_done || error_flag);\n");
+    out_puts(out, "        #20;\n\n");
+    out_puts(out, "        // Display results\n");
+    out_puts(out, "        if (parsing_done && !error_flag) begin\n");
+    out_puts(out, "            $display(\"Test passed! Value %d assigned to the variable: %s. (var length: %d)\", \n");
+    out_puts(out, "                    p, extract_var_name(assignment_var, assignment_var_length),\n");
+    out_puts(out, "                    assignment_var_length);\n");
+    out_puts(out, "        end\n");
+    out_puts(out, "        else if (error_flag) begin\n");
+    out_puts(out, "            $display(\"Error: %s (%0d)\", \n");
+    out_puts(out, "                    error_code == 0 ? \"No Error\" :\n");
+    out_puts(out, "                    error_code == 1 ? \"Invalid Keyword. One of more of the keywords 'begin', 'end', 'if', 'else' are missing or misspelled.\" :\n");
+    out_puts(out, "                    error_code == 2 ? \"Variable Mismatch. The variable names in the true and false branch assignments do not match.\" :\n");
+    out_puts(out, "                    error_code == 3 ? \"Invalid Character. You may have entered a character that is not allowed.\" :\n");
+    out_puts(out, "                    error_code == 4 ? \"Missing Semicolon\" :\n");
+    out_puts(out, "                    error_code == 5 ? \"Missing Operator\" :\n");
+    out_puts(out, "                    error_code == 6 ? \"There seems to be a Syntax Error, incorrect use of parantheses, or use of illegal characters.\" :\n");
+    out_puts(out, "                    error_code == 7 ? \"Parenthesis Mismatch. You may have mismatched parentheses, or parantheses at invalid places.\" : \"Unknown Error\",\n");
+    out_puts(out, "                    error_code);\n");
+    out_puts(out, "        end\n");
+    out_puts(out, "        else begin\n");
+    out_puts(out, "            $display(\"Parsing not finished.\");\n");
+    out_puts(out, "        end\n");
+    out_puts(out, "        $finish;\n");
+    out_puts(out, "    end\n\n");
+    out_puts(out, "endmodule\n");
 
     // Clean up, baby
-    free(input_buffer);
+    out_flush(out);
+    free(out);
+    free(in);
     fclose(input_file);
     fclose(output_file);
     
     printf("Testbench generated successfully. The verilog parser will evaluate your input based on the value you've provided (x = %d), and will do the necessary assignment.\n", x_value);
-    printf("To compile the verilog parser and testbench, do: iverilog -o parser_gen if_else_parser_2.v if_else_parser_tb_gen.v\n");
+    printf("To compile the verilog parser and testbench, do: iverilog -o parser_gen if_else_parser_2.v %s\n", output_filename);
     printf("To run the parser, do: vvp .\\parser_gen\n");
 }
 
-int main() {
-    int x_value;
-    printf("Enter the value to use for condition evaluation: ");
-    scanf("%d", &x_value);
-    generate_testbench("input.v", "if_else_parser_tb_gen.v", x_value);
+void generate_stimulus(const char *input_filename, const char *output_filename) {
+    // Open input file
+    FILE *input_file = fopen(input_filename, "r");
+    if (!input_file) {
+        perror("Failed to open input file");
+        return;
+    }
+
+    // Open output file
+    FILE *output_file = fopen(output_filename, "w");
+    if (!output_file) {
+        perror("Failed to open output file");
+        fclose(input_file);
+        return;
+    }
+
+    OutputBuffer *out;
+    InputWindow *in;
+    if (!open_buffers(&out, &in, output_file, input_file)) {
+        fclose(input_file);
+        fclose(output_file);
+        return;
+    }
+
+    // The testbench stops at the 00 terminator
+    out_puts(out, "// if-else stimulus generated from ");
+    out_puts(out, input_filename);
+    out_puts(out, "\n");
+    emit_if_else(in, emit_hex, out);
+    out_puts(out, "00\n");
+
+    out_flush(out);
+    free(out);
+    free(in);
+    fclose(input_file);
+    fclose(output_file);
+
+    printf("Stimulus written to %s.\n", output_filename);
+    printf("Compile the verilog parser and the testbench once: iverilog -o parser_tb if_else_parser_2.v if_else_parser_tb.v\n");
+    printf("Then run it for any x value: vvp parser_tb +x=<value> +stim=%s\n", output_filename);
+}
+
+int main(int argc, char *argv[]) {
+    // -tb generates the old per-input testbench, with the input and x built in
+    int legacy_tb = argc > 1 && strcmp(argv[1], "-tb") == 0;
+    int arg = legacy_tb ? 2 : 1;
+
+    // Optional arguments: input file and generated stimulus (or testbench) file
+    const char *input_filename = argc > arg ? argv[arg] : "input.v";
+    const char *output_filename = argc > arg + 1 ? argv[arg + 1] :
+                                  legacy_tb ? "if_else_parser_tb_gen.v" : "stimulus.hex";
+
+    if (legacy_tb) {
+        int x_value;
+        printf("Enter the value to use for condition evaluation: ");
+        scanf("%d", &x_value);
+        generate_testbench(input_filename, output_filename, x_value);
+    }
+    else {
+        generate_stimulus(input_filename, output_filename);
+    }
     return 0;
 }
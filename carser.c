@@ -2,1239 +2,1604 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include <ctype.h>
-
-// Error codes
-#define NO_ERROR 0
-#define INVALID_KEYWORD 1
-#define VAR_MISMATCH 2
-#define INVALID_CHAR 3
-#define MISSING_SEMICOLON 4
-#define MISSING_OPERATOR 5
-#define SYNTAX_ERROR 6
-
-// State encoding (matching the Verilog implementation)
-#define IDLE 0
-#define READ_IF 1 // Read "if" keyword
-#define READ_OPEN_PAREN 2
-#define READ_VAR 3
-#define READ_COND_OPERATOR 4  // Read first char of comparator
-#define READ_COND_OPERATOR2 5 // Read second char of comparator (if any)
-#define READ_VALC 6
-#define READ_CLOSE_PAREN 7
-#define READ_BEGIN 8                 // Read "begin" keyword
-#define READ_ASSIGNMENT_VAR 9        // Read variable for assignment
-#define READ_ASSIGNMENT_OPERATOR 10  // Read assignment operator (<= or =)
-#define READ_CONST1 11               // Read constant for true branch
-#define READ_SEMICOLON1 12           // Expect ; after const1
-#define READ_END1 13                 // Read "end" keyword for true branch
-#define READ_ELSE 14                 // Expect "else" keyword
-#define READ_BEGIN2 16               // Read "begin" for false branch
-#define READ_ASSIGNMENT_VAR2 18      // Read variable for false branch
-#define READ_ASSIGNMENT_OPERATOR2 19 // Read assignment operator for false branch
-#define READ_CONST2 20               // Read constant for false branch
-#define READ_SEMICOLON2 21           // Expect ; after const2
-#define READ_END2 22                 // Read "end" keyword for false branch
-#define EVALUATE 23
-
-// Comparator types
-#define EQ 0
-#define NE 1
-#define LT 2
-#define GT 3
-#define LE 4
-#define GE 5
+#include <pthread.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/inotify.h>
+
+#include "carser.h"
+
+// Batch evaluation
+//
+// The x values are parsed from large reads, evaluated BATCH_CHUNK at a time with
+// evaluate_batch and written back through one formatting buffer per chunk.
+#define BATCH_CHUNK 4096        // x values evaluated per kernel call
+#define BATCH_READ_SIZE 65536   // bytes read from the x stream at a time
+
+// Write the decimal form of value into dst, returns the number of chars written
+static int format_int(char *dst, int value)
+{
+    char tmp[12];
+    int len = 0;
+    int out_len = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
 
-typedef struct
+    do
+    {
+        tmp[len++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (value < 0)
+        dst[out_len++] = '-';
+    while (len > 0)
+        dst[out_len++] = tmp[--len];
+
+    return out_len;
+}
+
+// Evaluate the buffered x values and write the assigned values, one per line. A block that
+// assigns several variables writes all of them on the line, in the order of its first branch;
+// a nested one is evaluated into values first.
+static void flush_batch(const BlockResult *block, const int *xs, int *ps, int *values, size_t count, char *write_buf,
+                        FILE *out)
 {
-    int state;
+    size_t len = 0;
 
-    // Keyword parsing
-    char keyword_buffer[32];
-    int keyword_index;
-    bool keyword_complete;
+    if (block->branches != NULL || values != NULL)
+    {
+        size_t pair_count = block_assignment_count(block);
 
-    char cond_var[16];
-    int cond_var_length;
-    int cond_var_idx;
+        for (size_t k = 0; k < count; k++)
+        {
+            const Assignment *pairs = NULL;
 
-    char assignment_var[16];
-    int assignment_var_length;
+            if (values != NULL)
+                ast_evaluate(block->ast, xs[k], values);
+            else
+                pairs = block->branches->pairs + block_branch(block, xs[k]) * pair_count;
 
-    char assignment_var2[16];
-    int assignment_var2_length;
-    int assignment_var2_idx;
+            for (size_t i = 0; i < pair_count; i++)
+            {
+                if (len + 12 > BATCH_CHUNK * 12)
+                {
+                    fwrite(write_buf, 1, len, out);
+                    len = 0;
+                }
+                len += format_int(write_buf + len, pairs != NULL ? pairs[i].value : values[i]);
+                write_buf[len++] = i + 1 < pair_count ? ' ' : '\n';
+            }
+        }
+        fwrite(write_buf, 1, len, out);
+        return;
+    }
 
-    bool var_match;
-    bool reading_var;
+    evaluate_batch(block, xs, ps, count);
+    for (size_t k = 0; k < count; k++)
+    {
+        len += format_int(write_buf + len, ps[k]);
+        write_buf[len++] = '\n';
+    }
+    fwrite(write_buf, 1, len, out);
+}
 
-    // Data registers
-    int x;    // Input value
-    int valC; // Comparison value
-    bool is_valC_negative;
-    int const1; 
-    bool is_const1_negative;
-    int const2; 
-    bool is_const2_negative;
-    int num_buffer;
-    bool parsing_number;
+// Evaluate the parsed rule against every x value in the input stream and write one
+// assigned value per line to the output stream. values has room for the variables of a
+// nested block that assigns several, NULL otherwise. Returns 0 on success.
+int run_batch(const BlockResult *block, int *values, FILE *in, FILE *out)
+{
+    static char read_buf[BATCH_READ_SIZE];
+    static char write_buf[BATCH_CHUNK * 12];
+    static int xs[BATCH_CHUNK];
+    static int ps[BATCH_CHUNK];
+
+    size_t count = 0;
+    long long num = 0;
+    bool negative = false;
+    bool in_number = false;
+    size_t nread;
+
+    do
+    {
+        nread = fread(read_buf, 1, sizeof(read_buf), in);
 
-    int paren_count;
+        // On the last (short) read an extra separator is processed so the final value is kept
+        size_t limit = nread < sizeof(read_buf) ? nread + 1 : nread;
 
-    bool blocking_assignment1;
-    bool blocking_assignment2;
+        for (size_t i = 0; i < limit; i++)
+        {
+            char ch = i < nread ? read_buf[i] : '\n';
 
-    int comparator;
-    char op_first;
+            if (ch >= '0' && ch <= '9')
+            {
+                num = num * 10 + (ch - '0');
+                if (num > 2147483648LL)
+                {
+                    fprintf(stderr, "Error: x value out of range in batch input\n");
+                    return 1;
+                }
+                in_number = true;
+            }
+            else if (ch == '-' && !in_number && !negative)
+            {
+                negative = true;
+            }
+            else if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == ',')
+            {
+                if (negative && !in_number)
+                {
+                    fprintf(stderr, "Error: stray '-' in batch input\n");
+                    return 1;
+                }
+                if (in_number)
+                {
+                    if (!negative && num > 2147483647LL)
+                    {
+                        fprintf(stderr, "Error: x value out of range in batch input\n");
+                        return 1;
+                    }
+                    xs[count++] = (int)(negative ? -num : num);
+                    num = 0;
+                    negative = false;
+                    in_number = false;
+
+                    if (count == BATCH_CHUNK)
+                    {
+                        flush_batch(block, xs, ps, values, count, write_buf, out);
+                        count = 0;
+                    }
+                }
+            }
+            else
+            {
+                fprintf(stderr, "Error: invalid character '%c' in batch input\n", ch);
+                return 1;
+            }
+        }
+    } while (nread == sizeof(read_buf));
 
-    // Result value
-    int p;
+    if (count > 0)
+        flush_batch(block, xs, ps, values, count, write_buf, out);
 
-    // Status flags
-    bool parsing_done;
-    bool error_flag;
-    int error_code;
+    return ferror(in) ? 1 : 0;
+}
 
-    // for debugging
-    bool debug_mode;
-} Parser;
+// Input layer
+//
+// Regular files are memory-mapped and fed to the parser straight from the mapping.
+// Pipes, terminals and other non-mappable inputs are read in large chunks.
+#define INPUT_CHUNK_SIZE (1 << 20)
 
-void parser_init(Parser *parser)
+// Input bytes currently in memory: the whole mapping, or the chunk just read
+typedef struct
+{
+    const char *data;
+    size_t offset; // Input offset of data[0]
+    size_t len;
+} InputChunk;
+
+// Called with every block polled from the parser in streaming mode, together with the chunk
+// the block ended in. In the read path it is also called with block == NULL just before a
+// chunk is dropped, the last chance to look at its bytes.
+typedef void (*BlockCallback)(void *ctx, const BlockResult *block, const InputChunk *chunk);
+
+// Hand every queued block to on_block
+static void drain_blocks(Parser *parser, const InputChunk *chunk, BlockCallback on_block, void *ctx)
 {
-    parser->state = IDLE;
-    parser->keyword_index = 0;
-    parser->keyword_complete = false;
-
-    parser->cond_var_length = 0;
-    parser->cond_var_idx = 0;
-    parser->assignment_var_length = 0;
-    parser->assignment_var2_length = 0;
-    parser->assignment_var2_idx = 0;
-    parser->var_match = false;
-    parser->reading_var = false;
-
-    parser->x = 0;
-    parser->valC = 0;
-    parser->is_valC_negative = false;
-    parser->const1 = 0;
-    parser->is_const1_negative = false;
-    parser->const2 = 0;
-    parser->is_const2_negative = false;
-    parser->num_buffer = 0;
-    parser->parsing_number = false;
-
-    parser->paren_count = 0;
-
-    parser->blocking_assignment1 = false;
-    parser->blocking_assignment2 = false;
-
-    parser->comparator = 0;
-    parser->op_first = 0;
-
-    parser->p = 0;
-    parser->parsing_done = false;
-    parser->error_flag = false;
-    parser->error_code = NO_ERROR;
-
-    memset(parser->cond_var, 0, sizeof(parser->cond_var));
-    memset(parser->assignment_var, 0, sizeof(parser->assignment_var));
-    memset(parser->assignment_var2, 0, sizeof(parser->assignment_var2));
-
-    parser->debug_mode = false;
+    BlockResult block;
+
+    while (parser_poll(parser, &block))
+        on_block(ctx, &block, chunk);
 }
 
-// Function to check if variable names match
-bool var_names_match(Parser *parser)
+// Feed one chunk. With on_block == NULL only the first block is parsed, otherwise every
+// block is fed through parser_feed and passed on. Returns false once there is nothing
+// more to parse.
+static bool parse_chunk(Parser *parser, const InputChunk *chunk, BlockCallback on_block, void *ctx)
 {
-    if (parser->assignment_var_length != parser->assignment_var2_length)
+    if (on_block == NULL)
     {
-        return false;
+        parse_buffer(parser, chunk->data, chunk->len);
+        return !parser->parsing_done && !parser->error_flag;
     }
 
-    // Compare each character
-    for (int i = 0; i < parser->assignment_var_length; i++)
+    size_t used = parser_feed(parser, chunk->data, chunk->len);
+    drain_blocks(parser, chunk, on_block, ctx);
+    return used == chunk->len;
+}
+
+// End of the input. A block that ends with it is completed; in streaming mode a block cut
+// off by it is queued, and the queue is passed on.
+static void finish_input(Parser *parser, const InputChunk *chunk, BlockCallback on_block, void *ctx)
+{
+    if (on_block == NULL)
     {
-        if (parser->assignment_var[i] != parser->assignment_var2[i])
+        parse_buffer_end(parser);
+        return;
+    }
+
+    parser_finish(parser);
+    drain_blocks(parser, chunk, on_block, ctx);
+}
+
+// Parse everything readable from fd, see parse_chunk for on_block. Returns false on a read error.
+bool parse_fd(Parser *parser, int fd, BlockCallback on_block, void *ctx)
+{
+    struct stat st;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        size_t size = (size_t)st.st_size;
+        void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED)
         {
-            return false; 
+            InputChunk chunk = {(const char *)map, 0, size};
+
+            madvise(map, size, MADV_SEQUENTIAL);
+            if (parse_chunk(parser, &chunk, on_block, ctx))
+                finish_input(parser, &chunk, on_block, ctx);
+            munmap(map, size);
+            return true;
         }
+        // Fall through to the read path if the file cannot be mapped
     }
 
-    return true; 
+    char *buffer = malloc(INPUT_CHUNK_SIZE);
+    if (buffer == NULL)
+        return false;
+
+    bool ok = true;
+    bool more = true;
+    InputChunk chunk = {buffer, 0, 0};
+    while (more)
+    {
+        ssize_t nread = read(fd, buffer, INPUT_CHUNK_SIZE);
+
+        if (nread < 0 && errno == EINTR)
+            continue;
+        if (nread <= 0)
+        {
+            ok = nread == 0;
+            if (ok)
+                finish_input(parser, &chunk, on_block, ctx);
+            break;
+        }
+
+        chunk.len = (size_t)nread;
+        more = parse_chunk(parser, &chunk, on_block, ctx);
+
+        // The next read reuses the buffer
+        if (on_block != NULL)
+            on_block(ctx, NULL, &chunk);
+        chunk.offset += chunk.len;
+        chunk.len = 0;
+    }
+
+    free(buffer);
+    return ok;
 }
 
-void debug_print(Parser *parser, char ascii_char)
+// Parse one file ("-" for stdin). Without on_block parsing stops at the end of the first
+// if-else block or at the first error, with it every block is streamed to on_block.
+// Returns false if the file could not be opened or read.
+bool parse_file(Parser *parser, const char *path, BlockCallback on_block, void *ctx)
 {
-    if (!parser->debug_mode)
-        return;
+    if (strcmp(path, "-") == 0)
+        return parse_fd(parser, STDIN_FILENO, on_block, ctx);
 
-    printf("State: %2d, curr_char: %c (0x%02x), parsing_number: %d\n",
-           parser->state, ascii_char, ascii_char, parser->parsing_number);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
 
-    printf("cond_var: %s", parser->cond_var);
-    for (int i = strlen(parser->cond_var); i < 16; i++)
-        printf(" ");
+    bool ok = parse_fd(parser, fd, on_block, ctx);
+    close(fd);
+    return ok;
+}
+
+// Multi-file processing
+//
+// Every input file is one job. Jobs are split into contiguous runs, one run per worker.
+// A worker takes jobs from the front of its own run and, once that is empty, steals from
+// the back of another worker's run, so a few large files don't leave the other workers idle.
+// Each worker owns its own Parser, and results are printed in input order. A worker formats
+// its own result lines: the names come from its symbol table, which the next job may grow
+// while the main thread is still printing.
+typedef struct
+{
+    const char *path;
+    BlockResult result;
+    char *output;       // The printed result, NULL if it could not be formatted
+    size_t output_len;
+    bool open_failed;
+    bool done;
+} FileJob;
 
-    printf(", assignment_var: %s", parser->assignment_var);
-    for (int i = strlen(parser->assignment_var); i < 16; i++)
-        printf(" ");
+typedef struct
+{
+    pthread_mutex_t lock;
+    size_t head; // next job the owner takes
+    size_t tail; // one past the last job, thieves take from here
+} WorkQueue;
+
+typedef struct
+{
+    FileJob *jobs;
+    WorkQueue *queues;
+    Parser *parsers; // One per worker, they own the names in the job results
+    int num_workers;
+    bool debug_mode;
+    int engine;
 
-    printf(", assignment_var2: %s", parser->assignment_var2);
-    for (int i = strlen(parser->assignment_var2); i < 16; i++)
-        printf(" ");
+    pthread_mutex_t done_lock;
+    pthread_cond_t done_cond;
+} WorkPool;
 
-    printf(", paren_count: %d\n", parser->paren_count);
-    printf("valC: %11d, const1: %11d, const2: %11d, error_code: %2d\n",
-           parser->valC, parser->const1, parser->const2, parser->error_code);
-    printf("---------------------------------------------------------------------------------------------------------------------------------------------\n\n");
+typedef struct
+{
+    WorkPool *pool;
+    int id;
+    bool started;      // pthread_create succeeded, the thread has to be joined
+} Worker;
+
+typedef struct
+{
+    char **paths;
+    size_t count;
+    size_t capacity;
+} PathList;
+
+static long queue_take_front(WorkQueue *queue)
+{
+    long job = -1;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail)
+        job = (long)queue->head++;
+    pthread_mutex_unlock(&queue->lock);
+
+    return job;
 }
 
-void process_char(Parser *parser, char ascii_char)
+static long queue_steal_back(WorkQueue *queue)
 {
-    debug_print(parser, ascii_char);
+    long job = -1;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail)
+        job = (long)--queue->tail;
+    pthread_mutex_unlock(&queue->lock);
 
-    bool is_digit = isdigit(ascii_char);
-    bool is_letter = isalpha(ascii_char);
-    bool is_underscore = (ascii_char == '_');
-    bool is_id_start = is_letter;
-    bool is_id_char = is_letter || is_digit || is_underscore;
-    bool is_whitespace = (ascii_char == ' ' || ascii_char == '\t' || ascii_char == '\n' || ascii_char == '\r');
+    return job;
+}
+
+// Print the assignments of a branch, "a = 1;" or "begin a = 1; b = 2; end"
+static void print_branch(FILE *out, const BlockResult *result, size_t branch)
+{
+    Assignment single;
+    const Assignment *pairs = &single;
+    size_t count = 1;
 
-    switch (parser->state)
+    if (result->branches != NULL)
     {
-    case IDLE:
-        if (is_whitespace)
-        {
-            parser->state = IDLE;
-        }
-        else if (ascii_char == 'i')
-        {
-            parser->keyword_index = 1;
-            parser->state = READ_IF;
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
-        }
-        break;
+        count = result->branches->count;
+        pairs = result->branches->pairs + branch * count;
+    }
+    else
+    {
+        branch_assignments(result, branch, &single);
+    }
 
-    case READ_IF:
-        if (ascii_char == 'f')
-        {
-            parser->keyword_index = 0;
-            parser->state = READ_OPEN_PAREN;
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
-        }
-        break;
+    fputs(count > 1 ? "begin " : "", out);
+    for (size_t i = 0; i < count; i++)
+        fprintf(out, "%s%s = %d;", i > 0 ? " " : "", symbol_name(result->symbols, pairs[i].var_id), pairs[i].value);
+    fputs(count > 1 ? " end" : "", out);
+}
 
-    case READ_OPEN_PAREN:
-        if (is_whitespace)
-        {
-            parser->state = READ_OPEN_PAREN;
-        }
-        else if (ascii_char == '(')
-        {
-            parser->paren_count++;
-            parser->state = READ_VAR;
-            parser->cond_var_idx = 0;
-            parser->cond_var_length = 0;
-            parser->reading_var = false;
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-        }
-        break;
+// First term of the operand tree that ends with term i of a compound condition
+static size_t cond_term_start(const CondTerm *terms, size_t i)
+{
+    size_t open = 1;
 
-    case READ_VAR:
-        if (is_whitespace && !parser->reading_var)
-        {
-            parser->state = READ_VAR;
-        }
-        else if (!parser->reading_var && is_id_start)
-        {
-            // First character of identifier - must be a letter
-            parser->cond_var[0] = ascii_char; // Start at index 0
-            parser->cond_var_idx = 1;
-            parser->cond_var_length = 1;
-            parser->reading_var = true;
-        }
-        else if (parser->reading_var && is_id_char)
-        {
-            // Subsequent characters - can be letter, digit, or underscore
-            if (parser->cond_var_idx < 15)
-            { // Prevent buffer overflow
-                parser->cond_var[parser->cond_var_idx] = ascii_char;
-                parser->cond_var_idx++;
-                parser->cond_var_length++;
-            }
+    for (;;)
+    {
+        open += terms[i].kind == COND_COMPARE ? 0 : terms[i].kind == COND_NOT ? 1 : 2;
+        if (--open == 0)
+            return i;
+        i--;
+    }
+}
 
-            if (parser->cond_var_idx == 15)
-            { // Max length reached
-                parser->state = READ_COND_OPERATOR;
-                parser->reading_var = false;
-                parser->cond_var[15] = '\0'; // Null-terminate
-            }
-        }
-        else if (parser->reading_var && (is_whitespace || ascii_char == '>' || ascii_char == '<' ||
-                                         ascii_char == '=' || ascii_char == '!'))
-        {
-            // Variable name complete, ready for operator
-            parser->cond_var[parser->cond_var_length] = '\0'; // Null-terminate
-            parser->state = READ_COND_OPERATOR;
-            parser->reading_var = false;
+// Print the operand tree that ends with term i, in parentheses where precedence needs them.
+// prec is that of the operator it is an operand of, right if it is its right operand.
+static void print_cond_terms(FILE *out, const BlockResult *result, const CondTerm *terms, size_t i, int prec,
+                             bool right)
+{
+    const CondTerm *term = &terms[i];
 
-            // Process operator right away if not whitespace
-            if (!is_whitespace)
-            {
-                if (parser->paren_count == 0)
-                {
-                    parser->error_flag = true;
-                    parser->error_code = SYNTAX_ERROR;
-                }
-                parser->op_first = ascii_char;
-                parser->state = READ_COND_OPERATOR2;
-            }
-        }
-        else if (ascii_char == '(')
-        {
-            // Opening nested parenthesis
-            parser->paren_count++;
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-        }
-        break;
+    if (term->kind == COND_COMPARE)
+    {
+        fprintf(out, "%s %s %d", symbol_name(result->symbols, term->var_id), comparator_str(term->comparator),
+            term->value);
+    }
+    else if (term->kind == COND_NOT)
+    {
+        fprintf(out, "!(");
+        print_cond_terms(out, result, terms, i - 1, 0, false);
+        fprintf(out, ")");
+    }
+    else
+    {
+        int own = term->kind == COND_AND ? 2 : 1;
+        bool parens = own < prec || (own == prec && right);
+
+        fputs(parens ? "(" : "", out);
+        print_cond_terms(out, result, terms, cond_term_start(terms, i - 1) - 1, own, false);
+        fputs(term->kind == COND_AND ? " && " : " || ", out);
+        print_cond_terms(out, result, terms, i - 1, own, true);
+        fputs(parens ? ")" : "", out);
+    }
+}
 
-    case READ_COND_OPERATOR:
-        if (is_whitespace)
+// Print the condition of an AST_IF, without the parentheses of the if
+static void print_condition(FILE *out, const BlockResult *result, const AstNode *node)
+{
+    const Condition *cond;
+
+    if (node->comparator != COMPOUND)
+    {
+        fprintf(out, "%s %s %d", symbol_name(result->symbols, node->var_id), comparator_str(node->comparator),
+            node->value);
+        return;
+    }
+    cond = ast_condition(result->ast, node);
+    print_cond_terms(out, result, condition_terms(cond), cond->term_count - 1, 0, false);
+}
+
+// Print the statements of nodes [from, to) of a nested block, every branch in begin ... end
+static void print_ast(FILE *out, const BlockResult *result, size_t from, size_t to)
+{
+    const AstNode *nodes = result->ast->nodes;
+
+    for (size_t i = from; i < to; i = nodes[i].end)
+    {
+        fputs(i > from ? " " : "", out);
+        if (nodes[i].kind == AST_ASSIGN)
         {
-            parser->state = READ_COND_OPERATOR;
+            fprintf(out, "%s = %d;", symbol_name(result->symbols, nodes[i].var_id), nodes[i].value);
+            continue;
         }
-        else if (ascii_char == ')')
-        {
-            if (parser->paren_count == 0)
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            parser->paren_count--;
-        }
-        else if (ascii_char == '<' || ascii_char == '>' || ascii_char == '=' || ascii_char == '!')
+
+        // An else branch that is a single if-else of the same extent is the next arm
+        for (size_t arm = i; ; arm = nodes[arm].jump)
         {
-            if (parser->paren_count == 0)
+            const AstNode *node = &nodes[arm];
+
+            fprintf(out, "%sif (", arm > i ? " else " : "");
+            print_condition(out, result, node);
+            fprintf(out, ") begin ");
+            print_ast(out, result, arm + 1, node->jump);
+            fprintf(out, " end");
+            if (nodes[node->jump].kind != AST_IF || nodes[node->jump].end != node->end)
             {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
+                fprintf(out, " else begin ");
+                print_ast(out, result, node->jump, node->end);
+                fprintf(out, " end");
+                break;
             }
-            parser->op_first = ascii_char;
-            parser->state = READ_COND_OPERATOR2;
         }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = INVALID_CHAR;
-        }
-        break;
+    }
+}
 
-    case READ_COND_OPERATOR2:
-        // Handle whitespace first
-        if (is_whitespace)
-        {
-            // Just stay in the same state
-            break;
-        }
-        // Check if there's a negative sign ("-") before the digit
-        else if (ascii_char == '-')
-        {
-            parser->is_valC_negative = true;
-        }
+// Print a parsed block on one line, every arm of a ladder in order
+static void print_rule(FILE *out, const char *label, const BlockResult *result)
+{
+    const Ladder *ladder = result->ladder;
+    size_t arm_count = ladder != NULL ? ladder->arm_count : 1;
 
-        switch (parser->op_first)
-        {
-        case '<':
-            if (ascii_char == '=')
-            {
-                parser->comparator = LE;
-                parser->state = READ_VALC;
-            }
-            else if (is_digit)
-            {
-                parser->comparator = LT; // single-character "<"
-                // Start processing the digit immediately
-                parser->num_buffer = (parser->num_buffer * 10) + (ascii_char - '0');
-                parser->parsing_number = true;
-                parser->state = READ_VALC;
-            }
-            else if (ascii_char == '(')
-            {
-                parser->comparator = LT;
-                parser->paren_count++;
-                parser->state = READ_VALC;
-            }
-            else if (!is_whitespace) 
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            break;
+    fprintf(out, "%s: ", label);
+    if (result->ast != NULL)
+    {
+        print_ast(out, result, 0, result->ast->node_count);
+        fprintf(out, "\n");
+        return;
+    }
+    for (size_t a = 0; a < arm_count; a++)
+    {
+        int cond_var_id = ladder != NULL ? ladder->arms[a].cond_var_id : result->cond_var_id;
+        int comparator = ladder != NULL ? ladder->arms[a].comparator : result->comparator;
+        int valC = ladder != NULL ? ladder->arms[a].valC : result->valC;
+
+        fprintf(out, "%sif (%s %s %d) ", a > 0 ? "else " : "", symbol_name(result->symbols, cond_var_id),
+            comparator_str(comparator), valC);
+        print_branch(out, result, a);
+        fprintf(out, " ");
+    }
+    fprintf(out, "else ");
+    print_branch(out, result, arm_count);
+    fprintf(out, "\n");
+}
 
-        case '>':
-            if (ascii_char == '=')
-            {
-                parser->comparator = GE;
-                parser->state = READ_VALC;
-            }
-            else if (is_digit)
-            {
-                parser->comparator = GT; // single-character ">"
-                // Start processing the digit immediately
-                parser->num_buffer = (parser->num_buffer * 10) + (ascii_char - '0');
-                parser->parsing_number = true;
-                parser->state = READ_VALC;
-            }
-            else if (ascii_char == '(')
-            {
-                parser->comparator = GT;
-                parser->paren_count++;
-                parser->state = READ_VALC;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            break;
+// Print a one-line summary of a parsed block
+void print_result(FILE *out, const char *label, const BlockResult *result)
+{
+    if (result->error_flag)
+        fprintf(out, "%s: Error code %d: %s\n", label, result->error_code, error_message(result->error_code));
+    else if (result->parsing_done)
+        print_rule(out, label, result);
+    else
+        fprintf(out, "%s: Parsing incomplete\n", label);
+}
 
-        case '=':
-            if (ascii_char == '=')
-            {
-                parser->comparator = EQ;
-                parser->state = READ_VALC;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = MISSING_OPERATOR;
-            }
-            break;
+static void print_file_result(FILE *out, const FileJob *job)
+{
+    if (job->open_failed)
+        fprintf(out, "%s: Error: Could not read file\n", job->path);
+    else
+        print_result(out, job->path, &job->result);
+}
 
-        case '!':
-            if (ascii_char == '=')
-            {
-                parser->comparator = NE;
-                parser->state = READ_VALC;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = MISSING_OPERATOR;
-            }
-            break;
+// Print the result of a job into job->output, on the worker that parsed it
+static void format_file_result(FileJob *job)
+{
+    FILE *out = open_memstream(&job->output, &job->output_len);
 
-        default:
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-            break;
-        }
-        break;
+    if (out == NULL)
+    {
+        job->output = NULL;
+        return;
+    }
+    print_file_result(out, job);
+    if (fclose(out) != 0)
+    {
+        free(job->output);
+        job->output = NULL;
+    }
+}
 
-    case READ_VALC:
-        if (is_whitespace)
-        {
-            parser->state = READ_VALC;
-        }
-        // Check if there's a negative sign ("-") before the digit
-        else if (ascii_char == '-' && !parser->parsing_number)
-        {
-            parser->is_valC_negative = true;
-        }
-        else if (ascii_char == '(' && !parser->parsing_number)
-        {
-            parser->paren_count++;
-        }
-        else if (is_digit)
+static void *worker_main(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    WorkPool *pool = worker->pool;
+    Parser *parser = &pool->parsers[worker->id];
+
+    for (;;)
+    {
+        long job = queue_take_front(&pool->queues[worker->id]);
+
+        // Own run is empty, try to steal from the others. Jobs are never added once the
+        // pool is running, so when every run is empty the worker is done.
+        for (int i = 1; job < 0 && i < pool->num_workers; i++)
         {
-            parser->num_buffer = (parser->num_buffer * 10) + (ascii_char - '0');
-            parser->parsing_number = true;
+            job = queue_steal_back(&pool->queues[(worker->id + i) % pool->num_workers]);
         }
-        else if (parser->parsing_number)
-        {
-            if (parser->is_valC_negative)
-                parser->valC = -parser->num_buffer;
-            else
-                parser->valC = parser->num_buffer;
+        if (job < 0)
+            break;
 
-            parser->num_buffer = 0;
-            parser->parsing_number = false;
+        FileJob *file_job = &pool->jobs[job];
 
-            if (ascii_char == ')')
-            {
-                if (parser->paren_count == 0)
-                {
-                    parser->error_flag = true;
-                    parser->error_code = SYNTAX_ERROR;
-                }
-                parser->paren_count--;
-                parser->state = READ_CLOSE_PAREN;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-        }
-        break;
+        // Not parser_reset, the results of earlier jobs may not be printed yet and their
+        // Asts are in the parser's arena
+        parser_restart(parser, 0, 0);
+        file_job->open_failed = !parse_file(parser, file_job->path, NULL, NULL);
+        parser_block_result(parser, &file_job->result);
+        format_file_result(file_job);
 
-    case READ_CLOSE_PAREN:
-        if (is_whitespace)
-        {
-            parser->state = READ_CLOSE_PAREN;
-        }
-        else if (ascii_char == 'b')
-        {
-            parser->keyword_index = 1;
-            strcpy(parser->keyword_buffer, "b");
-            if (parser->paren_count != 0)
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            parser->state = READ_BEGIN;
-        }
-        else if (ascii_char == ')')
-        {
-            parser->paren_count--;
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
-        }
-        break;
+        pthread_mutex_lock(&pool->done_lock);
+        file_job->done = true;
+        pthread_cond_broadcast(&pool->done_cond);
+        pthread_mutex_unlock(&pool->done_lock);
+    }
 
-    case READ_BEGIN:
-        switch (parser->keyword_index)
-        {
-        case 1:
-            if (ascii_char == 'e')
-            {
-                strcat(parser->keyword_buffer, "e");
-                parser->keyword_index++;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+    return NULL;
+}
 
-        case 2:
-            if (ascii_char == 'g')
-            {
-                strcat(parser->keyword_buffer, "g");
-                parser->keyword_index++;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+// Parse every file in the list on num_workers threads. Returns the number of files that failed.
+int process_files(char **paths, size_t count, int num_workers, bool debug_mode, int engine, BlockCache *cache)
+{
+    WorkPool pool;
+    Worker *workers;
+    pthread_t *threads;
+    int started = 0;
+    int failures = 0;
+
+    if (num_workers < 1)
+        num_workers = 1;
+    if ((size_t)num_workers > count)
+        num_workers = count > 0 ? (int)count : 1;
+
+    pool.jobs = calloc(count > 0 ? count : 1, sizeof(FileJob));
+    pool.queues = calloc(num_workers, sizeof(WorkQueue));
+    pool.parsers = calloc(num_workers, sizeof(Parser));
+    workers = calloc(num_workers, sizeof(Worker));
+    threads = calloc(num_workers, sizeof(pthread_t));
+    if (!pool.jobs || !pool.queues || !pool.parsers || !workers || !threads)
+    {
+        printf("Error: Memory allocation failed\n");
+        free(pool.jobs);
+        free(pool.queues);
+        free(pool.parsers);
+        free(workers);
+        free(threads);
+        return (int)count;
+    }
 
-        case 3:
-            if (ascii_char == 'i')
-            {
-                strcat(parser->keyword_buffer, "i");
-                parser->keyword_index++;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+    pool.num_workers = num_workers;
+    pool.debug_mode = debug_mode;
+    pool.engine = engine;
+    pthread_mutex_init(&pool.done_lock, NULL);
+    pthread_cond_init(&pool.done_cond, NULL);
 
-        case 4:
-            if (ascii_char == 'n')
-            {
-                parser->keyword_index = 0;
-                parser->state = READ_ASSIGNMENT_VAR;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+    for (size_t i = 0; i < count; i++)
+    {
+        pool.jobs[i].path = paths[i];
+    }
 
-        default:
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-            break;
-        }
-        break;
+    // Hand out contiguous runs of jobs so each worker starts in input order
+    for (int w = 0; w < num_workers; w++)
+    {
+        pthread_mutex_init(&pool.queues[w].lock, NULL);
+        pool.queues[w].head = count * w / num_workers;
+        pool.queues[w].tail = count * (w + 1) / num_workers;
+    }
 
-    case READ_ASSIGNMENT_VAR:
-        if (is_whitespace && !parser->reading_var)
-        {
-            parser->state = READ_ASSIGNMENT_VAR;
-        }
-        else if (!parser->reading_var && is_id_start)
-        {
-            // First character of identifier - must be a letter
-            parser->assignment_var[0] = ascii_char; // Start at index 0
-            parser->assignment_var_length = 1;
-            parser->cond_var_idx = 1; // Reuse this counter for tracking position
-            parser->reading_var = true;
-        }
-        else if (parser->reading_var && is_id_char)
-        {
-            // Subsequent characters - can be letter, digit, or underscore
-            if (parser->cond_var_idx < 15)
-            { 
-                parser->assignment_var[parser->cond_var_idx] = ascii_char;
-                parser->cond_var_idx++;
-                parser->assignment_var_length++;
-            }
+    for (int w = 0; w < num_workers; w++)
+    {
+        parser_init(&pool.parsers[w]);
+        pool.parsers[w].debug_mode = debug_mode;
+        pool.parsers[w].engine = engine;
+        pool.parsers[w].cache = cache;
+        workers[w].pool = &pool;
+        workers[w].id = w;
+        workers[w].started = pthread_create(&threads[w], NULL, worker_main, &workers[w]) == 0;
+        if (workers[w].started)
+            started++;
+    }
 
-            if (parser->cond_var_idx == 15)
-            { // Max length reached
-                parser->state = READ_ASSIGNMENT_OPERATOR;
-                parser->reading_var = false;
-                parser->assignment_var[15] = '\0'; // terminate with null char
-            }
-        }
-        else if (parser->reading_var && (is_whitespace || ascii_char == '=' || ascii_char == '<'))
-        {
-            // Variable name complete, ready for operator
-            parser->assignment_var[parser->assignment_var_length] = '\0'; 
-            parser->state = READ_ASSIGNMENT_OPERATOR;
-            parser->reading_var = false;
+    // Workers steal from every queue, so the ones that started take the jobs of the ones
+    // that did not. If none started, the main thread does all the work first.
+    if (started == 0)
+        worker_main(&workers[0]);
 
-            // Process operator rightaway if not whitespace
-            if (!is_whitespace)
-            {
-                if (ascii_char == '<')
-                {
-                    parser->blocking_assignment1 = false;
-                    parser->op_first = '<';
-                }
-                else if (ascii_char == '=')
-                {
-                    parser->blocking_assignment1 = true;
-                    parser->op_first = 0;
-                    parser->num_buffer = 0;
-                    parser->parsing_number = false;
-                    parser->is_const1_negative = false;
-                    parser->state = READ_CONST1;
-                }
-            }
-        }
-        else if (ascii_char == '(')
-        {
-            parser->paren_count++;
-        }
+    // Print results in input order as soon as each one is ready
+    for (size_t i = 0; i < count; i++)
+    {
+        pthread_mutex_lock(&pool.done_lock);
+        while (!pool.jobs[i].done)
+            pthread_cond_wait(&pool.done_cond, &pool.done_lock);
+        pthread_mutex_unlock(&pool.done_lock);
+
+        if (pool.jobs[i].output != NULL)
+            fwrite(pool.jobs[i].output, 1, pool.jobs[i].output_len, stdout);
         else
-        {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-        }
-        break;
+            printf("%s: Error: Memory allocation failed\n", pool.jobs[i].path);
+        free(pool.jobs[i].output);
+        if (pool.jobs[i].open_failed || pool.jobs[i].result.error_flag || !pool.jobs[i].result.parsing_done)
+            failures++;
+    }
 
-    case READ_ASSIGNMENT_OPERATOR:
-        if (is_whitespace)
-        {
-            parser->state = READ_ASSIGNMENT_OPERATOR;
-        }
-        else if (ascii_char == ')')
-            parser->paren_count--;
-        else if (ascii_char == '<')
-        {
-            parser->blocking_assignment1 = false;
-            parser->state = READ_ASSIGNMENT_OPERATOR;
-        }
-        else if (ascii_char == '=')
+    // Every worker first, a worker that is still running may steal from any queue
+    for (int w = 0; w < num_workers; w++)
+    {
+        if (workers[w].started)
+            pthread_join(threads[w], NULL);
+    }
+    for (int w = 0; w < num_workers; w++)
+    {
+        pthread_mutex_destroy(&pool.queues[w].lock);
+        parser_cleanup(&pool.parsers[w]);
+    }
+
+    pthread_cond_destroy(&pool.done_cond);
+    pthread_mutex_destroy(&pool.done_lock);
+    free(pool.jobs);
+    free(pool.queues);
+    free(pool.parsers);
+    free(workers);
+    free(threads);
+
+    return failures;
+}
+
+static bool path_list_add(PathList *list, const char *path)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        char **paths = realloc(list->paths, capacity * sizeof(char *));
+        if (paths == NULL)
+            return false;
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+
+    list->paths[list->count] = strdup(path);
+    if (list->paths[list->count] == NULL)
+        return false;
+    list->count++;
+    return true;
+}
+
+static int compare_names(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Add path to the list. Directories are walked recursively and contribute their .v files
+// in name order, so the output order is stable between runs.
+bool collect_paths(PathList *list, const char *path)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode))
+        return path_list_add(list, path);
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+        return path_list_add(list, path);
+
+    PathList entries = {NULL, 0, 0};
+    struct dirent *entry;
+    bool ok = true;
+
+    while (ok && (entry = readdir(dir)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        ok = path_list_add(&entries, entry->d_name);
+    }
+    closedir(dir);
+
+    if (entries.count > 0)
+        qsort(entries.paths, entries.count, sizeof(char *), compare_names);
+
+    for (size_t i = 0; i < entries.count; i++)
+    {
+        size_t name_len = strlen(entries.paths[i]);
+        char *child = malloc(strlen(path) + name_len + 2);
+
+        if (ok && child != NULL)
         {
-            if (parser->op_first == '<')
-            {
-                parser->blocking_assignment1 = false; // non-blocking (<=)
-            }
-            else
-            {
-                parser->blocking_assignment1 = true; // blocking (=)
-            }
-            parser->op_first = 0;
-            parser->num_buffer = 0;
-            parser->parsing_number = false;
-            parser->is_const1_negative = false;
-            parser->state = READ_CONST1;
+            sprintf(child, "%s/%s", path, entries.paths[i]);
+            if (stat(child, &st) == 0 && S_ISDIR(st.st_mode))
+                ok = collect_paths(list, child);
+            else if (name_len > 2 && strcmp(entries.paths[i] + name_len - 2, ".v") == 0)
+                ok = path_list_add(list, child);
         }
         else
         {
-            parser->op_first = ascii_char;
+            ok = false;
         }
-        break;
 
-    case READ_CONST1:
-        if (is_whitespace)
-        {
-            if (parser->is_const1_negative || parser->parsing_number)
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            else
-            {
-                parser->state = READ_CONST1;
-            }
-        }
-        else if (ascii_char == '(' && !parser->parsing_number)
-        {
-            parser->paren_count++;
-        }
-        else if (ascii_char == ')')
-        {
-            if (parser->num_buffer == 0)
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            else
-            {
-                parser->paren_count--;
-            }
-        }
-        // Check if there's a negative sign ("-") before the digit
-        else if (ascii_char == '-' && !parser->parsing_number)
-        {
-            parser->is_const1_negative = true;
-        }
-        else if (is_digit)
-        {
-            parser->num_buffer = (parser->num_buffer * 10) + (ascii_char - '0');
-            parser->parsing_number = true;
-        }
-        else if (parser->parsing_number)
-        {
-            if (parser->is_const1_negative)
-                parser->const1 = -parser->num_buffer;
-            else
-                parser->const1 = parser->num_buffer;
+        free(child);
+        free(entries.paths[i]);
+    }
+    free(entries.paths);
 
-            parser->num_buffer = 0;
-            parser->parsing_number = false;
+    return ok;
+}
 
-            if (ascii_char == ';')
-            {
-                parser->state = READ_SEMICOLON1;
-            }
-        }
-        else
-        {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-        }
-        break;
+// Streaming mode. Errors are located by line and column only when they are printed, the
+// line cursor never goes back, so a file full of errors is still scanned once.
+typedef struct
+{
+    size_t blocks;
+    size_t failures;
+    LineCursor lines;
+    RuleStoreBuilder *store;    // -o collects the parsed blocks here, or NULL
+    bool store_failed;
+} StreamState;
+
+static void print_stream_block(void *ctx, const BlockResult *block, const InputChunk *chunk)
+{
+    StreamState *stream = (StreamState *)ctx;
+    char label[96];
+
+    if (block == NULL)
+    {
+        // The read path is about to drop this chunk, count its newlines first
+        line_cursor_advance(&stream->lines, chunk->data, chunk->offset, chunk->len, chunk->offset + chunk->len);
+        return;
+    }
+
+    if (block->error_flag)
+    {
+        line_cursor_advance(&stream->lines, chunk->data, chunk->offset, chunk->len, block->error_offset);
+        snprintf(label, sizeof(label), "block %zu, line %zu, column %zu (byte %zu)", block->index,
+                 stream->lines.line, line_cursor_column(&stream->lines, block->error_offset), block->error_offset);
+    }
+    else
+    {
+        snprintf(label, sizeof(label), "block %zu", block->index);
+    }
+    print_result(stdout, label, block);
+    stream->blocks++;
+    if (!block->parsing_done)
+        stream->failures++;
+    if (stream->store != NULL && !rule_store_builder_add(stream->store, block))
+        stream->store_failed = true;
+}
+
+// Print every rule of a rule store file, the way -s prints blocks
+static int list_rule_store(const char *path)
+{
+    RuleStore *store = rule_store_open(path);
+    char label[32];
+
+    if (store == NULL)
+    {
+        printf("Error: %s is not a rule store\n", path);
+        return 1;
+    }
+    for (size_t i = 0; i < store->count; i++)
+    {
+        const char *assignment_var = rule_store_name(store, store->assignment_var[i]);
+
+        snprintf(label, sizeof(label), "rule %zu", i);
+        printf("%s: if (%s %s %d) %s = %d; else %s = %d;\n", label,
+            rule_store_name(store, store->cond_var[i]), comparator_str(rule_store_comparator(store, i)),
+            store->valC[i], assignment_var, store->const1[i], assignment_var, store->const2[i]);
+    }
+    rule_store_close(store);
+    return 0;
+}
+
+// Watch mode
+//
+// -w parses the file with error recovery, prints every block and then waits for the file to
+// be saved again (inotify on its directory, so editors that save by renaming are seen too).
+// A save is compared with the previous contents: the edit is everything between their
+// longest common prefix and suffix. Parsing restarts at the last block that starts before
+// the edit and stops at the first new block that starts past the edit where an old block
+// started. From there on the input is the same as before and the parser starts the block
+// in the same state, so the old blocks are kept, with their offsets shifted by the change
+// in length. Only blocks whose result differs from the one they replace are printed.
+#define WATCH_SLICE 16384 // bytes fed between checks for a block start of the previous run
+
+typedef struct
+{
+    BlockResult *blocks;
+    size_t count;
+    size_t capacity;
+} BlockList;
+
+typedef struct
+{
+    char *data;         // Contents of the last run, the parser's names stay valid as long as it
+    size_t len;
+    BlockList list;     // Its blocks, in input order
+} WatchState;
+
+static bool block_list_add(BlockList *list, const BlockResult *block)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        BlockResult *blocks = realloc(list->blocks, capacity * sizeof(BlockResult));
+        if (blocks == NULL)
+            return false;
+        list->blocks = blocks;
+        list->capacity = capacity;
+    }
+
+    list->blocks[list->count++] = *block;
+    return true;
+}
+
+// Read the whole file into a new buffer. Returns false if it could not be read.
+static bool read_whole_file(const char *path, char **data, size_t *len)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    size_t capacity;
+    size_t used = 0;
+    char *buffer;
+
+    if (fd < 0)
+        return false;
+    capacity = fstat(fd, &st) == 0 && st.st_size > 0 ? (size_t)st.st_size + 1 : INPUT_CHUNK_SIZE;
+    buffer = malloc(capacity);
 
-    case READ_SEMICOLON1:
-        if (parser->paren_count != 0)
-        {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-        }
-        if (is_whitespace)
+    while (buffer != NULL)
+    {
+        ssize_t nread;
+
+        if (used == capacity)
         {
-            parser->state = READ_SEMICOLON1;
+            char *grown = realloc(buffer, capacity * 2);
+            if (grown == NULL)
+                break;
+            buffer = grown;
+            capacity *= 2;
         }
-        else if (ascii_char == 'e')
+
+        nread = read(fd, buffer + used, capacity - used);
+        if (nread < 0 && errno == EINTR)
+            continue;
+        if (nread <= 0)
         {
-            parser->keyword_index = 1;
-            strcpy(parser->keyword_buffer, "e");
-            parser->state = READ_END1;
+            close(fd);
+            if (nread < 0)
+                break;
+            *data = buffer;
+            *len = used;
+            return true;
         }
+        used += (size_t)nread;
+    }
+
+    if (buffer == NULL)
+        close(fd);
+    free(buffer);
+    return false;
+}
+
+// Length of the common prefix of a and b, compared a page at a time until they differ
+static size_t common_prefix(const char *a, const char *b, size_t len)
+{
+    size_t i = 0;
+
+    while (i + 4096 <= len && memcmp(a + i, b + i, 4096) == 0)
+        i += 4096;
+    while (i < len && a[i] == b[i])
+        i++;
+    return i;
+}
+
+// Length of the common suffix of the len bytes ending at a_end and b_end
+static size_t common_suffix(const char *a_end, const char *b_end, size_t len)
+{
+    size_t i = 0;
+
+    while (i + 4096 <= len && memcmp(a_end - i - 4096, b_end - i - 4096, 4096) == 0)
+        i += 4096;
+    while (i < len && a_end[-(ptrdiff_t)i - 1] == b_end[-(ptrdiff_t)i - 1])
+        i++;
+    return i;
+}
+
+// Index of the first block starting at or after offset
+static size_t first_block_from(const BlockList *list, size_t offset)
+{
+    size_t lo = 0;
+    size_t hi = list->count;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (list->blocks[mid].start_offset < offset)
+            lo = mid + 1;
         else
-        {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
-        }
-        break;
+            hi = mid;
+    }
+    return lo;
+}
+
+// Same nodes, variables and Conditions. Asts are not interned, every run builds its own.
+static bool same_ast(const Ast *a, const Ast *b)
+{
+    if (a == NULL || b == NULL)
+        return a == b;
+    return a->node_count == b->node_count && a->var_count == b->var_count &&
+           a->condition_size == b->condition_size &&
+           memcmp(a->nodes, b->nodes, a->node_count * sizeof(AstNode) + a->var_count * sizeof(int) +
+                  a->condition_size) == 0;
+}
+
+// Same result, wherever the blocks are in the input
+static bool same_result(const BlockResult *a, const BlockResult *b)
+{
+    return a->parsing_done == b->parsing_done && a->error_flag == b->error_flag &&
+           a->error_code == b->error_code && a->cond_var_id == b->cond_var_id &&
+           a->comparator == b->comparator && a->valC == b->valC &&
+           a->assignment_var_id == b->assignment_var_id && a->const1 == b->const1 &&
+           a->const2 == b->const2 && a->ladder == b->ladder && a->branches == b->branches &&
+           same_ast(a->ast, b->ast);
+}
+
+// Bring the watch state up to date with the new contents, printing the changed blocks. Takes
+// ownership of data. Returns false if memory ran out, the state is then unchanged.
+static bool watch_update(Parser *parser, WatchState *watch, char *data, size_t len)
+{
+    struct timespec t0, t1;
+    size_t min_len = len < watch->len ? len : watch->len;
+    BlockList fresh = {NULL, 0, 0};
+    BlockResult block;
 
-    case READ_END1:
-        switch (parser->keyword_index)
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // The first run has nothing to compare with
+    size_t prefix = watch->data != NULL ? common_prefix(watch->data, data, min_len) : 0;
+    if (watch->data != NULL && prefix == min_len && len == watch->len)
+    {
+        free(data);
+        return true;
+    }
+    size_t suffix = watch->data != NULL ? common_suffix(watch->data + watch->len, data + len, min_len - prefix) : 0;
+    size_t old_edit_end = watch->len - suffix;
+    size_t new_edit_end = len - suffix;
+
+    // Restart at the last block that starts before the edit. A block found by recovery
+    // depends on the two bytes after its 'i' too (the 'f' and a non-identifier byte), so it
+    // has to start three bytes before the edit. Block 0 starts at offset 0, so an edit in
+    // front of it or in an empty list restarts from the top.
+    size_t first = first_block_from(&watch->list, prefix > 2 ? prefix - 2 : 0);
+    if (first > 0)
+        first--;
+    size_t restart = first < watch->list.count ? watch->list.blocks[first].start_offset : 0;
+    size_t resume = watch->list.count; // first old block kept after the reparsed ones
+    bool synced = false;
+    bool ok = true;
+
+    parser_restart(parser, restart, first);
+    for (size_t pos = restart; !synced && ok; )
+    {
+        size_t n = len - pos < WATCH_SLICE ? len - pos : WATCH_SLICE;
+
+        if (n == 0)
+            parser_finish(parser);
+        else if (parser_feed(parser, data + pos, n) < n)
+            ok = false; // The block queue could not grow
+        pos += n;
+
+        while (ok && !synced && parser_poll(parser, &block))
         {
-        case 1:
-            if (ascii_char == 'n')
-            {
-                strcat(parser->keyword_buffer, "n");
-                parser->keyword_index++;
-            }
-            else
+            if (block.start_offset >= new_edit_end)
             {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+                size_t old_start = block.start_offset - new_edit_end + old_edit_end;
+                size_t j = first_block_from(&watch->list, old_start);
 
-        case 2:
-            if (ascii_char == 'd')
-            {
-                parser->keyword_index = 0;
-                parser->state = READ_ELSE;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
+                if (j < watch->list.count && watch->list.blocks[j].start_offset == old_start)
+                {
+                    synced = true;
+                    resume = j;
+                    break;
+                }
             }
-            break;
-
-        default:
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-            break;
+            ok = block_list_add(&fresh, &block);
         }
-        break;
+        if (n == 0)
+            break;
+    }
 
-    case READ_ELSE:
-        if (is_whitespace)
-        {
-            parser->state = READ_ELSE;
-        }
-        else if (ascii_char == 'e' && parser->keyword_index == 0)
-        {
-            parser->keyword_index = 1;
-            strcpy(parser->keyword_buffer, "e");
-        }
-        else if (parser->keyword_index == 1 && ascii_char == 'l')
-        {
-            strcat(parser->keyword_buffer, "l");
-            parser->keyword_index++;
-        }
-        else if (parser->keyword_index == 2 && ascii_char == 's')
-        {
-            strcat(parser->keyword_buffer, "s");
-            parser->keyword_index++;
-        }
-        else if (parser->keyword_index == 3 && ascii_char == 'e')
-        {
-            parser->keyword_index = 0;
-            parser->state = READ_BEGIN2;
-        }
+    // Make room for the new list: old blocks [0, first), the reparsed ones, then the old
+    // blocks from resume on
+    BlockList *list = &watch->list;
+    size_t kept = list->count - resume;
+    size_t count = first + fresh.count + kept;
+    if (ok && count > list->capacity)
+    {
+        BlockResult *blocks = realloc(list->blocks, count * sizeof(BlockResult));
+        if (blocks == NULL)
+            ok = false;
         else
         {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
+            list->blocks = blocks;
+            list->capacity = count;
         }
-        break;
+    }
+    if (!ok)
+    {
+        free(fresh.blocks);
+        free(data);
+        return false;
+    }
 
-    case READ_BEGIN2:
-        if (is_whitespace)
-        {
-            parser->state = READ_BEGIN2;
-        }
-        else if (ascii_char == 'b')
-        {
-            parser->keyword_index = 1;
-            strcpy(parser->keyword_buffer, "b");
-            parser->state = READ_BEGIN2;
-        }
-        else if (parser->keyword_index == 1 && ascii_char == 'e')
-        {
-            strcat(parser->keyword_buffer, "e");
-            parser->keyword_index++;
-        }
-        else if (parser->keyword_index == 2 && ascii_char == 'g')
-        {
-            strcat(parser->keyword_buffer, "g");
-            parser->keyword_index++;
-        }
-        else if (parser->keyword_index == 3 && ascii_char == 'i')
-        {
-            strcat(parser->keyword_buffer, "i");
-            parser->keyword_index++;
-        }
-        else if (parser->keyword_index == 4 && ascii_char == 'n')
+    // Print what changed, compared with the old block at the same index
+    LineCursor lines;
+    size_t changed = 0;
+    char label[96];
+
+    line_cursor_init(&lines);
+    for (size_t i = 0; i < fresh.count; i++)
+    {
+        const BlockResult *now = &fresh.blocks[i];
+
+        if (first + i < resume && same_result(now, &list->blocks[first + i]))
+            continue;
+        if (now->error_flag)
         {
-            parser->keyword_index = 0;
-            parser->state = READ_ASSIGNMENT_VAR2;
-            parser->reading_var = false;
-            parser->assignment_var2_idx = 0;
-            parser->assignment_var2_length = 0;
+            line_cursor_advance(&lines, data, 0, len, now->error_offset);
+            snprintf(label, sizeof(label), "block %zu, line %zu, column %zu (byte %zu)", now->index,
+                     lines.line, line_cursor_column(&lines, now->error_offset), now->error_offset);
         }
         else
         {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
+            snprintf(label, sizeof(label), "block %zu", now->index);
         }
-        break;
+        print_result(stdout, label, now);
+        changed++;
+    }
 
-    case READ_ASSIGNMENT_VAR2:
-        if (is_whitespace && !parser->reading_var)
+    // Splice, the kept blocks only need touching when their index or offset moved
+    memmove(list->blocks + first + fresh.count, list->blocks + resume, kept * sizeof(BlockResult));
+    memcpy(list->blocks + first, fresh.blocks, fresh.count * sizeof(BlockResult));
+    if (first + fresh.count != resume || len != watch->len)
+    {
+        for (size_t j = first + fresh.count; j < count; j++)
         {
-            parser->state = READ_ASSIGNMENT_VAR2;
+            BlockResult *moved = &list->blocks[j];
+
+            moved->index = j;
+            moved->start_offset = moved->start_offset - old_edit_end + new_edit_end;
+            moved->end_offset = moved->end_offset - old_edit_end + new_edit_end;
+            if (moved->error_flag)
+                moved->error_offset = moved->error_offset - old_edit_end + new_edit_end;
         }
-        else if (!parser->reading_var && is_id_start)
+    }
+    list->count = count;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("%zu blocks, %zu reparsed, %zu changed, %zu removed (%.3f ms)\n", count, fresh.count, changed,
+           resume - first > fresh.count ? resume - first - fresh.count : 0,
+           (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+    fflush(stdout);
+
+    free(fresh.blocks);
+    free(watch->data);
+    watch->data = data;
+    watch->len = len;
+    return true;
+}
+
+// Parse path, then reparse it on every save until interrupted. Returns 1 on a setup error.
+int watch_file(Parser *parser, const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    const char *name = slash != NULL ? slash + 1 : path;
+    char *dir = slash == NULL ? strdup(".") : slash == path ? strdup("/") : strndup(path, (size_t)(slash - path));
+    WatchState watch = {NULL, 0, {NULL, 0, 0}};
+    char *data;
+    size_t len;
+
+    parser->recover = true;
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (dir == NULL || fd < 0 || inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        printf("Error: Could not watch %s\n", path);
+        free(dir);
+        return 1;
+    }
+    free(dir);
+
+    if (!read_whole_file(path, &data, &len))
+    {
+        printf("Error: Could not read %s\n", path);
+        return 1;
+    }
+    if (!watch_update(parser, &watch, data, len))
+        printf("Error: Memory allocation failed\n");
+
+    for (;;)
+    {
+        char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t nread = read(fd, events, sizeof(events));
+        bool saved = false;
+
+        if (nread < 0 && errno == EINTR)
+            continue;
+        if (nread <= 0)
+            break;
+
+        // A save can raise several events, handle them as one
+        for (char *p = events; p < events + nread; )
         {
-            // First character of identifier - must be a letter
-            parser->assignment_var2[0] = ascii_char; // Start at index 0
-            parser->assignment_var2_length = 1;
-            parser->assignment_var2_idx = 1; // Tracking position
-            parser->reading_var = true;
+            const struct inotify_event *event = (const struct inotify_event *)p;
+
+            if (event->len > 0 && strcmp(event->name, name) == 0)
+                saved = true;
+            p += sizeof(struct inotify_event) + event->len;
         }
-        else if (parser->reading_var && is_id_char)
-        {
-            // Subsequent characters - can be letter, digit, or underscore
-            if (parser->assignment_var2_idx < 15)
-            { 
-                parser->assignment_var2[parser->assignment_var2_idx] = ascii_char;
-                parser->assignment_var2_idx++;
-                parser->assignment_var2_length++;
-            }
+        if (!saved)
+            continue;
 
-            if (parser->assignment_var2_idx == 15)
-            { 
-                parser->state = READ_ASSIGNMENT_OPERATOR2;
-                parser->reading_var = false;
-                parser->assignment_var2[15] = '\0'; 
-            }
+        if (!read_whole_file(path, &data, &len))
+            printf("Error: Could not read %s\n", path);
+        else if (!watch_update(parser, &watch, data, len))
+            printf("Error: Memory allocation failed\n");
+
+        // Watch mode only ends on a signal, so the cache is written after every save
+        if (parser->cache != NULL)
+            block_cache_flush(parser->cache);
+    }
+
+    close(fd);
+    return 1;
+}
+
+// Queued cache entries are written when carser exits, whichever way main returns
+#define BLOCK_CACHE_SIZE (64 << 20) // Size of a new cache file, an existing one keeps its own
+// Interactive evaluation of an else-if chain or a block that assigns several variables, the
+// counterpart of the prompt in main
+static int evaluate_rule_interactive(const Parser *parser)
+{
+    BlockResult block;
+    const Ladder *ladder = parser->ladder;
+    size_t arm_count = ladder != NULL ? ladder->arm_count : 1;
+    size_t name_count = symbol_count(parser->symbols);
+    size_t pair_count;
+    int *var_values = calloc(name_count, sizeof(int));
+    bool *asked = calloc(name_count, sizeof(bool));
+    int *arm_values = malloc(arm_count * sizeof(int));
+    Assignment *pairs;
+
+    parser_block_result(parser, &block);
+    pair_count = block_assignment_count(&block);
+    pairs = malloc(pair_count * sizeof(Assignment));
+    if (var_values == NULL || asked == NULL || arm_values == NULL || pairs == NULL)
+    {
+        printf("Error: Memory allocation failed\n");
+        free(var_values);
+        free(asked);
+        free(arm_values);
+        free(pairs);
+        return 1;
+    }
+
+    printf("\nParsing successful!\n");
+    print_result(stdout, ladder != NULL ? "Conditions" : "Condition", &block);
+    if (ladder != NULL && ladder->cond_var_id >= 0)
+        printf("%zu conditions on %s, %zu intervals\n", ladder->arm_count, block.cond_var, ladder->threshold_count);
+
+    // One prompt per variable, in the order of the arms
+    for (size_t a = 0; a < arm_count; a++)
+    {
+        int id = ladder != NULL ? ladder->arms[a].cond_var_id : block.cond_var_id;
+
+        if (!asked[id])
+        {
+            printf("\nEnter value for '%s': ", symbol_name(parser->symbols, id));
+            if (scanf("%d", &var_values[id]) != 1)
+                var_values[id] = 0;
+            asked[id] = true;
         }
-        else if (parser->reading_var && (is_whitespace || ascii_char == '=' || ascii_char == '<'))
+        arm_values[a] = var_values[id];
+    }
+
+    size_t branch;
+    if (ladder != NULL && ladder->cond_var_id < 0)
+        branch = ladder_branch_arms(ladder, arm_values);
+    else
+        branch = block_branch(&block, arm_values[0]);
+
+    branch_assignments(&block, branch, pairs);
+    printf("\nAssigned");
+    for (size_t i = 0; i < pair_count; i++)
+        printf("%s %s = %d", i > 0 ? "," : "", symbol_name(parser->symbols, pairs[i].var_id), pairs[i].value);
+    printf(".\n");
+
+    free(var_values);
+    free(asked);
+    free(arm_values);
+    free(pairs);
+    return 0;
+}
+
+// Interactive evaluation of a nested block, one prompt per variable its conditions test, in
+// the order they are met
+static int evaluate_nested_interactive(const Parser *parser)
+{
+    BlockResult block;
+    const Ast *ast = parser->ast;
+    const int *vars = ast_variables(ast);
+    size_t name_count = symbol_count(parser->symbols);
+    int *var_values = calloc(name_count, sizeof(int));
+    bool *asked = calloc(name_count, sizeof(bool));
+    int *values = malloc(ast->var_count * sizeof(int));
+
+    if (var_values == NULL || asked == NULL || values == NULL)
+    {
+        printf("Error: Memory allocation failed\n");
+        free(var_values);
+        free(asked);
+        free(values);
+        return 1;
+    }
+
+    parser_block_result(parser, &block);
+    printf("\nParsing successful!\n");
+    print_result(stdout, "Conditions", &block);
+
+    for (size_t i = 0; i < ast->node_count; i++)
+    {
+        const AstNode *node = &ast->nodes[i];
+        const Condition *cond = node->comparator == COMPOUND ? ast_condition(ast, node) : NULL;
+        size_t id_count = cond != NULL ? cond->reg_count : 1;
+
+        for (size_t v = 0; node->kind == AST_IF && v < id_count; v++)
         {
-            // Variable name complete, ready for operator
-            parser->assignment_var2[parser->assignment_var2_length] = '\0'; 
-            parser->state = READ_ASSIGNMENT_OPERATOR2;
-            parser->reading_var = false;
+            int id = cond != NULL ? condition_variables(cond)[v] : node->var_id;
 
-            // Process operator rightaway if not whitespace
-            if (!is_whitespace)
+            if (!asked[id])
             {
-                if (ascii_char == '<')
-                {
-                    parser->blocking_assignment2 = false;
-                    parser->op_first = '<';
-                }
-                else if (ascii_char == '=')
-                {
-                    parser->blocking_assignment2 = true;
-                    parser->op_first = 0;
-                    parser->num_buffer = 0;
-                    parser->parsing_number = false;
-                    parser->is_const2_negative = false;
-                    parser->state = READ_CONST2;
-                }
+                printf("\nEnter value for '%s': ", symbol_name(parser->symbols, id));
+                if (scanf("%d", &var_values[id]) != 1)
+                    var_values[id] = 0;
+                asked[id] = true;
             }
         }
-        else
+    }
+
+    ast_evaluate_vars(ast, var_values, values);
+    printf("\nAssigned");
+    for (size_t i = 0; i < ast->var_count; i++)
+        printf("%s %s = %d", i > 0 ? "," : "", symbol_name(parser->symbols, vars[i]), values[i]);
+    printf(".\n");
+
+    free(var_values);
+    free(asked);
+    free(values);
+    return 0;
+}
+
+static BlockCache *block_cache;
+
+static void close_block_cache(void)
+{
+    block_cache_close(block_cache);
+}
+
+int main(int argc, char *argv[])
+{   
+    Parser parser;
+    int input_value;
+    const char *batch_path = NULL;
+    const char *input_path = "input.v";
+    int num_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    PathList inputs = {NULL, 0, 0};
+    bool multi_file = false;
+    bool stream_mode = false;
+    bool watch_mode = false;
+    const char *store_path = NULL;
+
+    // Initialize parser
+    parser_init(&parser);
+
+    // -d enables debug mode, -b <file> evaluates every x value in <file> ("-" for stdin),
+    // -j <n> sets the number of worker threads, -e <switch|table> selects the parsing engine,
+    // -s streams every block of the input, -r streams and recovers from errors, -w watches the
+    // file and reparses it on every save, -c <file> keeps parsed blocks in a persistent cache,
+    // -o <file> writes the streamed blocks to a rule store, -l <file> lists a rule store,
+    // the remaining arguments are files or directories
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-d") == 0)
         {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
+            parser.debug_mode = true;
         }
-        break;
-
-    case READ_ASSIGNMENT_OPERATOR2:
-        if (is_whitespace)
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
         {
-            parser->state = READ_ASSIGNMENT_OPERATOR2;
+            batch_path = argv[++i];
         }
-        else if (ascii_char == ')')
-            parser->paren_count--;
-        else if (ascii_char == '<')
+        else if (strcmp(argv[i], "-s") == 0)
         {
-            parser->blocking_assignment2 = false;
-            parser->op_first = '<';
+            stream_mode = true;
         }
-        else if (ascii_char == '=')
+        else if (strcmp(argv[i], "-r") == 0)
         {
-            if (parser->op_first == '<')
-            {
-                parser->blocking_assignment2 = false; // non-blocking (<=)
-            }
-            else
-            {
-                parser->blocking_assignment2 = true; // blocking (=)
-            }
-            parser->op_first = 0;
-            parser->num_buffer = 0;
-            parser->parsing_number = false;
-            parser->is_const2_negative = false;
-            parser->state = READ_CONST2;
+            stream_mode = true;
+            parser.recover = true;
         }
-        else
+        else if (strcmp(argv[i], "-w") == 0)
         {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
+            watch_mode = true;
         }
-        break;
-
-    case READ_CONST2:
-        if (is_whitespace)
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc && block_cache == NULL)
         {
-            if (parser->is_const2_negative || parser->parsing_number)
+            block_cache = block_cache_open(argv[++i], BLOCK_CACHE_SIZE);
+            if (block_cache == NULL)
             {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
-            else
-            {
-                parser->state = READ_CONST2;
+                printf("Error: Could not open the block cache %s\n", argv[i]);
+                return 1;
             }
+            atexit(close_block_cache);
+            parser.cache = block_cache;
         }
-        else if (ascii_char == '(' && !parser->parsing_number)
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
         {
-            parser->paren_count++;
+            store_path = argv[++i];
         }
-        else if (ascii_char == ')')
+        else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
         {
-            if (parser->parsing_number)
-            {
-                parser->paren_count--;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
-            }
+            return list_rule_store(argv[++i]);
         }
-        // Check if there's a negative sign ("-") before the digit
-        else if (ascii_char == '-' && !parser->parsing_number)
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
         {
-            parser->is_const2_negative = true;
+            num_workers = atoi(argv[++i]);
         }
-        else if (is_digit)
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc && strcmp(argv[i + 1], "switch") == 0)
         {
-            parser->num_buffer = (parser->num_buffer * 10) + (ascii_char - '0');
-            parser->parsing_number = true;
+            parser.engine = ENGINE_SWITCH;
+            i++;
         }
-        else if (parser->parsing_number)
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc && strcmp(argv[i + 1], "table") == 0)
         {
-            if (parser->is_const2_negative)
-                parser->const2 = -parser->num_buffer;
-            else
-                parser->const2 = parser->num_buffer;
-
-            parser->num_buffer = 0;
-            parser->parsing_number = false;
-
-            if (ascii_char == ';')
-            {
-                parser->state = READ_SEMICOLON2;
-            }
-            else
+            parser.engine = ENGINE_TABLE;
+            i++;
+        }
+        else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)
+        {
+            struct stat st;
+            if (stat(argv[i], &st) == 0 && S_ISDIR(st.st_mode))
+                multi_file = true;
+            if (!collect_paths(&inputs, argv[i]))
             {
-                parser->error_flag = true;
-                parser->error_code = SYNTAX_ERROR;
+                printf("Error: Memory allocation failed\n");
+                return 1;
             }
         }
         else
         {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
+            printf("Usage: %s [-d] [-b <x_values_file | ->] [-j <workers>] [-e <switch|table>] [-s | -r | -w] [-c <cache>] [-o <store> | -l <store>] [file | directory ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // More than one file (or any directory) is parsed in parallel and reported per file
+    if (multi_file || inputs.count > 1)
+    {
+        if (batch_path != NULL || stream_mode || watch_mode)
+        {
+            printf("Error: -b, -s, -r and -w need a single input file\n");
+            return 1;
         }
-        break;
 
-    case READ_SEMICOLON2:
-        if (parser->paren_count != 0)
+        int failures = process_files(inputs.paths, inputs.count, num_workers, parser.debug_mode, parser.engine, parser.cache);
+        for (size_t i = 0; i < inputs.count; i++)
+            free(inputs.paths[i]);
+        free(inputs.paths);
+        return failures > 0 ? 1 : 0;
+    }
+    if (inputs.count == 1)
+        input_path = inputs.paths[0];
+    if (batch_path != NULL && strcmp(batch_path, "-") == 0 && strcmp(input_path, "-") == 0)
+    {
+        printf("Error: stdin cannot be both the input file and the -b stream\n");
+        return 1;
+    }
+
+    // Print every block, then the blocks that change on each save
+    if (watch_mode)
+    {
+        if (batch_path != NULL || stream_mode || strcmp(input_path, "-") == 0)
         {
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
+            printf("Error: -w needs a file, and cannot be combined with -b, -s or -r\n");
+            return 1;
         }
-        if (is_whitespace)
+        return watch_file(&parser, input_path);
+    }
+
+    if (store_path != NULL && !stream_mode)
+    {
+        printf("Error: -o needs -s or -r\n");
+        return 1;
+    }
+
+    // Stream every block of the input, printing each one as soon as it is parsed
+    if (stream_mode)
+    {
+        StreamState stream = {0};
+
+        line_cursor_init(&stream.lines);
+        if (batch_path != NULL)
         {
-            parser->state = READ_SEMICOLON2;
+            printf("Error: -b cannot be combined with -s or -r\n");
+            return 1;
         }
-        else if (ascii_char == 'e')
+        if (store_path != NULL && (stream.store = rule_store_builder_create()) == NULL)
         {
-            parser->keyword_index = 1;
-            strcpy(parser->keyword_buffer, "e");
-            parser->state = READ_END2;
+            printf("Error: Memory allocation failed\n");
+            return 1;
         }
-        else
+        if (!parse_file(&parser, input_path, print_stream_block, &stream))
         {
-            parser->error_flag = true;
-            parser->error_code = INVALID_KEYWORD;
+            printf("Error: Could not read %s\n", input_path);
+            rule_store_builder_destroy(stream.store);
+            return 1;
         }
-        break;
-
-    case READ_END2:
-        switch (parser->keyword_index)
+        if (parser.recover)
+            printf("%zu blocks, %zu with errors or incomplete\n", stream.blocks, stream.failures);
+        if (stream.store != NULL)
         {
-        case 1:
-            if (ascii_char == 'n')
-            {
-                strcat(parser->keyword_buffer, "n");
-                parser->keyword_index++;
-            }
-            else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
+            bool written = !stream.store_failed && rule_store_write(stream.store, store_path);
+            size_t skipped = rule_store_builder_skipped(stream.store);
 
-        case 2:
-            if (ascii_char == 'd')
-            {
-                // Check if variable names match between true and false branches
-                parser->var_match = var_names_match(parser);
-                if (!parser->var_match)
-                {
-                    parser->error_flag = true;
-                    parser->error_code = VAR_MISMATCH;
-                }
-                else
-                {
-                    parser->state = EVALUATE;
-                    parser->parsing_done = true;
-                }
-            }
+            if (written && skipped > 0)
+                printf("Wrote %zu rules to %s, skipped %zu unsupported blocks (else-if chains, several "
+                       "assignments per branch, nested blocks or compound conditions)\n",
+                       rule_store_builder_count(stream.store), store_path, skipped);
+            else if (written)
+                printf("Wrote %zu rules to %s\n", rule_store_builder_count(stream.store), store_path);
             else
-            {
-                parser->error_flag = true;
-                parser->error_code = INVALID_KEYWORD;
-            }
-            break;
-
-        default:
-            parser->error_flag = true;
-            parser->error_code = SYNTAX_ERROR;
-            break;
+                printf("Error: Could not write the rule store %s\n", store_path);
+            rule_store_builder_destroy(stream.store);
+            if (!written || skipped > 0)
+                return 1;
         }
-        break;
-
-    case EVALUATE:
-        // This state is reached when the parser has successfully parsed the if-else construct
-        // Evaluation logic is handled in another function
-        break;
-
-    default:
-        parser->error_flag = true;
-        parser->error_code = SYNTAX_ERROR;
-        break;
-    }
-}
-
-// Function to evaluate the condition with the given input value
-bool evaluate_condition(Parser *parser, int input_value) 
-{
-    bool condition_result = false;
-    
-    printf("EVALUATING: %s=%d %s %d\n", 
-        parser->cond_var, input_value, 
-        parser->comparator == EQ ? "==" :
-        parser->comparator == NE ? "!=" :
-        parser->comparator == LT ? "<" :
-        parser->comparator == GT ? ">" :
-        parser->comparator == LE ? "<=" :
-        parser->comparator == GE ? ">=" : "??",
-        parser->valC);
-    
-    switch (parser->comparator) {
-        case EQ: condition_result = (input_value == parser->valC); break;
-        case NE: condition_result = (input_value != parser->valC); break;
-        case LT: condition_result = (input_value < parser->valC); break;
-        case GT: condition_result = (input_value > parser->valC); break;
-        case LE: condition_result = (input_value <= parser->valC); break;
-        case GE: condition_result = (input_value >= parser->valC); break;
-        default: condition_result = false; break;
+        return stream.failures > 0 ? 1 : 0;
     }
-    
-    return condition_result;
-}
-
-int main(int argc, char *argv[])
-{   
-    FILE *fp;
-    char ch;
-    Parser parser;
-    int input_value;
-
-    // Initialize parser
-    parser_init(&parser);
 
-    // Enable debug mode if command line argument is provided
-    if (argc > 1 && strcmp(argv[1], "-d") == 0)
+    // Parse the input file
+    if (!parse_file(&parser, input_path, NULL, NULL))
     {
-        parser.debug_mode = true;
+        printf("Error: Could not read %s\n", input_path);
+        return 1;
     }
 
-    // Open input file
-    fp = fopen("input.v", "r");
-    if (fp == NULL)
+    // Check for errors and print results
+    if (parser.error_flag)
     {
-        printf("Error: Could not open input.v\n");
+        printf("Error code %d: %s\n", parser.error_code, error_message(parser.error_code));
         return 1;
     }
 
-    // Process file character by character
-    while ((ch = fgetc(fp)) != EOF && !parser.parsing_done && !parser.error_flag)
+    // In batch mode, evaluate every x value from the stream without prompting
+    if (batch_path != NULL && parser.parsing_done)
     {
-        process_char(&parser, ch);
-    }
-
-    fclose(fp);
+        FILE *batch_fp = strcmp(batch_path, "-") == 0 ? stdin : fopen(batch_path, "r");
+        if (batch_fp == NULL)
+        {
+            printf("Error: Could not open %s\n", batch_path);
+            return 1;
+        }
 
-    // Check for errors and print results
-    if (parser.error_flag)
-    {
-        printf("Error code %d: ", parser.error_code);
-        switch (parser.error_code)
+        BlockResult block;
+        int *values = NULL;
+        parser_block_result(&parser, &block);
+        if ((block.ladder != NULL && block.ladder->cond_var_id < 0) || (block.ast != NULL && block.ast->cond_var_id < 0))
         {
-        case INVALID_KEYWORD:
-            printf("Invalid keyword encountered\n");
-            break;
-        case VAR_MISMATCH:
-            printf("Variable names don't match between if and else branches\n");
-            break;
-        case INVALID_CHAR:
-            printf("Invalid character encountered\n");
-            break;
-        case MISSING_SEMICOLON:
-            printf("Missing semicolon\n");
-            break;
-        case MISSING_OPERATOR:
-            printf("Invalid or missing operator\n");
-            break;
-        case SYNTAX_ERROR:
-            printf("Syntax error\n");
-            break;
-        default:
-            printf("Unknown error\n");
-            break;
+            printf("Error: -b needs every condition of the else-if chain to test the same variable\n");
+            if (batch_fp != stdin)
+                fclose(batch_fp);
+            return 1;
         }
-        return 1;
+        if (block.ast != NULL && block.ast->var_count > 1 && (values = malloc(block.ast->var_count * sizeof(int))) == NULL)
+        {
+            printf("Error: Memory allocation failed\n");
+            if (batch_fp != stdin)
+                fclose(batch_fp);
+            return 1;
+        }
+
+        int status = run_batch(&block, values, batch_fp, stdout);
+        if (batch_fp != stdin)
+            fclose(batch_fp);
+        free(values);
+        return status;
     }
 
+    // An else-if chain asks for each variable it tests, and a block that assigns several
+    // variables prints them all, as does a nested one
+    if (parser.parsing_done && parser.ast != NULL)
+        return evaluate_nested_interactive(&parser);
+    if (parser.parsing_done && (parser.ladder != NULL || parser.branches != NULL))
+        return evaluate_rule_interactive(&parser);
+
     // If parsing was successful, prompt user for variable value and evaluate
     if (parser.parsing_done)
     {
+        const char *cond_var = symbol_name(parser.symbols, parser.cond_var_id);
+        const char *assignment_var = symbol_name(parser.symbols, parser.assignment_var_id);
+
         // Print basic information about the parsed structure
         printf("\nParsing successful!\n");
         printf("Condition: %s %s %d\n", 
-            parser.cond_var,
-            parser.comparator == EQ ? "==" :
-            parser.comparator == NE ? "!=" :
-            parser.comparator == LT ? "<" :
-            parser.comparator == GT ? ">" :
-            parser.comparator == LE ? "<=" :
-            parser.comparator == GE ? ">=" : "??",
-            parser.valC);
-        printf("If true, %s = %d\n", parser.assignment_var, parser.const1);
-        printf("If false, %s = %d\n", parser.assignment_var, parser.const2);
+            cond_var, comparator_str(parser.comparator), parser.valC);
+        printf("If true, %s = %d\n", assignment_var, parser.const1);
+        printf("If false, %s = %d\n", assignment_var, parser.const2);
         
         // Get user input for condition variable
-        printf("\nEnter value for '%s': ", parser.cond_var);
+        printf("\nEnter value for '%s': ", cond_var);
         scanf("%d", &input_value);
         
         // Evaluate the condition
+        printf("EVALUATING: %s=%d %s %d\n", 
+            cond_var, input_value, comparator_str(parser.comparator), parser.valC);
         bool condition_result = evaluate_condition(&parser, input_value);
         
         // Assign the correct value based on the condition result
@@ -1242,16 +1607,19 @@ int main(int argc, char *argv[])
             parser.p = parser.const1;
             printf("\nCondition is TRUE\n");
             printf("Assigned %s = %d.\n", 
-                parser.assignment_var, parser.p);
+                assignment_var, parser.p);
         } else {
             parser.p = parser.const2;
             printf("\nCondition is FALSE\n");
             printf("Assigned %s = %d.\n", 
-                parser.assignment_var, parser.p);
+                assignment_var, parser.p);
         }
     }
     else {
         printf("\nParsing incomplete - could not evaluate\n");
+        // There is nothing to evaluate the batch with, which scripts have to see
+        if (batch_path != NULL)
+            return 1;
     }
 
     return 0;
@@ -0,0 +1,538 @@
+#ifndef CARSER_H
+#define CARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Error codes
+#define NO_ERROR 0
+#define INVALID_KEYWORD 1
+#define VAR_MISMATCH 2
+#define INVALID_CHAR 3
+#define MISSING_SEMICOLON 4
+#define MISSING_OPERATOR 5
+#define SYNTAX_ERROR 6
+#define NUM_OVERFLOW 8 // Integer constant outside the range of int, 7 is PAREN_MISMATCH in the RTL
+#define OUT_OF_MEMORY 9
+#define COND_TOO_LARGE 10 // Compound condition over more than 256 variables or 65533 comparisons
+
+// State encoding (matching the Verilog implementation)
+#define IDLE 0
+#define READ_IF 1 // Read "if" keyword
+#define READ_OPEN_PAREN 2
+#define READ_VAR 3
+#define READ_COND_OPERATOR 4  // Read first char of comparator
+#define READ_COND_OPERATOR2 5 // Read second char of comparator (if any)
+#define READ_VALC 6
+#define READ_CLOSE_PAREN 7
+#define READ_BEGIN 8                 // Read "begin" keyword
+#define READ_ASSIGNMENT_VAR 9        // Read variable for assignment
+#define READ_ASSIGNMENT_OPERATOR 10  // Read assignment operator (<= or =)
+#define READ_CONST1 11               // Read constant for true branch
+#define READ_SEMICOLON1 12           // Expect ; after const1
+#define READ_END1 13                 // Read "end" keyword for true branch
+#define READ_ELSE 14                 // Expect "else" keyword
+#define READ_BEGIN2 16               // Read "begin" for false branch
+#define READ_ASSIGNMENT_VAR2 18      // Read variable for false branch
+#define READ_ASSIGNMENT_OPERATOR2 19 // Read assignment operator for false branch
+#define READ_CONST2 20               // Read constant for false branch
+#define READ_SEMICOLON2 21           // Expect ; after const2
+#define READ_END2 22                 // Read "end" keyword for false branch
+#define EVALUATE 23
+
+// Compound conditions, which the Verilog implementation does not read
+#define READ_COND_LOGIC 24 // Read second char of "&&" or "||"
+#define READ_COND_NOT 25   // Expect "(" after "!"
+
+// Parsing engines
+#define ENGINE_SWITCH 0 // process_char, one switch step per char
+#define ENGINE_TABLE 1  // parse_buffer_table, character classes and a transition table
+
+// Comparator types
+#define EQ 0
+#define NE 1
+#define LT 2
+#define GT 3
+#define LE 4
+#define GE 5
+#define COMPOUND 6 // Not a comparator: the condition is a Condition program
+
+// A comparator as the set of outcomes of x against valC that make it true
+#define CMP_LT_BIT 1
+#define CMP_EQ_BIT 2
+#define CMP_GT_BIT 4
+
+// Interned identifiers. Each distinct name is stored once and gets a small integer ID
+// (0, 1, 2, ... in order of first appearance), so comparing names is comparing IDs.
+typedef struct SymbolTable SymbolTable;
+typedef struct BlockCache BlockCache;
+typedef struct AstArena AstArena;
+typedef struct NestFrame NestFrame;
+
+// One condition of an else-if ladder and the value it assigns (to the first assigned variable)
+// when it is the first to hold
+typedef struct
+{
+    int cond_var_id;
+    int comparator;
+    int valC;
+    int value;
+} LadderArm;
+
+// An "if ... else if ... else" ladder, the arms in input order. Branch a is taken when arm a
+// is the first condition to hold, branch arm_count (the final else) when none does.
+// When every arm tests the same variable the ladder is also compiled into a threshold table:
+// the x axis split into threshold_count intervals, interval i starting at
+// ladder_thresholds()[i] (ascending, the first one INT_MIN) and taking branch
+// ladder_branches()[i]. Adjacent intervals take different branches. A ladder is one block of
+// memory, the table follows the arms.
+typedef struct
+{
+    size_t arm_count;
+    size_t threshold_count;     // 0 if the arms test different variables
+    int cond_var_id;            // The variable every arm tests, -1 if they test different ones
+    int default_value;          // Assigned when no condition holds
+    LadderArm arms[];
+} Ladder;
+
+// One assignment, a variable ID and its value
+typedef struct
+{
+    int var_id;
+    int value;
+} Assignment;
+
+// The assignments of a block whose branches assign several variables. Every branch assigns
+// the same count variables in the same order (that of the first branch), branch b's are
+// pairs[b * count] to pairs[b * count + count - 1]. Branches are numbered as in a Ladder, for
+// a single if-else branch 0 is the true branch and branch 1 the else.
+typedef struct
+{
+    size_t count;
+    size_t branch_count;
+    Assignment pairs[];
+} BranchAssignments;
+
+// A compound condition, "(a < 1 && !(b == 2 || c > 3))", compiled into a program for a
+// register machine. The registers hold the values of the variables it tests, register r
+// that of condition_variables()[r]. Each comparison is one CondOp, in input order: it
+// compares a register with its constant and jumps to target if that holds, else goes on with
+// the next op. &&, || and ! are folded into the jumps, so evaluation stops at the first
+// comparison that decides the result, as in Verilog, and always ends at one of the last two
+// ops, COND_TRUE and COND_FALSE. The condition itself is kept as well, its terms in postfix
+// order (condition_terms()). A Condition is one block of memory, the variables and terms
+// follow the ops.
+#define COND_TRUE 6
+#define COND_FALSE 7
+
+typedef struct
+{
+    uint8_t op;         // A comparator (EQ ... GE), COND_TRUE or COND_FALSE
+    uint8_t reg;
+    uint16_t target;
+    int value;
+} CondOp;
+
+// Term kinds of a Condition
+#define COND_COMPARE 0
+#define COND_AND 1
+#define COND_OR 2
+#define COND_NOT 3
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t comparator; // COND_COMPARE
+    int var_id;         // COND_COMPARE
+    int value;          // COND_COMPARE
+} CondTerm;
+
+typedef struct
+{
+    uint16_t op_count;
+    uint16_t reg_count;
+    uint32_t term_count;
+    CondOp ops[];
+} Condition;
+
+// Node kinds of an Ast
+#define AST_IF 0
+#define AST_ASSIGN 1
+
+// One statement of an Ast, a condition or an assignment
+typedef struct
+{
+    uint8_t kind;
+    uint8_t comparator; // AST_IF, COMPOUND for a Condition
+    int var_id;         // AST_IF: the variable tested (-1 for a Condition over several),
+                        // AST_ASSIGN: the variable assigned
+    int value;          // AST_IF: valC, or the Condition's offset, AST_ASSIGN: the constant
+    uint32_t slot;      // AST_ASSIGN: position of var_id in ast_variables()
+    uint32_t jump;      // AST_IF: first node of the else branch, AST_ASSIGN: the node run next
+    uint32_t end;       // One past the last node of the statement
+} AstNode;
+
+// A block with nested if-else statements or compound conditions, its tree laid out depth
+// first: an AST_IF is
+// followed by the nodes of its true branch, then from jump on by those of its else branch,
+// which for an else-if starts with the next arm's AST_IF. Every jump points forward, so an
+// evaluation is one pass over the array that skips the branches not taken and stops at
+// node_count. Every path assigns the same var_count variables, listed by ast_variables().
+// The Conditions of compound AST_IFs follow the variables, ast_condition() finds them.
+typedef struct
+{
+    size_t node_count;
+    size_t var_count;
+    size_t condition_size;  // Bytes of the Conditions
+    int cond_var_id;        // The variable every condition tests, -1 if they test several
+    AstNode nodes[];
+} Ast;
+
+// Result of one parsed if-else block
+typedef struct
+{
+    size_t index;       // Position of the block in the input, counting from 0
+    bool parsing_done;  // The block was parsed completely
+    bool error_flag;
+    int error_code;
+    size_t error_offset;        // Input offset of the byte that raised the error
+    size_t start_offset;        // The block is the input bytes [start_offset, end_offset). In
+    size_t end_offset;          // recovery mode, skipped bytes belong to no block
+
+    int cond_var_id;            // IDs in the parser's symbol table, -1 if not parsed
+    const char *cond_var;       // Name of the ID, valid as long as the parser
+    int comparator;
+    int valC;
+    int assignment_var_id;
+    const char *assignment_var;
+    int const1;
+    int const2;
+
+    // Else-if ladder, NULL for a single if-else. The fields above then describe its first
+    // arm, and const2 is the final else.
+    const Ladder *ladder;
+
+    // Assignments of every branch, NULL when each branch assigns one variable. The fields
+    // above then hold the first variable. Like the ladder valid as long as the parser, as is
+    // the symbol table that names the IDs in both.
+    const BranchAssignments *branches;
+
+    // Nested if-else statements or compound conditions, NULL when there are none. ladder and
+    // branches are then NULL, the fields above describe the outermost condition and the first
+    // variable, and const1 and const2 are 0; a compound outermost condition has comparator
+    // COMPOUND and valC 0. Valid until parser_reset or parser_cleanup.
+    const Ast *ast;
+    const SymbolTable *symbols;
+} BlockResult;
+
+typedef struct
+{
+    int state;
+
+    // Keyword parsing
+    char keyword_buffer[32];
+    int keyword_index;
+    bool keyword_complete;
+
+    // Identifiers as symbol IDs, -1 until read
+    int cond_var_id;
+    int assignment_var_id;
+    int assignment_var2_id;
+
+    // Identifier being read, grows as needed so names have no length limit
+    char *name_buffer;
+    size_t name_length;
+    size_t name_capacity;
+
+    // Created on the first identifier and kept for the parser's lifetime
+    SymbolTable *symbols;
+
+    // Else-if ladder: the arms before the one being read, and once the block is parsed, the
+    // whole ladder
+    LadderArm *arms;
+    size_t arm_count;
+    size_t arm_capacity;
+    const Ladder *ladder;
+
+    // Assignments of the block, a pair pushed at every ';'. The first branch sets the
+    // variables and their order; each later branch fills the next branch_size pairs in that
+    // order, so a variable the first branch lacks, or one left out, is a mismatch.
+    Assignment *assignments;
+    size_t assignment_count;
+    size_t assignment_capacity;
+    size_t branch_index;        // Branch being read
+    size_t branch_size;         // Variables of the first branch, once it is closed
+    size_t branch_filled;       // Variables of the branch being read assigned so far
+    bool in_else_branch;
+    bool var_mismatch;
+    int *var_slots;             // By variable ID: 1 + its position in the first branch, or 0,
+                                // set only for blocks with many variables
+    size_t var_slot_count;
+    const BranchAssignments *branches; // Set once the block is parsed, if it has several variables
+
+    // Nesting: an if inside a begin ... end saves the state of the enclosing block in a frame
+    // and is read by the same states, its final end restores it. Frames and their buffers are
+    // kept for the next block as deep.
+    NestFrame *frames;
+    size_t depth;
+    size_t frame_capacity;
+    bool nested;                // The block has nested if-else statements or compound conditions
+
+    // Every block is also read into an Ast in the arena, kept only if it has nested
+    // statements. The arena is emptied by parser_reset and parser_cleanup.
+    AstArena *arena;
+    size_t ast_if;              // Node of the arm being read
+    size_t ast_first_if;        // Node of the first arm at this depth
+    const Ast *ast;             // Set once a block with nested statements is parsed
+
+    // Compound condition being read: its terms in postfix order so far, and the operators and
+    // open parentheses still waiting for their operands. Its closing parenthesis compiles it
+    // into cond_code, the Conditions of the block, and leaves comparator COMPOUND and valC
+    // the offset of its Condition.
+    bool compound;
+    CondTerm *cond_terms;
+    size_t cond_term_count;
+    size_t cond_term_capacity;
+    uint8_t *cond_stack;
+    size_t cond_stack_count;
+    size_t cond_stack_capacity;
+    unsigned char *cond_code;
+    size_t cond_code_size;
+    size_t cond_code_capacity;
+
+    // Ladders and assignment vectors, interned by their bytes like names, so equal ones
+    // share one copy and stay valid for the parser's lifetime
+    SymbolTable *interned;
+
+    bool var_match;
+    bool reading_var;
+
+    // Data registers
+    int x;    // Input value
+    int valC; // Comparison value
+    bool is_valC_negative;
+    int const1; 
+    bool is_const1_negative;
+    int const2; 
+    bool is_const2_negative;
+    int64_t num_buffer;     // Magnitude of the literal being read, up to INT_MAX + 1
+    bool parsing_number;
+
+    int paren_count;
+
+    bool blocking_assignment1;
+    bool blocking_assignment2;
+
+    int comparator;
+    char op_first;
+
+    // Result value
+    int p;
+
+    // Status flags
+    bool parsing_done;
+    bool error_flag;
+    int error_code;
+
+    // Position, as a byte offset from the start of the input. parse_buffer keeps it up to
+    // date; lines and columns are only worked out when an error is reported (LineCursor).
+    size_t offset;
+    size_t error_offset;   // Byte that raised error_flag
+    size_t block_start;    // Where parser_feed started the current block
+
+    // Error recovery in parser_feed
+    bool recover;
+    bool resyncing;        // Skipping input after an error, up to the next "if"
+    int resync_held;       // The last bytes skipped may start an "if": 1 for an 'i', 2 for "if"
+    char resync_prev;      // Byte before the next one to be skipped
+
+    // for debugging
+    bool debug_mode;
+
+    // ENGINE_SWITCH or ENGINE_TABLE, debug mode always uses the switch
+    int engine;
+
+    // Results of blocks parsed by earlier runs, NULL for none. Not owned by the parser.
+    BlockCache *cache;
+
+    // Completed blocks waiting for parser_poll, a ring buffer filled by parser_feed
+    BlockResult *blocks;
+    size_t block_head;
+    size_t block_count;
+    size_t block_capacity;
+    size_t next_block_index;
+} Parser;
+
+// Parser setup. parser_init prepares a new Parser, parser_create allocates one.
+// parser_reset clears all parsing state and queued blocks but keeps the configuration and
+// the interned names. parser_restart does the same and then continues at a block boundary
+// of an earlier run, the offset and index of a block's start, so an edited input can be
+// parsed again from there. Only parser_reset empties the Ast arena, so the Asts of blocks
+// kept from an earlier run stay valid across parser_restart. parser_cleanup frees the memory
+// of a parser set up with parser_init.
+void parser_init(Parser *parser);
+void parser_reset_block(Parser *parser);
+void parser_reset(Parser *parser);
+void parser_restart(Parser *parser, size_t offset, size_t block_index);
+void parser_cleanup(Parser *parser);
+Parser *parser_create(void);
+void parser_destroy(Parser *parser);
+
+// Symbol table. symbol_intern returns the ID of the name, adding it if it is new, or -1 if
+// memory ran out. symbol_name returns "" for an unknown ID.
+SymbolTable *symbol_table_create(void);
+void symbol_table_destroy(SymbolTable *table);
+int symbol_intern(SymbolTable *table, const char *name, size_t length);
+const char *symbol_name(const SymbolTable *table, int id);
+size_t symbol_count(const SymbolTable *table);
+
+// Low level parsing, one char or one buffer at a time. parse_buffer stops at the end of the
+// current block or at an error and returns the number of bytes consumed. The final "end" of
+// a block is only complete once the byte after it is known not to continue a name, that
+// byte is not consumed; parse_buffer_end completes it at the end of the input.
+void process_char(Parser *parser, char ascii_char);
+size_t parse_buffer(Parser *parser, const char *buf, size_t len);
+size_t parse_buffer_table(Parser *parser, const char *buf, size_t len);
+void parse_buffer_end(Parser *parser);
+
+// Chunk-fed parsing. parser_feed accepts input split at any byte boundary and queues every
+// completed block. It returns fewer than len bytes only when parsing stopped at an error
+// (or the block queue could not grow), call parser_reset to start over.
+// With recover set, an error is queued like any other block and parsing resumes at the next
+// plausible "if" (starting a word, followed by whitespace or '('), skipping the bytes between.
+// parser_finish marks the end of the input and queues a block cut off by it.
+// parser_poll takes the oldest queued block, returns false if there is none.
+size_t parser_feed(Parser *parser, const char *buf, size_t len);
+void parser_finish(Parser *parser);
+bool parser_poll(Parser *parser, BlockResult *block);
+void parser_block_result(const Parser *parser, BlockResult *block);
+
+// Evaluation, free of I/O
+bool var_names_match(Parser *parser);
+bool evaluate_condition(const Parser *parser, int input_value);
+int evaluate_block(const BlockResult *block, int x);
+void evaluate_batch(const BlockResult *block, const int *xs, int *out, size_t n);
+
+// Else-if ladders. ladder_branch is a binary search of the threshold table; a ladder over
+// several variables has none and is walked arm by arm with x as the value of each of them.
+// ladder_branch_arms walks the arms with values[i] as the value of arms[i].cond_var_id.
+// ladder_evaluate and ladder_evaluate_arms return the branch's value instead.
+size_t ladder_branch(const Ladder *ladder, int x);
+size_t ladder_branch_arms(const Ladder *ladder, const int *values);
+int ladder_evaluate(const Ladder *ladder, int x);
+int ladder_evaluate_arms(const Ladder *ladder, const int *values);
+const int *ladder_thresholds(const Ladder *ladder);
+const int *ladder_branches(const Ladder *ladder);
+
+// Assignments. evaluate_block and evaluate_batch give the value of the first assigned
+// variable; a block assigns block_assignment_count() of them. evaluate_assignments writes
+// all the pairs made for x to out and returns their count, branch_assignments does the same
+// for a branch picked by the caller. block_branch is the branch taken for x. A nested block
+// has no branch numbers, evaluate_assignments walks its Ast with x for every condition.
+size_t block_assignment_count(const BlockResult *block);
+size_t block_branch(const BlockResult *block, int x);
+size_t branch_assignments(const BlockResult *block, size_t branch, Assignment *out);
+size_t evaluate_assignments(const BlockResult *block, int x, Assignment *out);
+
+// Nested blocks. ast_evaluate gives every condition the value x, ast_evaluate_vars takes the
+// value of each variable from values[], indexed by variable ID. Both write the value of
+// ast_variables()[i] to out[i].
+void ast_evaluate(const Ast *ast, int x, int *out);
+void ast_evaluate_vars(const Ast *ast, const int *values, int *out);
+const int *ast_variables(const Ast *ast);
+const Condition *ast_condition(const Ast *ast, const AstNode *node);
+
+// Compound conditions. condition_evaluate gives every variable the value x,
+// condition_evaluate_vars takes the value of each variable from values[], indexed by ID.
+bool condition_evaluate(const Condition *cond, int x);
+bool condition_evaluate_vars(const Condition *cond, const int *values);
+const int *condition_variables(const Condition *cond);
+const CondTerm *condition_terms(const Condition *cond);
+
+// Line and column (both from 1, columns in bytes) of input offsets. The cursor only moves
+// forward: line_cursor_advance counts the newlines between its position and offset in the
+// bytes [data_offset, data_offset + len), so locating every error of a file costs at most one
+// pass over the input. Bytes dropped without being passed through the cursor are not counted.
+typedef struct
+{
+    size_t offset;      // Bytes counted so far
+    size_t line;        // Line of the byte at offset
+    size_t line_start;  // Offset of the first byte of that line
+} LineCursor;
+
+void line_cursor_init(LineCursor *cursor);
+void line_cursor_advance(LineCursor *cursor, const char *data, size_t data_offset, size_t len, size_t offset);
+size_t line_cursor_column(const LineCursor *cursor, size_t offset);
+
+// Persistent block cache, shared by the threads and processes that open the same file.
+// block_cache_open creates or replaces the file if it is missing or from another format
+// version (max_bytes bounds the size of a new file, an existing one keeps its size) and
+// returns NULL if it cannot be used. With parser->cache set, parse_buffer looks up every
+// block that starts at a block boundary and stores the ones it parses; block_cache_key,
+// block_cache_lookup and block_cache_store are that path. Stores are queued and written in
+// batches, block_cache_flush writes the queue now and block_cache_close flushes and unmaps.
+typedef struct
+{
+    uint64_t hash;
+    uint64_t check;   // Second, independent hash of the same bytes, confirms a hit
+    size_t len;       // Bytes hashed, from the block's first byte
+} CacheKey;
+
+BlockCache *block_cache_open(const char *path, size_t max_bytes);
+bool block_cache_flush(BlockCache *cache);
+void block_cache_close(BlockCache *cache);
+bool block_cache_key(const char *buf, size_t len, CacheKey *key);
+size_t block_cache_lookup(BlockCache *cache, const CacheKey *key, Parser *parser);
+void block_cache_store(BlockCache *cache, const CacheKey *key, size_t used, const Parser *parser);
+
+// Rule store: the evaluation fields of many parsed blocks in struct-of-arrays form, and a
+// binary file holding exactly those arrays. rule_store_open maps the file and points the
+// arrays into the mapping, so a store of any size is ready without reading it. Names are
+// interned once per store; name IDs index name_offsets into names. The arrays are in the
+// byte order of the machine that wrote the file, and a file from another version or byte
+// order is refused.
+// A RuleStoreBuilder collects parsed single if-else blocks with one assignment per branch
+// from any number of parsers and writes the file; rule_store_builder_skipped counts the parsed
+// blocks it had to leave out. rule_store_evaluate_all evaluates every rule for one x.
+typedef struct
+{
+    size_t count;                   // Rules
+    const int32_t *valC;
+    const int32_t *const1;
+    const int32_t *const2;
+    const int32_t *cond_var;        // Name IDs
+    const int32_t *assignment_var;
+    const uint8_t *cmp_mask;        // CMP_*_BIT
+    size_t name_count;
+    const uint32_t *name_offsets;
+    const char *names;              // NUL-terminated names, names_size bytes
+    size_t names_size;
+
+    void *map;
+    size_t map_size;
+} RuleStore;
+
+typedef struct RuleStoreBuilder RuleStoreBuilder;
+
+RuleStoreBuilder *rule_store_builder_create(void);
+bool rule_store_builder_add(RuleStoreBuilder *builder, const BlockResult *block);
+size_t rule_store_builder_count(const RuleStoreBuilder *builder);
+size_t rule_store_builder_skipped(const RuleStoreBuilder *builder);
+bool rule_store_write(const RuleStoreBuilder *builder, const char *path);
+void rule_store_builder_destroy(RuleStoreBuilder *builder);
+
+RuleStore *rule_store_open(const char *path);
+void rule_store_close(RuleStore *store);
+const char *rule_store_name(const RuleStore *store, int32_t id);
+int rule_store_comparator(const RuleStore *store, size_t rule);
+int rule_store_evaluate(const RuleStore *store, size_t rule, int x);
+void rule_store_evaluate_all(const RuleStore *store, int x, int *out);
+
+// Helpers
+const char *skip_whitespace(const char *p, const char *end);
+const char *comparator_str(int comparator);
+const char *error_message(int error_code);
+void debug_print(Parser *parser, char ascii_char);
+
+#endif
@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "carser.h"
+
+// Benchmark harness for libcarser
+//
+// Generates a seeded synthetic corpus of if-else blocks, parses it and reports throughput
+// and per-block latency percentiles as one JSON object, so results can be stored and
+// compared between versions (-c).
+
+#define MAX_IDENT_LEN 64
+
+typedef struct
+{
+    uint64_t seed;
+    size_t blocks;
+    int max_ident_len;     // Up to MAX_IDENT_LEN
+    double negative_rate;  // Fraction of constants that are negative
+    int ws_density;        // Average number of whitespace chars between tokens
+    double error_rate;     // Fraction of blocks with an injected syntax error
+    int repeats;           // Throughput passes over the corpus
+    int engine;
+} BenchConfig;
+
+typedef struct
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+    size_t *block_start;   // Offset of every block, plus one past the end
+    size_t blocks;
+} Corpus;
+
+static uint64_t rng_state;
+
+// xorshift64*, good enough for corpus generation and stable across platforms
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+static int rng_range(int lo, int hi)
+{
+    return lo + (int)(rng_next() % (uint64_t)(hi - lo + 1));
+}
+
+static bool rng_chance(double p)
+{
+    return (double)(rng_next() >> 11) / 9007199254740992.0 < p;
+}
+
+static void corpus_put(Corpus *corpus, const char *s, size_t len)
+{
+    if (corpus->size + len > corpus->capacity)
+    {
+        size_t capacity = corpus->capacity ? corpus->capacity : 1 << 16;
+        while (capacity < corpus->size + len)
+            capacity *= 2;
+
+        corpus->data = realloc(corpus->data, capacity);
+        if (corpus->data == NULL)
+        {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            exit(1);
+        }
+        corpus->capacity = capacity;
+    }
+
+    memcpy(corpus->data + corpus->size, s, len);
+    corpus->size += len;
+}
+
+static void corpus_puts(Corpus *corpus, const char *s)
+{
+    corpus_put(corpus, s, strlen(s));
+}
+
+// Optional whitespace between tokens, averaging ws_density chars
+static void put_ws(Corpus *corpus, const BenchConfig *config, int min)
+{
+    static const char ws_chars[] = "  \t\n";
+    int count = min + (config->ws_density > 0 ? rng_range(0, 2 * config->ws_density) : 0);
+
+    for (int i = 0; i < count; i++)
+        corpus_put(corpus, &ws_chars[rng_range(0, 3)], 1);
+}
+
+static void random_ident(char *out, int max_len)
+{
+    static const char first[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char rest[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+    int len = rng_range(1, max_len);
+
+    out[0] = first[rng_range(0, (int)sizeof(first) - 2)];
+    for (int i = 1; i < len; i++)
+        out[i] = rest[rng_range(0, (int)sizeof(rest) - 2)];
+    out[len] = '\0';
+
+    // "if" opens a nested block, keep the rng stream as is and just respell it
+    if (strcmp(out, "if") == 0)
+        out[1] = 'F';
+}
+
+static int random_const(const BenchConfig *config)
+{
+    int value = rng_range(0, 100000);
+    return rng_chance(config->negative_rate) ? -value : value;
+}
+
+// Append one block. The grammar only takes a negative valC after a two-char comparator,
+// so "<" and ">" always get a non-negative one.
+static void generate_block(Corpus *corpus, const BenchConfig *config)
+{
+    static const char *comparators[] = {"==", "!=", "<", ">", "<=", ">="};
+    static const char *keywords[] = {"bgin", "ed", "els", "fi"};
+    char cond_var[MAX_IDENT_LEN + 1], assign_var[MAX_IDENT_LEN + 1], assign_var2[MAX_IDENT_LEN + 2], text[64];
+    int comparator = rng_range(0, 5);
+    int valC = random_const(config);
+    int error_kind = rng_chance(config->error_rate) ? rng_range(1, 4) : 0;
+    bool parens = rng_chance(0.5);
+
+    if (comparator == LT || comparator == GT)
+        valC = valC < 0 ? -valC : valC;
+
+    random_ident(cond_var, config->max_ident_len);
+    random_ident(assign_var, config->max_ident_len);
+    strcpy(assign_var2, assign_var);
+    if (error_kind == 1)
+        strcat(assign_var2, "x"); // Variable mismatch
+
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, "if");
+    put_ws(corpus, config, 0);
+    corpus_puts(corpus, parens ? "((" : "(");
+    put_ws(corpus, config, 0);
+    corpus_puts(corpus, cond_var);
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, comparators[comparator]);
+    put_ws(corpus, config, 1);
+    snprintf(text, sizeof(text), "%d", valC);
+    corpus_puts(corpus, text);
+    put_ws(corpus, config, 0);
+    corpus_puts(corpus, error_kind == 2 ? ")))" : parens ? "))" : ")"); // Extra ')'
+
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, error_kind == 3 ? keywords[rng_range(0, 3)] : "begin");
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, assign_var);
+    put_ws(corpus, config, 1);
+    snprintf(text, sizeof(text), "<= %d%s", random_const(config), error_kind == 4 ? "" : ";"); // Missing ';'
+    corpus_puts(corpus, text);
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, "end");
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, "else");
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, "begin");
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, assign_var2);
+    put_ws(corpus, config, 1);
+    snprintf(text, sizeof(text), "<= %d;", random_const(config));
+    corpus_puts(corpus, text);
+    put_ws(corpus, config, 1);
+    corpus_puts(corpus, "end");
+}
+
+static void generate_corpus(Corpus *corpus, const BenchConfig *config)
+{
+    rng_state = config->seed ? config->seed : 1;
+    corpus->block_start = malloc((config->blocks + 1) * sizeof(size_t));
+    if (corpus->block_start == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        exit(1);
+    }
+
+    for (size_t i = 0; i < config->blocks; i++)
+    {
+        corpus->block_start[i] = corpus->size;
+        generate_block(corpus, config);
+    }
+    corpus->block_start[config->blocks] = corpus->size;
+    corpus->blocks = config->blocks;
+    corpus_puts(corpus, "\n");
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t n, double p)
+{
+    size_t idx = (size_t)(p * (double)(n - 1) + 0.5);
+    return sorted[idx < n ? idx : n - 1];
+}
+
+// Parse the whole corpus through parser_feed. After an error the parser is reset and fed
+// again from the start of the next block. Returns the number of blocks seen.
+static size_t throughput_pass(Parser *parser, const Corpus *corpus, size_t *errors)
+{
+    size_t pos = 0;
+    size_t next_block = 0;
+    size_t blocks = 0;
+    BlockResult block;
+
+    parser_reset(parser);
+    while (pos < corpus->size)
+    {
+        size_t used = parser_feed(parser, corpus->data + pos, corpus->size - pos);
+
+        pos += used;
+        while (parser_poll(parser, &block))
+        {
+            blocks++;
+            if (!block.parsing_done)
+                (*errors)++;
+        }
+        if (pos == corpus->size)
+            break;
+
+        // Resynchronize at the next block boundary after the error
+        while (next_block < corpus->blocks && corpus->block_start[next_block] < pos)
+            next_block++;
+        parser_reset(parser);
+        pos = next_block < corpus->blocks ? corpus->block_start[next_block] : corpus->size;
+    }
+
+    parser_finish(parser);
+    while (parser_poll(parser, &block))
+        blocks++;
+
+    return blocks;
+}
+
+// Read a numeric field from a JSON result written by an earlier run
+static bool json_number(const char *json, const char *key, double *value)
+{
+    char pattern[64];
+    const char *p;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    p = strstr(json, pattern);
+    if (p == NULL)
+        return false;
+
+    *value = strtod(p + strlen(pattern), NULL);
+    return true;
+}
+
+static char *read_file(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    char *data;
+    long size;
+
+    if (fp == NULL)
+        return NULL;
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    data = malloc((size_t)size + 1);
+    if (data != NULL)
+    {
+        size_t n = fread(data, 1, (size_t)size, fp);
+        data[n] = '\0';
+    }
+
+    fclose(fp);
+    return data;
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [options]\n", prog);
+    printf("  -n <blocks>     number of blocks in the corpus (default 100000)\n");
+    printf("  -s <seed>       corpus seed (default 1)\n");
+    printf("  -l <len>        maximum identifier length, 1-%d (default 15)\n", MAX_IDENT_LEN);
+    printf("  -N <rate>       fraction of negative constants (default 0.25)\n");
+    printf("  -w <density>    average whitespace chars between tokens (default 4)\n");
+    printf("  -E <rate>       fraction of blocks with an injected error (default 0)\n");
+    printf("  -r <repeats>    throughput passes (default 5)\n");
+    printf("  -e <engine>     switch or table (default table)\n");
+    printf("  -o <file>       also write the corpus to <file>\n");
+    printf("  -c <file>       compare against an earlier JSON result, fail on a regression\n");
+    printf("  -t <fraction>   allowed throughput drop for -c (default 0.05)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    BenchConfig config = {1, 100000, 15, 0.25, 4, 0.0, 5, ENGINE_TABLE};
+    const char *corpus_path = NULL;
+    const char *baseline_path = NULL;
+    double tolerance = 0.05;
+    Corpus corpus = {NULL, 0, 0, NULL, 0};
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (value == NULL || arg[0] != '-' || arg[1] == '\0' || arg[2] != '\0')
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        switch (arg[1])
+        {
+        case 'n': config.blocks = strtoull(value, NULL, 10); break;
+        case 's': config.seed = strtoull(value, NULL, 10); break;
+        case 'l': config.max_ident_len = atoi(value); break;
+        case 'N': config.negative_rate = atof(value); break;
+        case 'w': config.ws_density = atoi(value); break;
+        case 'E': config.error_rate = atof(value); break;
+        case 'r': config.repeats = atoi(value); break;
+        case 'e': config.engine = strcmp(value, "switch") == 0 ? ENGINE_SWITCH : ENGINE_TABLE; break;
+        case 'o': corpus_path = value; break;
+        case 'c': baseline_path = value; break;
+        case 't': tolerance = atof(value); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (config.max_ident_len < 1 || config.max_ident_len > MAX_IDENT_LEN || config.blocks == 0 || config.repeats < 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    generate_corpus(&corpus, &config);
+
+    if (corpus_path != NULL)
+    {
+        FILE *fp = fopen(corpus_path, "wb");
+        if (fp == NULL || fwrite(corpus.data, 1, corpus.size, fp) != corpus.size)
+        {
+            fprintf(stderr, "Error: Could not write %s\n", corpus_path);
+            return 1;
+        }
+        fclose(fp);
+    }
+
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 1;
+    }
+    parser->engine = config.engine;
+
+    // Throughput, best of the repeats
+    size_t blocks = 0;
+    size_t errors = 0;
+    double best = 0.0;
+    for (int r = 0; r < config.repeats; r++)
+    {
+        size_t pass_errors = 0;
+        double start = now_seconds();
+
+        blocks = throughput_pass(parser, &corpus, &pass_errors);
+        double elapsed = now_seconds() - start;
+        if (r == 0 || elapsed < best)
+            best = elapsed;
+        errors = pass_errors;
+    }
+
+    // Per-block latency, every block parsed on its own
+    double *latency = malloc(corpus.blocks * sizeof(double));
+    if (latency == NULL)
+    {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < corpus.blocks; i++)
+    {
+        const char *start = corpus.data + corpus.block_start[i];
+        size_t len = corpus.block_start[i + 1] - corpus.block_start[i];
+
+        parser_reset_block(parser);
+        double t0 = now_seconds();
+        parse_buffer(parser, start, len);
+        latency[i] = (now_seconds() - t0) * 1e9;
+    }
+    qsort(latency, corpus.blocks, sizeof(double), compare_doubles);
+
+    double mb_per_s = (double)corpus.size / best / 1e6;
+    double blocks_per_s = (double)blocks / best;
+
+    printf("{\"engine\":\"%s\",\"seed\":%llu,\"blocks\":%zu,\"bytes\":%zu,\"max_ident_len\":%d,"
+           "\"negative_rate\":%.3f,\"ws_density\":%d,\"error_rate\":%.3f,\"parse_errors\":%zu,"
+           "\"seconds\":%.6f,\"mb_per_s\":%.2f,\"blocks_per_s\":%.0f,"
+           "\"latency_ns\":{\"p50\":%.0f,\"p90\":%.0f,\"p99\":%.0f,\"p999\":%.0f,\"max\":%.0f}}\n",
+           config.engine == ENGINE_SWITCH ? "switch" : "table", (unsigned long long)config.seed,
+           corpus.blocks, corpus.size, config.max_ident_len, config.negative_rate, config.ws_density,
+           config.error_rate, errors, best, mb_per_s, blocks_per_s,
+           percentile(latency, corpus.blocks, 0.50), percentile(latency, corpus.blocks, 0.90),
+           percentile(latency, corpus.blocks, 0.99), percentile(latency, corpus.blocks, 0.999),
+           latency[corpus.blocks - 1]);
+
+    int status = 0;
+    if (baseline_path != NULL)
+    {
+        char *baseline = read_file(baseline_path);
+        double baseline_mb_per_s;
+
+        if (baseline == NULL || !json_number(baseline, "mb_per_s", &baseline_mb_per_s))
+        {
+            fprintf(stderr, "Error: Could not read a result from %s\n", baseline_path);
+            status = 1;
+        }
+        else if (mb_per_s < baseline_mb_per_s * (1.0 - tolerance))
+        {
+            fprintf(stderr, "Regression: %.2f MB/s against %.2f MB/s in %s\n",
+                    mb_per_s, baseline_mb_per_s, baseline_path);
+            status = 2;
+        }
+        free(baseline);
+    }
+
+    free(latency);
+    parser_destroy(parser);
+    free(corpus.data);
+    free(corpus.block_start);
+    return status;
+}
@@ -0,0 +1,469 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "carser.h"
+
+// Persistent block cache
+//
+// The cache file maps the hash of a block's source bytes to its parse result. It holds a
+// header and a fixed number of buckets of CACHE_WAYS slots: a key may sit in any slot of its
+// bucket, and a full bucket evicts the slot that was used the longest ago, counted in runs
+// (the header's generation, bumped by every process that opens the file). A bucket starts
+// with the hashes of its slots in one cache line, so a lookup reads that line and the one
+// slot that matches. The file never grows, its size is the bound set when it was created.
+// The key bytes are not stored; a slot also holds a second, independent 64-bit hash of them,
+// and a hit needs both hashes and the length to match, so a block only gets another block's
+// result if both hashes collide at once.
+//
+// Every process maps the file shared. Lookups take no lock: a writer makes a slot's sequence
+// count odd while it rewrites the slot, and a reader that sees an odd or changed count takes
+// the slot as a miss. Inserts are queued in the process and written in batches under flock,
+// which orders writers across processes (the queue mutex orders the threads of one process).
+//
+// A file whose header does not match this build is replaced by a fresh one renamed over it,
+// so a process still using the old file keeps a valid mapping. Bump CACHE_FORMAT_VERSION
+// whenever the slot layout or the meaning of a parse result changes.
+#define CACHE_FORMAT_VERSION 7
+#define CACHE_WAYS 8
+#define CACHE_MAX_KEY 65536      // Longest block, in bytes, that is looked up or stored
+#define CACHE_PENDING 256        // Inserts queued before they are written
+
+// Slot flags
+#define CACHE_DONE 1
+#define CACHE_ERROR 2
+#define CACHE_COND_VAR 4         // The names hold the condition variable
+#define CACHE_ASSIGNMENT_VAR 8   // and then the assignment variable
+
+static const char cache_magic[8] = {'C', 'A', 'R', 'S', 'E', 'R', 'B', 'C'};
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_size;          // sizeof(CacheSlot) of the build that created the file
+    uint64_t slot_count;         // CACHE_WAYS per bucket
+    uint32_t generation;
+    uint32_t reserved[9];
+} CacheHeader;
+
+typedef struct
+{
+    uint32_t seq;                // Odd while a writer updates the slot
+    uint32_t used;               // Generation of the last hit or insert
+    uint64_t hash;               // 0 for an empty slot
+    uint64_t check;              // Second hash of the same bytes
+    uint32_t key_len;            // Bytes hashed
+    uint32_t consumed;           // Bytes the parser consumed, at most key_len
+    int32_t comparator;
+    int32_t valC;
+    int32_t const1;
+    int32_t const2;
+    int16_t error_code;
+    uint8_t flags;
+    uint8_t cond_len;
+    uint8_t assignment_len;
+    char names[75];              // Both variable names, unterminated; longer pairs are not cached
+} CacheSlot;
+
+typedef struct
+{
+    uint64_t tags[CACHE_WAYS];   // Hash of each slot, only a hint: the slot's own hash decides
+    CacheSlot slots[CACHE_WAYS];
+} CacheBucket;
+
+_Static_assert(sizeof(CacheHeader) == 64, "cache header layout");
+_Static_assert(sizeof(CacheSlot) == 128, "cache slot layout");
+_Static_assert(sizeof(CacheBucket) == 64 + CACHE_WAYS * 128, "cache bucket layout");
+
+struct BlockCache
+{
+    int fd;
+    CacheHeader *header;
+    CacheBucket *buckets;
+    size_t map_size;
+    uint64_t bucket_count;
+    uint32_t generation;
+
+    pthread_mutex_t lock;        // Guards the pending inserts
+    CacheSlot pending[CACHE_PENDING];
+    size_t pending_count;
+};
+
+static uint64_t rotl64(uint64_t v, int n)
+{
+    return (v << n) | (v >> (64 - n));
+}
+
+// Two 64-bit hashes of the key bytes in one pass, 8 at a time, with unrelated seeds,
+// multipliers and mixing. key->hash picks the bucket and is never 0, which marks an empty
+// slot; key->check confirms a hit.
+static void cache_hash(const char *p, size_t len, CacheKey *key)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (len * 0xc2b2ae3d27d4eb4fULL);
+    uint64_t c = 0x243f6a8885a308d3ULL + len;
+    uint64_t word;
+
+    for (; len >= 8; p += 8, len -= 8)
+    {
+        memcpy(&word, p, 8);
+        h = (h ^ word) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 29;
+        c = rotl64(c + word * 0x87c37b91114253d5ULL, 31) * 0x4cf5ad432745937fULL;
+    }
+    word = 0;
+    memcpy(&word, p, len);
+    h = (h ^ word) * 0xff51afd7ed558ccdULL;
+    c = rotl64(c + word * 0x87c37b91114253d5ULL, 31) * 0x4cf5ad432745937fULL;
+
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    c ^= c >> 31;
+    c *= 0x94d049bb133111ebULL;
+    c ^= c >> 32;
+    key->hash = h != 0 ? h : 1;
+    key->check = c;
+}
+
+static bool is_name_byte(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// A block is keyed on its bytes up to and including the 'd' of the second word "end". A
+// well-formed block ends exactly there and a block with an error usually ends before it; a
+// block the parser reads past its key is not stored. The byte after the 'd' decides whether
+// it is the keyword, so it has to be in the buffer, and it is not part of the key.
+bool block_cache_key(const char *buf, size_t len, CacheKey *key)
+{
+    int ends = 0;
+
+    if (len > CACHE_MAX_KEY + 1)
+        len = CACHE_MAX_KEY + 1;
+
+    for (size_t i = 0; i + 4 <= len; )
+    {
+        const char *hit = memchr(buf + i, 'e', len - 3 - i);
+        size_t k;
+
+        if (hit == NULL)
+            break;
+        k = (size_t)(hit - buf);
+        if (hit[1] == 'n' && hit[2] == 'd' && (k == 0 || !is_name_byte(buf[k - 1])) && !is_name_byte(hit[3]) &&
+            ++ends == 2)
+        {
+            key->len = k + 3;
+            cache_hash(buf, key->len, key);
+            return true;
+        }
+        i = k + 1;
+    }
+    return false;
+}
+
+// Check the header and map the file, NULL if the file is not a cache of this build
+static BlockCache *cache_map(int fd)
+{
+    CacheHeader header;
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header))
+        return NULL;
+    if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.version != CACHE_FORMAT_VERSION ||
+        header.slot_size != sizeof(CacheSlot) || header.slot_count < CACHE_WAYS ||
+        header.slot_count % CACHE_WAYS != 0 ||
+        (uint64_t)st.st_size != sizeof(CacheHeader) + header.slot_count / CACHE_WAYS * sizeof(CacheBucket))
+        return NULL;
+
+    BlockCache *cache = malloc(sizeof(BlockCache));
+    if (cache == NULL)
+        return NULL;
+
+    cache->map_size = (size_t)st.st_size;
+    cache->header = mmap(NULL, cache->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (cache->header == MAP_FAILED)
+    {
+        free(cache);
+        return NULL;
+    }
+
+    cache->fd = fd;
+    cache->buckets = (CacheBucket *)(cache->header + 1);
+    cache->bucket_count = header.slot_count / CACHE_WAYS;
+    cache->generation = __atomic_add_fetch(&cache->header->generation, 1, __ATOMIC_RELAXED);
+    cache->pending_count = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+// Write an empty cache of at most max_bytes next to path and rename it over path
+static bool cache_create(const char *path, size_t max_bytes)
+{
+    size_t path_len = strlen(path);
+    char *tmp = malloc(path_len + 8);
+    CacheHeader header;
+    uint64_t buckets = max_bytes / sizeof(CacheBucket) > 0 ? max_bytes / sizeof(CacheBucket) : 1;
+    bool ok;
+
+    if (tmp == NULL)
+        return false;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    header.version = CACHE_FORMAT_VERSION;
+    header.slot_size = sizeof(CacheSlot);
+    header.slot_count = buckets * CACHE_WAYS;
+
+    memcpy(tmp, path, path_len);
+    memcpy(tmp + path_len, ".XXXXXX", 8);
+    int fd = mkstemp(tmp);
+    if (fd < 0)
+    {
+        free(tmp);
+        return false;
+    }
+
+    ok = fchmod(fd, 0644) == 0 &&
+         ftruncate(fd, (off_t)(sizeof(CacheHeader) + buckets * sizeof(CacheBucket))) == 0 &&
+         pwrite(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+         rename(tmp, path) == 0;
+    if (!ok)
+        unlink(tmp);
+    close(fd);
+    free(tmp);
+    return ok;
+}
+
+BlockCache *block_cache_open(const char *path, size_t max_bytes)
+{
+    // Another process may replace the file between the open and the check, try again then
+    for (int attempt = 0; attempt < 4; attempt++)
+    {
+        int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        BlockCache *cache;
+        char magic[sizeof(cache_magic)];
+        struct stat st;
+
+        if (fd < 0)
+            return NULL;
+        cache = cache_map(fd);
+        if (cache != NULL)
+            return cache;
+
+        // Only an empty file or an old cache is replaced, never some other file
+        bool foreign = fstat(fd, &st) != 0 || (st.st_size > 0 &&
+                       (pread(fd, magic, sizeof(magic), 0) != (ssize_t)sizeof(magic) ||
+                        memcmp(magic, cache_magic, sizeof(magic)) != 0));
+        close(fd);
+        if (foreign)
+            return NULL;
+
+        if (!cache_create(path, max_bytes))
+            return NULL;
+    }
+    return NULL;
+}
+
+// Fill the parser's block state from a slot, as if the block had just been parsed
+static bool cache_load(Parser *parser, const CacheSlot *slot)
+{
+    int cond_var_id = -1;
+    int assignment_var_id = -1;
+
+    if (slot->flags & (CACHE_COND_VAR | CACHE_ASSIGNMENT_VAR))
+    {
+        if (parser->symbols == NULL)
+            parser->symbols = symbol_table_create();
+        if (parser->symbols == NULL)
+            return false;
+    }
+    if (slot->flags & CACHE_COND_VAR)
+    {
+        cond_var_id = symbol_intern(parser->symbols, slot->names, slot->cond_len);
+        if (cond_var_id < 0)
+            return false;
+    }
+    if (slot->flags & CACHE_ASSIGNMENT_VAR)
+    {
+        assignment_var_id = symbol_intern(parser->symbols, slot->names + slot->cond_len, slot->assignment_len);
+        if (assignment_var_id < 0)
+            return false;
+    }
+
+    parser->cond_var_id = cond_var_id;
+    parser->assignment_var_id = assignment_var_id;
+    parser->comparator = slot->comparator;
+    parser->valC = slot->valC;
+    parser->const1 = slot->const1;
+    parser->const2 = slot->const2;
+    if (slot->flags & CACHE_DONE)
+    {
+        parser->assignment_var2_id = assignment_var_id;
+        parser->var_match = true;
+        parser->state = EVALUATE;
+        parser->parsing_done = true;
+    }
+    if (slot->flags & CACHE_ERROR)
+    {
+        parser->error_flag = true;
+        parser->error_code = slot->error_code;
+    }
+    return true;
+}
+
+size_t block_cache_lookup(BlockCache *cache, const CacheKey *key, Parser *parser)
+{
+    CacheBucket *bucket = &cache->buckets[key->hash % cache->bucket_count];
+
+    for (int way = 0; way < CACHE_WAYS; way++)
+    {
+        CacheSlot *slot = &bucket->slots[way];
+        CacheSlot copy;
+        uint32_t seq;
+
+        if (__atomic_load_n(&bucket->tags[way], __ATOMIC_RELAXED) != key->hash)
+            continue;
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) != 0)
+            continue;
+
+        memcpy(&copy, slot, sizeof(copy));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq || copy.hash != key->hash ||
+            copy.check != key->check || copy.key_len != key->len)
+            continue;
+
+        if (!cache_load(parser, &copy))
+            return 0;
+        if (copy.used != cache->generation)
+            __atomic_store_n(&slot->used, cache->generation, __ATOMIC_RELAXED);
+        return copy.consumed;
+    }
+    return 0;
+}
+
+// Write one entry into its bucket: over the same key, else into an empty slot, else over
+// the least recently used one. The caller holds the file lock.
+static void cache_write(BlockCache *cache, const CacheSlot *entry)
+{
+    CacheBucket *bucket = &cache->buckets[entry->hash % cache->bucket_count];
+    CacheSlot *victim = NULL;
+
+    for (int way = 0; way < CACHE_WAYS; way++)
+    {
+        CacheSlot *slot = &bucket->slots[way];
+
+        if (slot->hash == entry->hash && slot->check == entry->check && slot->key_len == entry->key_len)
+        {
+            victim = slot;
+            break;
+        }
+        // Ages are generations back from this run, so they survive the counter wrapping
+        if (victim == NULL || (victim->hash != 0 && (slot->hash == 0 ||
+            cache->generation - slot->used > cache->generation - victim->used)))
+            victim = slot;
+    }
+
+    // A writer that died half way leaves the count odd, the slot is simply rewritten
+    uint32_t seq = victim->seq | 1;
+
+    __atomic_store_n(&victim->seq, seq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy((char *)victim + sizeof(victim->seq), (const char *)entry + sizeof(entry->seq),
+           sizeof(CacheSlot) - sizeof(entry->seq));
+    victim->used = cache->generation;
+    __atomic_store_n(&victim->seq, seq + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&bucket->tags[victim - bucket->slots], entry->hash, __ATOMIC_RELAXED);
+}
+
+// Write the pending inserts, the caller holds the queue mutex
+static bool cache_flush_locked(BlockCache *cache)
+{
+    int status;
+
+    if (cache->pending_count == 0)
+        return true;
+
+    while ((status = flock(cache->fd, LOCK_EX)) != 0 && errno == EINTR)
+        ;
+    if (status != 0)
+        return false;
+
+    for (size_t i = 0; i < cache->pending_count; i++)
+        cache_write(cache, &cache->pending[i]);
+    cache->pending_count = 0;
+
+    flock(cache->fd, LOCK_UN);
+    return true;
+}
+
+void block_cache_store(BlockCache *cache, const CacheKey *key, size_t used, const Parser *parser)
+{
+    const char *cond_var = symbol_name(parser->symbols, parser->cond_var_id);
+    const char *assignment_var = symbol_name(parser->symbols, parser->assignment_var_id);
+    size_t cond_len = strlen(cond_var);
+    size_t assignment_len = strlen(assignment_var);
+    CacheSlot entry;
+
+    // Only results decided by the hashed bytes, so never a parsed else-if chain, which reads on
+    // past the end of its second branch. A slot holds one assignment per branch and no Ast.
+    if (used > key->len || parser->branches != NULL || parser->ast != NULL || parser->error_code == OUT_OF_MEMORY ||
+        cond_len + assignment_len > sizeof(entry.names))
+        return;
+
+    memset(&entry, 0, sizeof(entry));
+    entry.hash = key->hash;
+    entry.check = key->check;
+    entry.key_len = (uint32_t)key->len;
+    entry.consumed = (uint32_t)used;
+    entry.comparator = parser->comparator;
+    entry.valC = parser->valC;
+    entry.const1 = parser->const1;
+    entry.const2 = parser->const2;
+    entry.error_code = (int16_t)parser->error_code;
+    entry.flags = (parser->parsing_done ? CACHE_DONE : 0) | (parser->error_flag ? CACHE_ERROR : 0) |
+                  (parser->cond_var_id >= 0 ? CACHE_COND_VAR : 0) |
+                  (parser->assignment_var_id >= 0 ? CACHE_ASSIGNMENT_VAR : 0);
+    entry.cond_len = (uint8_t)cond_len;
+    entry.assignment_len = (uint8_t)assignment_len;
+    memcpy(entry.names, cond_var, cond_len);
+    memcpy(entry.names + cond_len, assignment_var, assignment_len);
+
+    pthread_mutex_lock(&cache->lock);
+    cache->pending[cache->pending_count++] = entry;
+    if (cache->pending_count == CACHE_PENDING)
+        cache_flush_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+bool block_cache_flush(BlockCache *cache)
+{
+    bool ok;
+
+    pthread_mutex_lock(&cache->lock);
+    ok = cache_flush_locked(cache);
+    pthread_mutex_unlock(&cache->lock);
+    return ok;
+}
+
+void block_cache_close(BlockCache *cache)
+{
+    if (cache == NULL)
+        return;
+
+    block_cache_flush(cache);
+    munmap(cache->header, cache->map_size);
+    close(cache->fd);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+}
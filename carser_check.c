@@ -0,0 +1,210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "carser.h"
+
+// Regression check for libcarser (make check)
+//
+// Parses every input file with both engines, with and without error recovery, feeding it
+// whole and in chunks of several sizes, and fails if any run reports a block differently
+// from the switch engine reading the whole file.
+
+// Chunk sizes, 0 for the whole input at once and CHUNK_RANDOM for 1 to 97 bytes at a time
+#define CHUNK_RANDOM SIZE_MAX
+
+static const size_t chunk_sizes[] = {0, 1, 2, 3, 5, 64, 4096, CHUNK_RANDOM};
+
+// Inputs every parsed block is evaluated at
+static const int check_xs[] = {INT32_MIN, -100, -1, 0, 1, 5, 100, INT32_MAX};
+
+static uint64_t rng_state;
+
+// xorshift64*, as in carser_bench
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+static char *read_file(const char *path, size_t *size)
+{
+    FILE *fp = fopen(path, "rb");
+    char *data = NULL;
+    long n;
+
+    if (fp == NULL)
+        return NULL;
+    if (fseek(fp, 0, SEEK_END) == 0 && (n = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_SET) == 0)
+    {
+        data = malloc((size_t)n + 1);
+        if (data != NULL && fread(data, 1, (size_t)n, fp) != (size_t)n)
+        {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t)n;
+    }
+
+    fclose(fp);
+    return data;
+}
+
+// One line per block: its status, offsets and fields, then the assignments it makes for
+// every check_xs value
+static void dump_block(FILE *out, const BlockResult *block)
+{
+    fprintf(out, "%zu %d %d %d %zu %zu %zu %s %d %d %s %d %d %zu %zu %zu", block->index, block->parsing_done,
+        block->error_flag, block->error_code, block->error_offset, block->start_offset, block->end_offset,
+        block->cond_var != NULL ? block->cond_var : "-", block->comparator, block->valC,
+        block->assignment_var != NULL ? block->assignment_var : "-", block->const1, block->const2,
+        block->ladder != NULL ? block->ladder->arm_count : 0,
+        block->branches != NULL ? block->branches->count : 0,
+        block->ast != NULL ? block->ast->node_count : 0);
+
+    if (block->parsing_done)
+    {
+        size_t count = block_assignment_count(block);
+        Assignment *pairs = malloc((count ? count : 1) * sizeof(Assignment));
+
+        if (pairs == NULL)
+        {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            exit(1);
+        }
+        for (size_t i = 0; i < sizeof(check_xs) / sizeof(check_xs[0]); i++)
+        {
+            size_t n = evaluate_assignments(block, check_xs[i], pairs);
+
+            fprintf(out, " |");
+            for (size_t a = 0; a < n; a++)
+                fprintf(out, " %s=%d", symbol_name(block->symbols, pairs[a].var_id), pairs[a].value);
+        }
+        free(pairs);
+    }
+    fprintf(out, "\n");
+}
+
+// Parse data as configured and return the dump of every block, NULL if memory ran out
+static char *parse_dump(const char *data, size_t size, int engine, bool recover, size_t chunk, size_t *len)
+{
+    Parser *parser = parser_create();
+    char *dump = NULL;
+    FILE *out;
+    BlockResult block;
+
+    if (parser == NULL)
+        return NULL;
+    out = open_memstream(&dump, len);
+    if (out == NULL)
+    {
+        parser_destroy(parser);
+        return NULL;
+    }
+    parser->engine = engine;
+    parser->recover = recover;
+    rng_state = 0x9e3779b97f4a7c15ULL;
+
+    for (size_t pos = 0; pos < size; )
+    {
+        size_t n = chunk == 0 ? size - pos : chunk == CHUNK_RANDOM ? 1 + rng_next() % 97 : chunk;
+
+        if (n > size - pos)
+            n = size - pos;
+        parser_feed(parser, data + pos, n);
+        pos += n;
+        while (parser_poll(parser, &block))
+            dump_block(out, &block);
+    }
+    parser_finish(parser);
+    while (parser_poll(parser, &block))
+        dump_block(out, &block);
+
+    fclose(out);
+    parser_destroy(parser);
+    return dump;
+}
+
+static const char *chunk_name(size_t chunk, char *buf, size_t buf_size)
+{
+    if (chunk == 0)
+        return "the whole input";
+    if (chunk == CHUNK_RANDOM)
+        return "random chunks";
+    snprintf(buf, buf_size, "%zu-byte chunks", chunk);
+    return buf;
+}
+
+// Compare every configuration of one file against the reference run, returns the mismatches
+static int check_file(const char *path)
+{
+    size_t size = 0;
+    size_t ref_len;
+    char *data = read_file(path, &size);
+    char *ref;
+    int mismatches = 0;
+    size_t runs = 0;
+
+    if (data == NULL)
+    {
+        printf("%s: Error: Could not read the file\n", path);
+        return 1;
+    }
+
+    for (int recover = 0; recover < 2; recover++)
+    {
+        ref = parse_dump(data, size, ENGINE_SWITCH, recover, 0, &ref_len);
+        if (ref == NULL)
+        {
+            printf("%s: Error: Memory allocation failed\n", path);
+            free(data);
+            return 1;
+        }
+
+        for (int engine = ENGINE_SWITCH; engine <= ENGINE_TABLE; engine++)
+        {
+            for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); c++)
+            {
+                size_t len;
+                char *dump = parse_dump(data, size, engine, recover, chunk_sizes[c], &len);
+                char name[48];
+
+                runs++;
+                if (dump == NULL || len != ref_len || memcmp(dump, ref, len) != 0)
+                {
+                    printf("%s: %s engine, %s%s: results differ from the switch engine on the whole input\n", path,
+                        engine == ENGINE_TABLE ? "table" : "switch", chunk_name(chunk_sizes[c], name, sizeof(name)),
+                        recover ? ", recovery on" : "");
+                    mismatches++;
+                }
+                free(dump);
+            }
+        }
+        free(ref);
+    }
+
+    if (mismatches == 0)
+        printf("%s: %zu runs agree\n", path, runs);
+    free(data);
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int mismatches = 0;
+
+    if (argc < 2)
+    {
+        printf("Usage: %s <file.v>...\n", argv[0]);
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+        mismatches += check_file(argv[i]);
+
+    return mismatches > 0 ? 1 : 0;
+}
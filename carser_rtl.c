@@ -0,0 +1,1210 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+
+// Cycle-accurate model of if_else_parser_2.v
+//
+// rtl_clock() is the RTL's FSM block transcribed register for register. Every edge computes
+// the next values from the current ones only, the way nonblocking assignments do. Where the
+// RTL assigns a register twice in one edge, the later assignment wins. Registers wrap at
+// their Verilog widths. The driver replays if_else_parser_tb.v: two reset edges, one character
+// per edge until parsing_done or error_flag, then idle edges. It writes the same "cycle N:"
+// lines as the RTL's +trace=1, and -l compares them against a trace from the RTL.
+
+#define VAR_LEN 16
+#define MAX_LINE 128
+
+// State encoding, as in if_else_parser_2.v
+enum
+{
+    IDLE = 0,
+    READ_IF = 1,
+    READ_OPEN_PAREN = 2,
+    READ_VAR = 3,
+    READ_COND_OPERATOR = 4,
+    READ_COND_OPERATOR2 = 5,
+    READ_VALC = 6,
+    READ_CLOSE_PAREN = 7,
+    READ_BEGIN = 8,
+    READ_ASSIGNMENT_VAR = 9,
+    READ_ASSIGNMENT_OPERATOR = 10,
+    READ_CONST1 = 11,
+    READ_SEMICOLON1 = 12,
+    READ_END1 = 13,
+    READ_ELSE = 14,
+    READ_ELSE_2 = 15,          // READ_ELSE + 1 in the RTL
+    READ_BEGIN2 = 16,
+    READ_BEGIN2_2 = 17,        // READ_BEGIN2 + 1 in the RTL
+    READ_ASSIGNMENT_VAR2 = 18,
+    READ_ASSIGNMENT_OPERATOR2 = 19,
+    READ_CONST2 = 20,
+    READ_SEMICOLON2 = 21,
+    READ_END2 = 22,
+    EVALUATE = 23,
+    ERROR = 24
+};
+
+// Error codes, unlike carser.h these include PAREN_MISMATCH
+enum
+{
+    NO_ERROR = 0,
+    INVALID_KEYWORD = 1,
+    VAR_MISMATCH = 2,
+    INVALID_CHAR = 3,
+    MISSING_SEMICOLON = 4,
+    MISSING_OPERATOR = 5,
+    SYNTAX_ERROR = 6,
+    PAREN_MISMATCH = 7
+};
+
+// Comparator encoding
+enum
+{
+    EQ = 0,
+    NE = 1,
+    LT = 2,
+    GT = 3,
+    LE = 4,
+    GE = 5
+};
+
+// The RTL's registers. Narrow registers are kept masked to their Verilog width.
+typedef struct
+{
+    uint8_t state;                  // [4:0]
+    uint32_t keyword_buffer;
+    uint8_t keyword_index;          // [2:0]
+    uint8_t keyword_complete;
+    uint8_t cond_var[VAR_LEN];      // [6:0] each
+    uint8_t cond_var_length;        // [3:0]
+    uint8_t cond_var_idx;           // [3:0]
+    uint8_t assignment_var_array[VAR_LEN];
+    uint8_t assignment_var2_length; // [3:0]
+    uint8_t assignment_var2_idx;    // [3:0]
+    uint8_t assignment_var2_array[VAR_LEN];
+    uint8_t var_match;
+    uint8_t reading_var;
+    int32_t valC, const1, const2;
+    int32_t num_buffer;
+    uint8_t parsing_number;
+    int32_t paren_count;
+    int32_t whitespace_count;
+    uint8_t blocking_assignment1, blocking_assignment2;
+    uint8_t comparator;             // [2:0]
+    uint8_t op_first;               // [6:0]
+    uint8_t is_valC_negative, is_const1_negative, is_const2_negative;
+
+    // Outputs. assignment_var is the packed [16*7-1:0] port, one character per entry.
+    int32_t p;
+    uint8_t assignment_var[VAR_LEN];
+    uint8_t assignment_var_length;  // [3:0]
+    uint8_t parsing_done;
+    uint8_t error_flag;
+    uint8_t error_code;             // [3:0]
+} RtlState;
+
+typedef struct
+{
+    int32_t x;
+    bool rearm;                     // the REARM parameter
+} RtlConfig;
+
+// "cycle N: ..." lines, as written by the RTL at +trace=1
+typedef struct
+{
+    char (*lines)[MAX_LINE];
+    size_t count;
+    size_t capacity;
+} Trace;
+
+typedef struct
+{
+    size_t chars;                   // characters in the stimulus
+    size_t sent;                    // characters the testbench got to send
+    uint64_t edges;                 // clock edges simulated, reset included
+    uint64_t done_cycle;            // edge on which parsing_done rose, 0 if it did not
+    uint64_t error_cycle;           // same for error_flag
+    RtlState final;                 // with REARM, the registers as parsing_done pulsed
+} RunResult;
+
+static bool trace_add(Trace *trace, const char *line)
+{
+    if (trace->count == trace->capacity)
+    {
+        size_t capacity = trace->capacity ? trace->capacity * 2 : 256;
+        char (*lines)[MAX_LINE] = realloc(trace->lines, capacity * sizeof(*lines));
+        if (lines == NULL)
+            return false;
+        trace->lines = lines;
+        trace->capacity = capacity;
+    }
+    snprintf(trace->lines[trace->count++], MAX_LINE, "%s", line);
+    return true;
+}
+
+static bool is_digit(int c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool is_letter(int c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool is_id_char(int c)
+{
+    return is_letter(c) || is_digit(c) || c == '_';
+}
+
+static bool is_ws(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+// 32-bit wrapping arithmetic, as on a Verilog integer
+static int32_t wrap_add(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a + (uint32_t)b);
+}
+
+static int32_t accumulate(int32_t num, int c)
+{
+    return (int32_t)((uint32_t)num * 10u + (uint32_t)(c - '0'));
+}
+
+static int32_t negate(int32_t v)
+{
+    return (int32_t)(0u - (uint32_t)v);
+}
+
+// var_names_match() compares with the current lengths, not the ones being written
+static bool var_names_match(const RtlState *c)
+{
+    if (c->assignment_var_length != c->assignment_var2_length)
+        return false;
+    for (int i = 0; i < c->assignment_var_length; i++)
+    {
+        if (c->assignment_var_array[i] != c->assignment_var2_array[i])
+            return false;
+    }
+    return true;
+}
+
+static int32_t select_branch(int comparator, int32_t x, int32_t valC, int32_t const1, int32_t const2)
+{
+    switch (comparator)
+    {
+    case EQ: return x == valC ? const1 : const2;
+    case NE: return x != valC ? const1 : const2;
+    case LT: return x < valC ? const1 : const2;
+    case GT: return x > valC ? const1 : const2;
+    case LE: return x <= valC ? const1 : const2;
+    case GE: return x >= valC ? const1 : const2;
+    default: return 0;
+    }
+}
+
+static void pack_assignment_var(uint8_t *packed, const uint8_t *array, int length)
+{
+    memset(packed, 0, VAR_LEN);
+    for (int i = 0; i < length; i++)
+        packed[i] = array[i];
+}
+
+static void rtl_reset(RtlState *n)
+{
+    memset(n, 0, sizeof(*n));
+    n->state = IDLE;
+    n->error_code = NO_ERROR;
+}
+
+static void set_error(RtlState *n, int code)
+{
+    n->error_flag = 1;
+    n->error_code = code;
+    n->state = ERROR;
+}
+
+// Keyword states: expect[k] is the character for keyword_index k, the last one moves to done_state
+static void read_keyword(const RtlState *c, RtlState *n, int ch, const char *expect, int done_state)
+{
+    int last = (int)strlen(expect) - 1;
+    int k = c->keyword_index;
+
+    if (k < 1 || k > last)
+    {
+        set_error(n, SYNTAX_ERROR);
+        return;
+    }
+    if (ch != expect[k])
+    {
+        set_error(n, INVALID_KEYWORD);
+        return;
+    }
+    if (k < last)
+    {
+        n->keyword_buffer = (c->keyword_buffer << 8) | (uint32_t)ch;
+        n->keyword_index = (k + 1) & 7;
+        return;
+    }
+    n->whitespace_count = 0;
+    n->keyword_index = 0;
+    n->state = done_state;
+}
+
+// One rising edge of the FSM block, without the reset branch: reads only c, writes only n
+static void rtl_clock(const RtlState *c, RtlState *n, int ch, bool new_char, const RtlConfig *config)
+{
+    *n = *c;
+    ch &= 0x7f;
+
+    if (config->rearm)
+        n->parsing_done = 0;
+
+    switch (c->state)
+    {
+    case IDLE:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+            n->state = IDLE;
+        else if (ch == 'i')
+        {
+            n->keyword_index = 1;
+            n->state = READ_IF;
+        }
+        else
+            set_error(n, INVALID_KEYWORD);
+        break;
+
+    case READ_IF:
+        if (!new_char)
+            break;
+        if (ch == 'f')
+        {
+            n->keyword_index = 0;
+            n->state = READ_OPEN_PAREN;
+        }
+        else
+            set_error(n, INVALID_KEYWORD);
+        break;
+
+    case READ_OPEN_PAREN:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+            n->state = READ_OPEN_PAREN;
+        else if (ch == '(')
+        {
+            n->paren_count = wrap_add(c->paren_count, 1);
+            n->state = READ_VAR;
+            n->cond_var_idx = 0;
+            n->cond_var_length = 0;
+            n->reading_var = 0;
+        }
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case READ_VAR:
+        if (!new_char)
+            break;
+        if (is_ws(ch) && !c->reading_var)
+            n->state = READ_VAR;
+        else if (!c->reading_var && is_letter(ch))
+        {
+            n->cond_var[0] = ch;
+            n->cond_var_idx = 1;
+            n->cond_var_length = 1;
+            n->reading_var = 1;
+        }
+        else if (c->reading_var && is_id_char(ch))
+        {
+            n->cond_var[c->cond_var_idx] = ch;
+            n->cond_var_idx = (c->cond_var_idx + 1) & 15;
+            n->cond_var_length = (c->cond_var_length + 1) & 15;
+            if (c->cond_var_idx == 15)
+            {
+                n->state = READ_COND_OPERATOR;
+                n->reading_var = 0;
+            }
+        }
+        else if (ch == ')' && c->reading_var)
+            n->paren_count = wrap_add(c->paren_count, -1);
+        else if (c->reading_var && (is_ws(ch) || ch == '>' || ch == '<' || ch == '=' || ch == '!'))
+        {
+            n->state = READ_COND_OPERATOR;
+            n->reading_var = 0;
+            if (!is_ws(ch))
+            {
+                // The error is raised, but the state is overridden below
+                if (c->paren_count == 0)
+                    set_error(n, SYNTAX_ERROR);
+                n->op_first = ch;
+                n->state = READ_COND_OPERATOR2;
+            }
+        }
+        else if (ch == '(')
+            n->paren_count = wrap_add(c->paren_count, 1);
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case READ_COND_OPERATOR:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+            n->state = READ_COND_OPERATOR;
+        else if (ch == ')')
+        {
+            if (c->paren_count == 0)
+                set_error(n, PAREN_MISMATCH);
+            n->paren_count = wrap_add(c->paren_count, -1);
+        }
+        else if (ch == '<' || ch == '>' || ch == '=' || ch == '!')
+        {
+            if (c->paren_count == 0)
+                set_error(n, PAREN_MISMATCH);
+            n->op_first = ch;
+            n->state = READ_COND_OPERATOR2;
+        }
+        else
+            set_error(n, INVALID_CHAR);
+        break;
+
+    case READ_COND_OPERATOR2:
+        if (!new_char)
+            break;
+        if (ch == '-')
+            n->is_valC_negative = 1;
+        switch (c->op_first)
+        {
+        case '<':
+        case '>':
+            if (ch == '=')
+            {
+                n->comparator = c->op_first == '<' ? LE : GE;
+                n->state = READ_VALC;
+            }
+            else if (is_digit(ch))
+            {
+                n->comparator = c->op_first == '<' ? LT : GT;
+                n->num_buffer = accumulate(c->num_buffer, ch);
+                n->parsing_number = 1;
+                n->state = READ_VALC;
+            }
+            else if (ch == '(')
+            {
+                n->paren_count = wrap_add(c->paren_count, 1);
+                n->state = READ_VALC;
+            }
+            else
+                set_error(n, SYNTAX_ERROR);
+            break;
+        case '=':
+        case '!':
+            if (ch == '=')
+            {
+                n->comparator = c->op_first == '=' ? EQ : NE;
+                n->state = READ_VALC;
+            }
+            else
+                set_error(n, MISSING_OPERATOR);
+            break;
+        default:
+            set_error(n, SYNTAX_ERROR);
+            break;
+        }
+        break;
+
+    case READ_VALC:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+            n->state = READ_VALC;
+        else if (ch == '-' && !c->parsing_number)
+            n->is_valC_negative = 1;
+        else if (ch == '(' && !c->parsing_number)
+            n->paren_count = wrap_add(c->paren_count, 1);
+        else if (is_digit(ch))
+        {
+            n->num_buffer = accumulate(c->num_buffer, ch);
+            n->parsing_number = 1;
+        }
+        else if (c->parsing_number)
+        {
+            n->valC = c->is_valC_negative ? negate(c->num_buffer) : c->num_buffer;
+            n->num_buffer = 0;
+            n->parsing_number = 0;
+            if (ch == ')')
+            {
+                if (c->paren_count == 0)
+                    set_error(n, PAREN_MISMATCH);
+                n->paren_count = wrap_add(c->paren_count, -1);
+                n->state = READ_CLOSE_PAREN;
+            }
+            else
+                set_error(n, SYNTAX_ERROR);
+        }
+        break;
+
+    case READ_CLOSE_PAREN:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+            n->state = READ_CLOSE_PAREN;
+        else if (ch == 'b')
+        {
+            n->keyword_index = 1;
+            n->keyword_buffer = 'b';
+            if (c->paren_count != 0)
+                set_error(n, PAREN_MISMATCH);
+            n->state = READ_BEGIN;
+        }
+        else if (ch == ')')
+            n->paren_count = wrap_add(c->paren_count, -1);
+        else
+            set_error(n, INVALID_KEYWORD);
+        break;
+
+    case READ_BEGIN:
+        if (new_char)
+            read_keyword(c, n, ch, "begin", READ_ASSIGNMENT_VAR);
+        break;
+
+    case READ_ASSIGNMENT_VAR:
+        if (!new_char)
+            break;
+        // Whitespace always lands in the first branch, even after a name
+        if (is_ws(ch))
+            n->whitespace_count = wrap_add(c->whitespace_count, 1);
+        else if (c->whitespace_count == 0)
+            set_error(n, INVALID_KEYWORD);
+        else if (!c->reading_var && is_letter(ch))
+        {
+            n->assignment_var_array[0] = ch;
+            n->assignment_var_length = 1;
+            n->cond_var_idx = 1;
+            n->reading_var = 1;
+        }
+        else if (c->reading_var && is_id_char(ch))
+        {
+            n->assignment_var_array[c->cond_var_idx] = ch;
+            n->cond_var_idx = (c->cond_var_idx + 1) & 15;
+            n->assignment_var_length = (c->assignment_var_length + 1) & 15;
+            if (c->cond_var_idx == 15)
+            {
+                n->state = READ_ASSIGNMENT_OPERATOR;
+                n->reading_var = 0;
+            }
+        }
+        else if (ch == ')' && c->reading_var)
+            n->paren_count = wrap_add(c->paren_count, -1);
+        else if (c->reading_var && (ch == '=' || ch == '<'))
+        {
+            n->state = READ_ASSIGNMENT_OPERATOR;
+            n->reading_var = 0;
+            if (ch == '<')
+            {
+                n->blocking_assignment1 = 0;
+                n->op_first = '<';
+            }
+            else
+            {
+                n->blocking_assignment1 = 1;
+                n->op_first = 0;
+                n->num_buffer = 0;
+                n->parsing_number = 0;
+                n->is_const1_negative = 0;
+                n->state = READ_CONST1;
+            }
+        }
+        else if (ch == '(')
+            n->paren_count = wrap_add(c->paren_count, 1);
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case READ_ASSIGNMENT_OPERATOR:
+    case READ_ASSIGNMENT_OPERATOR2:
+    {
+        bool first = c->state == READ_ASSIGNMENT_OPERATOR;
+        uint8_t *blocking = first ? &n->blocking_assignment1 : &n->blocking_assignment2;
+
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+        {
+            // Only the if branch counts whitespace here
+            if (first)
+                n->whitespace_count = wrap_add(c->whitespace_count, 1);
+            n->state = c->state;
+        }
+        else if (first && c->whitespace_count == 0)
+            set_error(n, INVALID_KEYWORD);
+        else if (ch == ')')
+            n->paren_count = wrap_add(c->paren_count, -1);
+        else if (ch == '<')
+        {
+            *blocking = 0;
+            n->state = c->state;
+        }
+        else if (ch == '=')
+        {
+            *blocking = c->op_first != '<';
+            n->op_first = 0;
+            n->num_buffer = 0;
+            n->parsing_number = 0;
+            if (first)
+            {
+                n->is_const1_negative = 0;
+                n->state = READ_CONST1;
+            }
+            else
+            {
+                n->is_const2_negative = 0;
+                n->state = READ_CONST2;
+            }
+        }
+        else
+            n->op_first = ch;
+        break;
+    }
+
+    case READ_CONST1:
+    case READ_CONST2:
+    {
+        bool first = c->state == READ_CONST1;
+        uint8_t negative = first ? c->is_const1_negative : c->is_const2_negative;
+
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+        {
+            if (negative || c->parsing_number)
+                set_error(n, SYNTAX_ERROR);
+            else
+                n->state = c->state;
+        }
+        else if (ch == '(' && !c->parsing_number)
+            n->paren_count = wrap_add(c->paren_count, 1);
+        else if (ch == ')')
+        {
+            if (c->num_buffer == 0)
+                set_error(n, PAREN_MISMATCH);
+            else
+                n->paren_count = wrap_add(c->paren_count, -1);
+        }
+        else if (ch == '-' && !c->parsing_number)
+        {
+            if (first)
+                n->is_const1_negative = 1;
+            else
+                n->is_const2_negative = 1;
+        }
+        else if (is_digit(ch))
+        {
+            n->num_buffer = accumulate(c->num_buffer, ch);
+            n->parsing_number = 1;
+        }
+        else if (c->parsing_number)
+        {
+            int32_t value = negative ? negate(c->num_buffer) : c->num_buffer;
+            if (first)
+                n->const1 = value;
+            else
+                n->const2 = value;
+            n->num_buffer = 0;
+            n->parsing_number = 0;
+            if (ch == ';')
+                n->state = first ? READ_SEMICOLON1 : READ_SEMICOLON2;
+        }
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+    }
+
+    case READ_SEMICOLON1:
+    case READ_SEMICOLON2:
+        if (!new_char)
+            break;
+        // Raised first, then possibly overridden by the state below
+        if (c->paren_count != 0)
+            set_error(n, c->state == READ_SEMICOLON1 ? PAREN_MISMATCH : SYNTAX_ERROR);
+        if (is_ws(ch))
+            n->state = c->state;
+        else if (ch == 'e')
+        {
+            n->keyword_index = 1;
+            n->keyword_buffer = 'e';
+            n->state = c->state == READ_SEMICOLON1 ? READ_END1 : READ_END2;
+        }
+        else
+            set_error(n, INVALID_KEYWORD);
+        break;
+
+    case READ_END1:
+        if (!new_char)
+            break;
+        if (c->keyword_index == 1)
+        {
+            if (ch == 'n')
+            {
+                n->keyword_buffer = (c->keyword_buffer << 8) | 'n';
+                n->keyword_index = 2;
+            }
+            else
+                set_error(n, INVALID_KEYWORD);
+        }
+        else if (c->keyword_index == 2)
+        {
+            // No else branch in the RTL: anything but "d" leaves the FSM waiting here
+            if (ch == 'd')
+            {
+                n->whitespace_count = 0;
+                n->keyword_index = 0;
+                n->state = READ_ELSE;
+            }
+        }
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case READ_ELSE:
+    case READ_BEGIN2:
+        if (!new_char)
+            break;
+        if (is_ws(ch))
+        {
+            n->whitespace_count = wrap_add(c->whitespace_count, 1);
+            n->state = c->state;
+        }
+        else if (c->whitespace_count == 0)
+            set_error(n, INVALID_KEYWORD);
+        else if (ch == (c->state == READ_ELSE ? 'e' : 'b'))
+        {
+            n->keyword_index = 1;
+            n->keyword_buffer = (uint32_t)ch;
+            n->state = c->state + 1;
+        }
+        else
+            set_error(n, INVALID_KEYWORD);
+        break;
+
+    case READ_ELSE_2:
+        if (new_char)
+            read_keyword(c, n, ch, "else", READ_BEGIN2);
+        break;
+
+    case READ_BEGIN2_2:
+        // This case statement has no default: keyword_index 0 or 5-7 changes nothing
+        if (new_char && c->keyword_index >= 1 && c->keyword_index <= 4)
+            read_keyword(c, n, ch, "begin", READ_ASSIGNMENT_VAR2);
+        break;
+
+    case READ_ASSIGNMENT_VAR2:
+        if (!new_char)
+            break;
+        if (is_ws(ch) && !c->reading_var)
+        {
+            n->whitespace_count = wrap_add(c->whitespace_count, 1);
+            n->state = READ_ASSIGNMENT_VAR2;
+        }
+        else if (!is_ws(ch) && c->whitespace_count == 0)
+            set_error(n, INVALID_KEYWORD);
+        else if (!c->reading_var && is_letter(ch))
+        {
+            n->assignment_var2_array[0] = ch;
+            n->assignment_var2_idx = 1;
+            n->assignment_var2_length = 1;
+            n->reading_var = 1;
+        }
+        else if (c->reading_var && is_id_char(ch))
+        {
+            n->assignment_var2_array[c->assignment_var2_idx] = ch;
+            n->assignment_var2_idx = (c->assignment_var2_idx + 1) & 15;
+            n->assignment_var2_length = (c->assignment_var2_length + 1) & 15;
+            if (c->assignment_var2_idx == 15)
+            {
+                n->state = READ_ASSIGNMENT_OPERATOR2;
+                n->reading_var = 0;
+                n->var_match = var_names_match(c);
+                if (!n->var_match)
+                    set_error(n, VAR_MISMATCH);
+            }
+        }
+        else if (ch == ')' && c->reading_var)
+            n->paren_count = wrap_add(c->paren_count, -1);
+        else if (c->reading_var && (is_ws(ch) || ch == '=' || ch == '<'))
+        {
+            n->state = READ_ASSIGNMENT_OPERATOR2;
+            n->reading_var = 0;
+            n->var_match = var_names_match(c);
+            if (!n->var_match)
+                set_error(n, VAR_MISMATCH);
+            if (ch == '<')
+            {
+                n->blocking_assignment2 = 0;
+                n->op_first = '<';
+            }
+            else if (ch == '=')
+            {
+                n->blocking_assignment2 = 1;
+                n->op_first = 0;
+                n->num_buffer = 0;
+                n->parsing_number = 0;
+                n->is_const2_negative = 0;
+                n->state = READ_CONST2;
+            }
+        }
+        else if (ch == '(')
+            n->paren_count = wrap_add(c->paren_count, 1);
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case READ_END2:
+        if (!new_char)
+            break;
+        if (c->keyword_index == 1)
+        {
+            if (ch == 'n')
+            {
+                n->keyword_buffer = (c->keyword_buffer << 8) | 'n';
+                n->keyword_index = 2;
+            }
+            else
+                set_error(n, INVALID_KEYWORD);
+        }
+        else if (c->keyword_index == 2)
+        {
+            if (ch != 'd')
+                set_error(n, INVALID_KEYWORD);
+            else if (config->rearm)
+            {
+                // rearm_block in the RTL
+                n->p = select_branch(c->comparator, config->x, c->valC, c->const1, c->const2);
+                pack_assignment_var(n->assignment_var, c->assignment_var_array, c->assignment_var_length);
+                n->parsing_done = 1;
+                n->state = IDLE;
+                n->keyword_buffer = 0;
+                n->keyword_index = 0;
+                n->keyword_complete = 0;
+                n->var_match = 0;
+                n->reading_var = 0;
+                n->is_valC_negative = 0;
+                n->is_const1_negative = 0;
+                n->is_const2_negative = 0;
+                n->num_buffer = 0;
+                n->parsing_number = 0;
+                n->comparator = 0;
+                n->op_first = 0;
+                n->paren_count = 0;
+                n->whitespace_count = 0;
+            }
+            else
+            {
+                n->keyword_index = 0;
+                n->state = EVALUATE;
+            }
+        }
+        else
+            set_error(n, SYNTAX_ERROR);
+        break;
+
+    case EVALUATE:
+        if (c->parsing_done)
+            n->state = IDLE;
+        if (!c->error_flag)
+        {
+            n->p = select_branch(c->comparator, config->x, c->valC, c->const1, c->const2);
+            n->parsing_done = 1;
+        }
+        break;
+
+    case ERROR:
+        n->parsing_done = 0;
+        n->p = 0;
+        memset(n->assignment_var, 0, VAR_LEN);
+        n->assignment_var_length = 0;
+        break;
+
+    default:
+        n->state = c->error_flag ? ERROR : IDLE;
+        break;
+    }
+
+    // always @(state): entering EVALUATE packs the name into the output port
+    if (n->state != c->state && n->state == EVALUATE)
+        pack_assignment_var(n->assignment_var, n->assignment_var_array, n->assignment_var_length);
+}
+
+// Mirrors the RTL's trace block, which samples before the FSM updates
+typedef struct
+{
+    uint64_t cycle;
+    uint8_t prev_state;
+    uint8_t prev_done;
+    uint8_t prev_error;
+    Trace *trace;
+    FILE *out;
+} Tracer;
+
+static bool trace_line(Tracer *tracer, const char *line)
+{
+    if (tracer->out != NULL)
+        fprintf(tracer->out, "%s\n", line);
+    return tracer->trace == NULL || trace_add(tracer->trace, line);
+}
+
+static bool trace_sample(Tracer *tracer, const RtlState *s)
+{
+    char line[MAX_LINE];
+    long long cycle = (long long)tracer->cycle - 1;
+    bool ok = true;
+
+    if (s->state != tracer->prev_state)
+    {
+        snprintf(line, sizeof(line), "cycle %lld: state %d -> %d", cycle, tracer->prev_state, s->state);
+        ok = ok && trace_line(tracer, line);
+    }
+    if (s->parsing_done && !tracer->prev_done)
+    {
+        snprintf(line, sizeof(line), "cycle %lld: parsing_done", cycle);
+        ok = ok && trace_line(tracer, line);
+    }
+    if (s->error_flag && !tracer->prev_error)
+    {
+        snprintf(line, sizeof(line), "cycle %lld: error_flag, error_code %d", cycle, s->error_code);
+        ok = ok && trace_line(tracer, line);
+    }
+    tracer->prev_state = s->state;
+    tracer->prev_done = s->parsing_done;
+    tracer->prev_error = s->error_flag;
+    tracer->cycle++;
+    return ok;
+}
+
+typedef struct
+{
+    RtlState cur;
+    RtlState next;
+    Tracer tracer;
+    RunResult *result;
+    const RtlConfig *config;
+    bool ok;
+} Sim;
+
+static void sim_edge(Sim *sim, bool rst, int ch, bool valid)
+{
+    sim->ok = trace_sample(&sim->tracer, &sim->cur) && sim->ok;
+    if (rst)
+        rtl_reset(&sim->next);
+    else
+        rtl_clock(&sim->cur, &sim->next, ch, valid, sim->config);
+
+    if (sim->next.parsing_done && !sim->cur.parsing_done && sim->result->done_cycle == 0)
+    {
+        sim->result->done_cycle = sim->result->edges;
+        sim->result->final = sim->next;
+    }
+    if (sim->next.error_flag && !sim->cur.error_flag && sim->result->error_cycle == 0)
+        sim->result->error_cycle = sim->result->edges;
+
+    sim->cur = sim->next;
+    sim->result->edges++;
+}
+
+// Replays if_else_parser_tb.v. Edges 0 and 1 are in reset, the first character is on edge 2.
+static bool run_stimulus(const uint8_t *chars, size_t count, const RtlConfig *config,
+                         Trace *trace, FILE *trace_out, RunResult *result)
+{
+    Sim sim;
+
+    memset(result, 0, sizeof(*result));
+    memset(&sim, 0, sizeof(sim));
+    rtl_reset(&sim.cur);
+    sim.tracer.trace = trace;
+    sim.tracer.out = trace_out;
+    sim.tracer.prev_state = IDLE;
+    sim.result = result;
+    sim.config = config;
+    sim.ok = true;
+    result->chars = count;
+
+    sim_edge(&sim, true, 0, false);
+    sim_edge(&sim, true, 0, false);
+
+    while (result->sent < count && !sim.cur.parsing_done && !sim.cur.error_flag)
+        sim_edge(&sim, false, chars[result->sent++], true);
+
+    for (int timeout = 0; timeout < 8 && !sim.cur.parsing_done && !sim.cur.error_flag; timeout++)
+        sim_edge(&sim, false, 0, false);
+
+    // The testbench's closing #20, plus one edge so its last transition gets sampled
+    for (int i = 0; i < 3; i++)
+        sim_edge(&sim, false, 0, false);
+
+    if (!config->rearm || result->done_cycle == 0)
+        result->final = sim.cur;
+    return sim.ok;
+}
+
+// $readmemh input: hex bytes separated by whitespace, "//" comments, stops at 00
+static uint8_t *read_hex(const char *path, size_t *count)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return NULL;
+
+    size_t capacity = 4096;
+    uint8_t *chars = malloc(capacity);
+    int c;
+
+    *count = 0;
+    while (chars != NULL && (c = fgetc(fp)) != EOF)
+    {
+        if (c == '/')
+        {
+            while ((c = fgetc(fp)) != EOF && c != '\n')
+                ;
+            continue;
+        }
+        if (!isxdigit(c))
+            continue;
+
+        unsigned value = 0;
+        while (c != EOF && isxdigit(c))
+        {
+            value = value * 16 + (unsigned)(isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
+            c = fgetc(fp);
+        }
+        if ((value & 0xff) == 0)
+            break;
+        if (*count == capacity)
+        {
+            uint8_t *grown = realloc(chars, capacity * 2);
+            if (grown == NULL)
+            {
+                free(chars);
+                chars = NULL;
+                break;
+            }
+            chars = grown;
+            capacity *= 2;
+        }
+        chars[(*count)++] = (uint8_t)value;
+    }
+    fclose(fp);
+    return chars;
+}
+
+// Raw text input, fed as is up to the first NUL
+static uint8_t *read_raw(const char *path, size_t *count)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return NULL;
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < 0)
+    {
+        fclose(fp);
+        return NULL;
+    }
+
+    uint8_t *chars = malloc((size_t)size + 1);
+    if (chars != NULL)
+    {
+        *count = fread(chars, 1, (size_t)size, fp);
+        void *nul = memchr(chars, 0, *count);
+        if (nul != NULL)
+            *count = (size_t)((uint8_t *)nul - chars);
+    }
+    fclose(fp);
+    return chars;
+}
+
+// Keeps the "cycle N: ..." lines of an RTL trace, and drops everything else the RTL prints
+static bool read_rtl_trace(const char *path, Trace *trace)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return false;
+
+    char line[1024];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp) != NULL)
+    {
+        if (strncmp(line, "cycle ", 6) != 0)
+            continue;
+        line[strcspn(line, "\r\n")] = '\0';
+        ok = trace_add(trace, line);
+    }
+    fclose(fp);
+    return ok;
+}
+
+static int compare_traces(const Trace *model, const Trace *rtl, const char *rtl_path)
+{
+    size_t n = model->count < rtl->count ? model->count : rtl->count;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (strcmp(model->lines[i], rtl->lines[i]) != 0)
+        {
+            printf("Divergence at trace line %zu:\n  model: %s\n  rtl:   %s\n", i + 1,
+                   model->lines[i], rtl->lines[i]);
+            return 1;
+        }
+    }
+    if (model->count != rtl->count)
+    {
+        printf("Trace lengths differ: model %zu lines, %s %zu lines. First extra line: %s\n",
+               model->count, rtl_path, rtl->count,
+               model->count > rtl->count ? model->lines[n] : rtl->lines[n]);
+        return 1;
+    }
+    printf("Lockstep: %zu trace lines match %s.\n", model->count, rtl_path);
+    return 0;
+}
+
+static void print_result(const char *path, const RunResult *r, const RtlConfig *config)
+{
+    const RtlState *s = &r->final;
+    char name[VAR_LEN + 1];
+    int length = s->assignment_var_length;
+
+    for (int i = 0; i < length; i++)
+        name[i] = (char)s->assignment_var[i];
+    name[length] = '\0';
+
+    printf("%s: ", path);
+    if (s->parsing_done && !s->error_flag)
+        printf("p=%d var=%s", s->p, name);
+    else if (s->error_flag)
+        printf("error %d", s->error_code);
+    else
+        printf("not finished");
+    printf(" (x=%d, %zu of %zu chars sent", config->x, r->sent, r->chars);
+    if (r->done_cycle)
+        printf(", parsing_done on cycle %llu", (unsigned long long)r->done_cycle);
+    if (r->error_cycle)
+        printf(", error_flag on cycle %llu", (unsigned long long)r->error_cycle);
+    printf(")\n");
+}
+
+static void usage(const char *prog)
+{
+    printf("Usage: %s [options] <stimulus>...\n", prog);
+    printf("  -x <value>      value of x (default 0)\n");
+    printf("  -f <format>     stimulus format, hex ($readmemh, as written by c_parser_2) or raw (default hex)\n");
+    printf("  -R <0|1>        REARM parameter (default 0)\n");
+    printf("  -t <file>       write the model's trace, - for stdout\n");
+    printf("  -l <file>       lockstep: compare against a trace from vvp parser_tb +trace=1\n");
+    printf("Every stimulus runs as one if_else_parser_tb.v simulation. -l takes a single stimulus.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    RtlConfig config = {0, false};
+    bool raw = false;
+    const char *trace_path = NULL;
+    const char *rtl_path = NULL;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (value == NULL || arg[1] == '\0' || arg[2] != '\0')
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        switch (arg[1])
+        {
+        case 'x': config.x = (int32_t)strtol(value, NULL, 10); break;
+        case 'f': raw = strcmp(value, "raw") == 0; break;
+        case 'R': config.rearm = atoi(value) != 0; break;
+        case 't': trace_path = value; break;
+        case 'l': rtl_path = value; break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int files = argc - i;
+    if (files == 0 || (rtl_path != NULL && files != 1))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE *trace_out = NULL;
+    if (trace_path != NULL)
+    {
+        trace_out = strcmp(trace_path, "-") == 0 ? stdout : fopen(trace_path, "w");
+        if (trace_out == NULL)
+        {
+            fprintf(stderr, "Error: Could not write %s\n", trace_path);
+            return 1;
+        }
+    }
+
+    int status = 0;
+    size_t failed = 0;
+    for (; i < argc; i++)
+    {
+        size_t count = 0;
+        uint8_t *chars = raw ? read_raw(argv[i], &count) : read_hex(argv[i], &count);
+        if (chars == NULL)
+        {
+            fprintf(stderr, "Error: Could not read %s\n", argv[i]);
+            status = 1;
+            continue;
+        }
+
+        Trace model = {NULL, 0, 0};
+        RunResult result;
+        if (!run_stimulus(chars, count, &config, rtl_path != NULL ? &model : NULL, trace_out, &result))
+        {
+            fprintf(stderr, "Error: Memory allocation failed\n");
+            return 1;
+        }
+        print_result(argv[i], &result, &config);
+        if (!result.final.parsing_done || result.final.error_flag)
+            failed++;
+
+        if (rtl_path != NULL)
+        {
+            Trace rtl = {NULL, 0, 0};
+            if (!read_rtl_trace(rtl_path, &rtl))
+            {
+                fprintf(stderr, "Error: Could not read %s\n", rtl_path);
+                return 1;
+            }
+            status = compare_traces(&model, &rtl, rtl_path);
+            free(rtl.lines);
+        }
+        free(model.lines);
+        free(chars);
+    }
+
+    if (files > 1)
+        printf("%d stimuli, %zu parsed, %zu with an error or unfinished\n", files, files - failed, failed);
+
+    if (trace_out != NULL && trace_out != stdout)
+        fclose(trace_out);
+    return status;
+}
@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "carser.h"
+
+// Rule store file
+//
+// A 128-byte header, then one section per array, each at a 64-byte aligned offset recorded
+// in the header. The sections are the arrays of RuleStore as they are in memory, so opening
+// a store is mapping it and checking that the header's counts fit the file. Names are one
+// block of NUL-terminated strings, name_offsets[id] is where name id starts. Bump
+// RULE_STORE_VERSION whenever a section is added or changes meaning.
+#define RULE_STORE_VERSION 1
+#define RULE_STORE_BYTE_ORDER 0x01020304u
+#define RULE_STORE_ALIGN 64
+
+static const char rule_store_magic[8] = {'C', 'A', 'R', 'S', 'E', 'R', 'R', 'S'};
+
+enum
+{
+    SECTION_VALC,
+    SECTION_CONST1,
+    SECTION_CONST2,
+    SECTION_COND_VAR,
+    SECTION_ASSIGNMENT_VAR,
+    SECTION_CMP_MASK,
+    SECTION_NAME_OFFSETS,
+    SECTION_NAMES,
+    SECTION_COUNT
+};
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;         // RULE_STORE_BYTE_ORDER as written
+    uint64_t count;
+    uint64_t name_count;
+    uint64_t names_size;
+    uint64_t offsets[SECTION_COUNT];
+    uint64_t reserved[3];
+} RuleStoreHeader;
+
+_Static_assert(sizeof(RuleStoreHeader) == 128, "rule store header layout");
+
+// Comparator of each CMP_*_BIT mask, -1 for masks no comparator produces
+static const int mask_comparator[8] = {-1, LT, EQ, LE, GT, NE, GE, -1};
+static const uint8_t comparator_bits[6] = {
+    CMP_EQ_BIT,              // EQ
+    CMP_LT_BIT | CMP_GT_BIT, // NE
+    CMP_LT_BIT,              // LT
+    CMP_GT_BIT,              // GT
+    CMP_LT_BIT | CMP_EQ_BIT, // LE
+    CMP_GT_BIT | CMP_EQ_BIT  // GE
+};
+
+struct RuleStoreBuilder
+{
+    size_t count;
+    size_t capacity;
+    size_t skipped;     // Parsed blocks the format cannot hold
+    int32_t *valC;
+    int32_t *const1;
+    int32_t *const2;
+    int32_t *cond_var;
+    int32_t *assignment_var;
+    uint8_t *cmp_mask;
+    SymbolTable *names;
+};
+
+RuleStoreBuilder *rule_store_builder_create(void)
+{
+    RuleStoreBuilder *builder = calloc(1, sizeof(RuleStoreBuilder));
+
+    if (builder == NULL)
+        return NULL;
+    builder->names = symbol_table_create();
+    if (builder->names == NULL)
+    {
+        free(builder);
+        return NULL;
+    }
+    return builder;
+}
+
+void rule_store_builder_destroy(RuleStoreBuilder *builder)
+{
+    if (builder == NULL)
+        return;
+
+    free(builder->valC);
+    free(builder->const1);
+    free(builder->const2);
+    free(builder->cond_var);
+    free(builder->assignment_var);
+    free(builder->cmp_mask);
+    symbol_table_destroy(builder->names);
+    free(builder);
+}
+
+static bool grow_array(void **array, size_t capacity, size_t size)
+{
+    void *grown = realloc(*array, capacity * size);
+
+    if (grown == NULL)
+        return false;
+    *array = grown;
+    return true;
+}
+
+// Add a parsed if-else block. Blocks with errors are ignored; parsed blocks the format cannot
+// hold (else-if chains, several assignments per branch, nested blocks and compound conditions)
+// are counted in rule_store_builder_skipped. Returns false if memory ran out.
+bool rule_store_builder_add(RuleStoreBuilder *builder, const BlockResult *block)
+{
+    if (!block->parsing_done)
+        return true;
+    if (block->ladder != NULL || block->branches != NULL || block->ast != NULL || block->comparator < 0 ||
+        block->comparator > GE)
+    {
+        builder->skipped++;
+        return true;
+    }
+
+    if (builder->count == builder->capacity)
+    {
+        size_t capacity = builder->capacity ? builder->capacity * 2 : 1024;
+
+        if (!grow_array((void **)&builder->valC, capacity, sizeof(int32_t)) ||
+            !grow_array((void **)&builder->const1, capacity, sizeof(int32_t)) ||
+            !grow_array((void **)&builder->const2, capacity, sizeof(int32_t)) ||
+            !grow_array((void **)&builder->cond_var, capacity, sizeof(int32_t)) ||
+            !grow_array((void **)&builder->assignment_var, capacity, sizeof(int32_t)) ||
+            !grow_array((void **)&builder->cmp_mask, capacity, sizeof(uint8_t)))
+            return false;
+        builder->capacity = capacity;
+    }
+
+    int cond_var = symbol_intern(builder->names, block->cond_var, strlen(block->cond_var));
+    int assignment_var = symbol_intern(builder->names, block->assignment_var, strlen(block->assignment_var));
+    if (cond_var < 0 || assignment_var < 0)
+        return false;
+
+    size_t i = builder->count++;
+    builder->valC[i] = block->valC;
+    builder->const1[i] = block->const1;
+    builder->const2[i] = block->const2;
+    builder->cond_var[i] = cond_var;
+    builder->assignment_var[i] = assignment_var;
+    builder->cmp_mask[i] = comparator_bits[block->comparator];
+    return true;
+}
+
+size_t rule_store_builder_count(const RuleStoreBuilder *builder)
+{
+    return builder->count;
+}
+
+size_t rule_store_builder_skipped(const RuleStoreBuilder *builder)
+{
+    return builder->skipped;
+}
+
+static uint64_t align_up(uint64_t offset)
+{
+    return (offset + RULE_STORE_ALIGN - 1) & ~(uint64_t)(RULE_STORE_ALIGN - 1);
+}
+
+// Write a section at its offset, the gap before it is zero filled by ftruncate
+static bool write_section(int fd, const void *data, size_t size, uint64_t offset)
+{
+    const char *p = data;
+
+    while (size > 0)
+    {
+        ssize_t written = pwrite(fd, p, size, (off_t)offset);
+
+        if (written <= 0)
+            return false;
+        p += written;
+        size -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+    return true;
+}
+
+// Write the store to a new file renamed over path, so readers never see half a store
+bool rule_store_write(const RuleStoreBuilder *builder, const char *path)
+{
+    size_t name_count = symbol_count(builder->names);
+    uint32_t *name_offsets = malloc((name_count + 1) * sizeof(uint32_t));
+    RuleStoreHeader header;
+    uint64_t sizes[SECTION_COUNT];
+    uint64_t names_size = 0;
+
+    if (name_offsets == NULL)
+        return false;
+    for (size_t id = 0; id < name_count; id++)
+    {
+        name_offsets[id] = (uint32_t)names_size;
+        names_size += strlen(symbol_name(builder->names, (int)id)) + 1;
+    }
+    if (names_size > UINT32_MAX)
+    {
+        free(name_offsets);
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, rule_store_magic, sizeof(rule_store_magic));
+    header.version = RULE_STORE_VERSION;
+    header.byte_order = RULE_STORE_BYTE_ORDER;
+    header.count = builder->count;
+    header.name_count = name_count;
+    header.names_size = names_size;
+
+    sizes[SECTION_VALC] = builder->count * sizeof(int32_t);
+    sizes[SECTION_CONST1] = builder->count * sizeof(int32_t);
+    sizes[SECTION_CONST2] = builder->count * sizeof(int32_t);
+    sizes[SECTION_COND_VAR] = builder->count * sizeof(int32_t);
+    sizes[SECTION_ASSIGNMENT_VAR] = builder->count * sizeof(int32_t);
+    sizes[SECTION_CMP_MASK] = builder->count * sizeof(uint8_t);
+    sizes[SECTION_NAME_OFFSETS] = name_count * sizeof(uint32_t);
+    sizes[SECTION_NAMES] = names_size;
+
+    uint64_t end = align_up(sizeof(header));
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+        header.offsets[s] = end;
+        end = align_up(end + sizes[s]);
+    }
+
+    size_t path_len = strlen(path);
+    char *tmp = malloc(path_len + 8);
+    int fd = -1;
+    bool ok = tmp != NULL;
+
+    if (ok)
+    {
+        memcpy(tmp, path, path_len);
+        memcpy(tmp + path_len, ".XXXXXX", 8);
+        fd = mkstemp(tmp);
+        ok = fd >= 0;
+    }
+    ok = ok && fchmod(fd, 0644) == 0 && ftruncate(fd, (off_t)end) == 0 &&
+         write_section(fd, &header, sizeof(header), 0) &&
+         write_section(fd, builder->valC, sizes[SECTION_VALC], header.offsets[SECTION_VALC]) &&
+         write_section(fd, builder->const1, sizes[SECTION_CONST1], header.offsets[SECTION_CONST1]) &&
+         write_section(fd, builder->const2, sizes[SECTION_CONST2], header.offsets[SECTION_CONST2]) &&
+         write_section(fd, builder->cond_var, sizes[SECTION_COND_VAR], header.offsets[SECTION_COND_VAR]) &&
+         write_section(fd, builder->assignment_var, sizes[SECTION_ASSIGNMENT_VAR], header.offsets[SECTION_ASSIGNMENT_VAR]) &&
+         write_section(fd, builder->cmp_mask, sizes[SECTION_CMP_MASK], header.offsets[SECTION_CMP_MASK]) &&
+         write_section(fd, name_offsets, sizes[SECTION_NAME_OFFSETS], header.offsets[SECTION_NAME_OFFSETS]);
+
+    // Names straight from the symbol table, one write per name
+    for (size_t id = 0; ok && id < name_count; id++)
+    {
+        const char *name = symbol_name(builder->names, (int)id);
+        ok = write_section(fd, name, strlen(name) + 1, header.offsets[SECTION_NAMES] + name_offsets[id]);
+    }
+
+    if (fd >= 0)
+    {
+        ok = close(fd) == 0 && ok && rename(tmp, path) == 0;
+        if (!ok)
+            unlink(tmp);
+    }
+    free(tmp);
+    free(name_offsets);
+    return ok;
+}
+
+// Map a store file, NULL if it cannot be read or is not a store of this version
+RuleStore *rule_store_open(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    RuleStoreHeader header;
+    RuleStore *store;
+
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+        memcmp(header.magic, rule_store_magic, sizeof(rule_store_magic)) != 0 ||
+        header.version != RULE_STORE_VERSION || header.byte_order != RULE_STORE_BYTE_ORDER ||
+        header.count > INT32_MAX || header.name_count > INT32_MAX || header.names_size > UINT32_MAX)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // Every section has to lie inside the file, at an aligned offset
+    uint64_t sizes[SECTION_COUNT] = {
+        header.count * sizeof(int32_t), header.count * sizeof(int32_t), header.count * sizeof(int32_t),
+        header.count * sizeof(int32_t), header.count * sizeof(int32_t), header.count * sizeof(uint8_t),
+        header.name_count * sizeof(uint32_t), header.names_size
+    };
+    for (int s = 0; s < SECTION_COUNT; s++)
+    {
+        if (header.offsets[s] % RULE_STORE_ALIGN != 0 || header.offsets[s] > (uint64_t)st.st_size ||
+            sizes[s] > (uint64_t)st.st_size - header.offsets[s])
+        {
+            close(fd);
+            return NULL;
+        }
+    }
+
+    store = calloc(1, sizeof(RuleStore));
+    if (store == NULL)
+    {
+        close(fd);
+        return NULL;
+    }
+    store->map_size = (size_t)st.st_size;
+    store->map = mmap(NULL, store->map_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (store->map == MAP_FAILED)
+    {
+        free(store);
+        return NULL;
+    }
+
+    const char *base = store->map;
+    store->count = (size_t)header.count;
+    store->valC = (const int32_t *)(base + header.offsets[SECTION_VALC]);
+    store->const1 = (const int32_t *)(base + header.offsets[SECTION_CONST1]);
+    store->const2 = (const int32_t *)(base + header.offsets[SECTION_CONST2]);
+    store->cond_var = (const int32_t *)(base + header.offsets[SECTION_COND_VAR]);
+    store->assignment_var = (const int32_t *)(base + header.offsets[SECTION_ASSIGNMENT_VAR]);
+    store->cmp_mask = (const uint8_t *)(base + header.offsets[SECTION_CMP_MASK]);
+    store->name_count = (size_t)header.name_count;
+    store->name_offsets = (const uint32_t *)(base + header.offsets[SECTION_NAME_OFFSETS]);
+    store->names = base + header.offsets[SECTION_NAMES];
+    store->names_size = (size_t)header.names_size;
+    return store;
+}
+
+void rule_store_close(RuleStore *store)
+{
+    if (store == NULL)
+        return;
+
+    munmap(store->map, store->map_size);
+    free(store);
+}
+
+// Name of an ID, "" if the ID or its offset is out of range. Checked here rather than when
+// the store is opened, so opening does not touch the name offsets.
+const char *rule_store_name(const RuleStore *store, int32_t id)
+{
+    if (id < 0 || (size_t)id >= store->name_count || store->names_size == 0 ||
+        store->name_offsets[id] >= store->names_size || store->names[store->names_size - 1] != '\0')
+        return "";
+    return store->names + store->name_offsets[id];
+}
+
+int rule_store_comparator(const RuleStore *store, size_t rule)
+{
+    return mask_comparator[store->cmp_mask[rule] & 7];
+}
+
+int rule_store_evaluate(const RuleStore *store, size_t rule, int x)
+{
+    int valC = store->valC[rule];
+    int mask = store->cmp_mask[rule];
+    int outcome = x < valC ? CMP_LT_BIT : x == valC ? CMP_EQ_BIT : CMP_GT_BIT;
+
+    return (mask & outcome) ? store->const1[rule] : store->const2[rule];
+}
+
+// out[i] is rule i's assigned value for x. Same compare-and-select as evaluate_batch, with
+// the rule varying instead of x.
+void rule_store_evaluate_all(const RuleStore *store, int x, int *out)
+{
+    size_t i = 0;
+    size_t n = store->count;
+
+#ifdef __SSE2__
+    __m128i v_x = _mm_set1_epi32(x);
+    __m128i zero = _mm_setzero_si128();
+    __m128i lt_bit = _mm_set1_epi32(CMP_LT_BIT);
+    __m128i eq_bit = _mm_set1_epi32(CMP_EQ_BIT);
+    __m128i gt_bit = _mm_set1_epi32(CMP_GT_BIT);
+
+    for (; i + 4 <= n; i += 4)
+    {
+        int32_t mask_bytes;
+        memcpy(&mask_bytes, store->cmp_mask + i, 4);
+        __m128i mask = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(mask_bytes), zero), zero);
+
+        __m128i v_valC = _mm_loadu_si128((const __m128i *)(store->valC + i));
+        __m128i v_const1 = _mm_loadu_si128((const __m128i *)(store->const1 + i));
+        __m128i v_const2 = _mm_loadu_si128((const __m128i *)(store->const2 + i));
+
+        // Outcome bit of x against each valC, kept where the rule's mask has it
+        __m128i outcome = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_cmplt_epi32(v_x, v_valC), lt_bit),
+                                                    _mm_and_si128(_mm_cmpeq_epi32(v_x, v_valC), eq_bit)),
+                                       _mm_and_si128(_mm_cmpgt_epi32(v_x, v_valC), gt_bit));
+        __m128i cond = _mm_cmpgt_epi32(_mm_and_si128(outcome, mask), zero);
+        __m128i p = _mm_xor_si128(v_const2, _mm_and_si128(cond, _mm_xor_si128(v_const1, v_const2)));
+        _mm_storeu_si128((__m128i *)(out + i), p);
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        int valC = store->valC[i];
+        int outcome = (-(x < valC) & CMP_LT_BIT) | (-(x == valC) & CMP_EQ_BIT) | (-(x > valC) & CMP_GT_BIT);
+        int cond = -((outcome & store->cmp_mask[i]) != 0);
+        out[i] = store->const2[i] ^ (cond & (store->const1[i] ^ store->const2[i]));
+    }
+}
@@ -1,4 +1,21 @@
-module if_else_parser_2 (
+// Tracing: TRACE_MAX is the highest trace level compiled in (0 compiles the logging out), and the
+// +trace=<level> plusarg picks the level at run time (default 0, silent):
+//   1  state transitions and parsing_done / error_flag rising, plus the EVALUATING and
+//      variable-mismatch messages
+//   2  full per-cycle dump of state, buffers and variables
+// +trace_file=<path> writes the trace to a file instead of stdout. With TRACE_SUFFIX = 1 the
+// instance's hierarchical name is appended to the path (+trace_file=t.log writes
+// t.log.tb.uut.lane[0].parser), so every instance of a design gets a file of its own.
+//
+// With REARM = 1 the parser evaluates on the final "d" itself. It raises parsing_done for that
+// one cycle and goes straight back to IDLE with its per-block registers cleared, so the next
+// block can start on the very next character without a reset (see if_else_parser_stream.v).
+// After an error it still waits in ERROR for rst.
+module if_else_parser_2 #(
+    parameter TRACE_MAX = 2,
+    parameter TRACE_SUFFIX = 0,
+    parameter REARM = 0
+) (
     input  wire        clk,                   
     input  wire        rst,                   
     input  wire signed [31:0] x,              
@@ -102,6 +119,32 @@ module if_else_parser_2 (
     reg is_valC_negative, is_const1_negative, is_const2_negative;
 
     wire new_char = char_valid;
+
+    // Trace control, see the top of the file
+    integer trace_level;
+    integer trace_fd;
+    reg [8*256:1] trace_file;
+
+    // Set here rather than in the declarations, which could run after this block
+    initial begin
+        trace_level = 0;
+        trace_fd = 32'h8000_0001; // stdout
+        if (TRACE_MAX > 0) begin
+            if (!$value$plusargs("trace=%d", trace_level))
+                trace_level = 0;
+            if (trace_level > TRACE_MAX)
+                trace_level = TRACE_MAX;
+            if (trace_level > 0 && $value$plusargs("trace_file=%s", trace_file)) begin
+                if (TRACE_SUFFIX)
+                    $sformat(trace_file, "%0s.%m", trace_file);
+                trace_fd = $fopen(trace_file, "w");
+                if (trace_fd == 0) begin
+                    $display("Cannot open trace file %0s, tracing to stdout", trace_file);
+                    trace_fd = 32'h8000_0001;
+                end
+            end
+        end
+    end
     
     // Function to check if variable names match
     function var_names_match;
@@ -115,44 +158,120 @@ module if_else_parser_2 (
                 for (i = 0; i < assignment_var_length; i = i + 1) begin
                     if (assignment_var_array[i] != assignment_var2_array[i]) begin
                         var_names_match = 0;  // Mismatch found
-                        $display("Mismatch at position %0d: '%c' vs '%c'", 
-                                i, assignment_var_array[i], assignment_var2_array[i]);
+                        if (TRACE_MAX >= 1 && trace_level >= 1)
+                            $fwrite(trace_fd, "Mismatch at position %0d: '%c' vs '%c'\n", 
+                                    i, assignment_var_array[i], assignment_var2_array[i]);
                     end
                 end
             end
         end
     endfunction
 
-    // for debug:
-    always @(posedge clk) begin
-        $write("State: %2d, curr_char: %c (%h), keyword_buffer: %h, keyword_index: %0d, parsing_number: %1d\n", 
-            state, ascii_char, ascii_char, keyword_buffer, keyword_index, parsing_number);
+    // Value assigned by the block: const1 if the condition holds, const2 otherwise
+    function signed [31:0] select_branch;
+        input [2:0] cmp;
+        input signed [31:0] xv, cv, c1, c2;
+        begin
+            case(cmp)
+                EQ:  select_branch = (xv == cv) ? c1 : c2;
+                NE:  select_branch = (xv != cv) ? c1 : c2;
+                LT:  select_branch = (xv <  cv) ? c1 : c2;
+                GT:  select_branch = (xv >  cv) ? c1 : c2;
+                LE:  select_branch = (xv <= cv) ? c1 : c2;
+                GE:  select_branch = (xv >= cv) ? c1 : c2;
+                default: select_branch = 0;
+            endcase
+        end
+    endfunction
 
-        // Print condition variable
-        $write("cond_var: ");
-        for (integer i = 0; i < cond_var_length; i = i + 1)
-            $write("%c", cond_var[i]);
-        for (integer i = cond_var_length; i < 16; i = i + 1)
-            $write(" ");
-            
-        // Print assignment variables
-        $write(", assignment_var: ");
-        for (integer i = 0; i < assignment_var_length; i = i + 1)
-            $write("%c", assignment_var_array[i]);
-        for (integer i = assignment_var_length; i < 16; i = i + 1)
-            $write(" ");
-            
-        $write(", assignment_var2: ");
-        for (integer i = 0; i < assignment_var2_length; i = i + 1)
-            $write("%c", assignment_var2_array[i]);
-        for (integer i = assignment_var2_length; i < 16; i = i + 1)
-            $write(" ");
-            
-        $write(", paren_count: %0d\n", paren_count);
-        $write("valC: %11d, const1: %11d, const2: %11d, error_code: %2d\n", 
-            valC, const1, const2, error_code);
-        $write("---------------------------------------------------------------------------------------------------------------------------------------------\n\n");
-    end
+    // assignment_var_array packed 7 bits per character, first character lowest
+    function [16*7-1:0] packed_assignment_var;
+        input [3:0] length;
+        integer i;
+        begin
+            packed_assignment_var = 0;
+            for (i = 0; i < length; i = i + 1)
+                packed_assignment_var = packed_assignment_var | (assignment_var_array[i] << (i*7));
+        end
+    endfunction
+
+    // REARM: clear what a block reads before writing it. The outputs keep the result, and
+    // the name arrays and lengths are rewritten from scratch by the next block.
+    task rearm_block;
+        begin
+            state               <= IDLE;
+            keyword_buffer      <= 0;
+            keyword_index       <= 0;
+            keyword_complete    <= 0;
+            var_match           <= 0;
+            reading_var         <= 0;
+            is_valC_negative    <= 0;
+            is_const1_negative  <= 0;
+            is_const2_negative  <= 0;
+            num_buffer          <= 0;
+            parsing_number      <= 0;
+            comparator          <= 0;
+            op_first            <= 0;
+            paren_count         <= 0;
+            whitespace_count    <= 0;
+        end
+    endtask
+
+    // Trace. The block samples at the clock edge, before the FSM updates, so `state` is the
+    // state the FSM was in for the cycle that just ended. "cycle N: state A -> B" means the
+    // FSM moved from A to B on rising edge N, counting edges from 0 with the reset cycles included.
+    // The "cycle N:" lines are what carser_rtl -l compares against its model.
+    generate
+        if (TRACE_MAX > 0) begin : trace
+            integer cycle = 0;
+            reg [4:0] prev_state = IDLE;
+            reg prev_done = 0, prev_error = 0;
+
+            always @(posedge clk) begin
+                if (trace_level >= 1 && state != prev_state)
+                    $fwrite(trace_fd, "cycle %0d: state %0d -> %0d\n", cycle - 1, prev_state, state);
+                if (trace_level >= 1 && parsing_done && !prev_done)
+                    $fwrite(trace_fd, "cycle %0d: parsing_done\n", cycle - 1);
+                if (trace_level >= 1 && error_flag && !prev_error)
+                    $fwrite(trace_fd, "cycle %0d: error_flag, error_code %0d\n", cycle - 1, error_code);
+
+                if (trace_level >= 2) begin
+                    $fwrite(trace_fd, "State: %2d, curr_char: %c (%h), keyword_buffer: %h, keyword_index: %0d, parsing_number: %1d\n", 
+                        state, ascii_char, ascii_char, keyword_buffer, keyword_index, parsing_number);
+
+                    // Print condition variable
+                    $fwrite(trace_fd, "cond_var: ");
+                    for (integer i = 0; i < cond_var_length; i = i + 1)
+                        $fwrite(trace_fd, "%c", cond_var[i]);
+                    for (integer i = cond_var_length; i < 16; i = i + 1)
+                        $fwrite(trace_fd, " ");
+                        
+                    // Print assignment variables
+                    $fwrite(trace_fd, ", assignment_var: ");
+                    for (integer i = 0; i < assignment_var_length; i = i + 1)
+                        $fwrite(trace_fd, "%c", assignment_var_array[i]);
+                    for (integer i = assignment_var_length; i < 16; i = i + 1)
+                        $fwrite(trace_fd, " ");
+                        
+                    $fwrite(trace_fd, ", assignment_var2: ");
+                    for (integer i = 0; i < assignment_var2_length; i = i + 1)
+                        $fwrite(trace_fd, "%c", assignment_var2_array[i]);
+                    for (integer i = assignment_var2_length; i < 16; i = i + 1)
+                        $fwrite(trace_fd, " ");
+                        
+                    $fwrite(trace_fd, ", paren_count: %0d\n", paren_count);
+                    $fwrite(trace_fd, "valC: %11d, const1: %11d, const2: %11d, error_code: %2d\n", 
+                        valC, const1, const2, error_code);
+                    $fwrite(trace_fd, "---------------------------------------------------------------------------------------------------------------------------------------------\n\n");
+                end
+
+                prev_state <= state;
+                prev_done <= parsing_done;
+                prev_error <= error_flag;
+                cycle <= cycle + 1;
+            end
+        end
+    endgenerate
 
     always @(state) begin
         if (state == EVALUATE) begin
@@ -202,6 +321,8 @@ module if_else_parser_2 (
             p                    <= 0;
             assignment_var       <= 0;
             assignment_var2      <= 0;
+            paren_count          <= 0;
+            whitespace_count     <= 0;
             // Clear variable arrays
             for (integer i = 0; i < 16; i = i + 1) begin
                 cond_var[i] <= 0;
@@ -210,6 +331,9 @@ module if_else_parser_2 (
             end
         end
         else begin
+            if(REARM)
+                parsing_done <= 0; // a one-cycle pulse per block
+
             case(state)
                 IDLE: begin
                     if(new_char) begin
@@ -921,7 +1045,8 @@ module if_else_parser_2 (
                                     error_flag <= 1;
                                     error_code <= VAR_MISMATCH;
                                     state <= ERROR;
-                                    $display("ERROR: Variables mismatch between branches!");
+                                    if (TRACE_MAX >= 1 && trace_level >= 1)
+                                        $fwrite(trace_fd, "ERROR: Variables mismatch between branches!\n");
                                 end
                             end
                         end
@@ -939,7 +1064,8 @@ module if_else_parser_2 (
                                 error_flag <= 1;
                                 error_code <= VAR_MISMATCH;
                                 state <= ERROR;
-                                $display("ERROR: Variables mismatch between branches!");
+                                if (TRACE_MAX >= 1 && trace_level >= 1)
+                                    $fwrite(trace_fd, "ERROR: Variables mismatch between branches!\n");
                             end
                             
                             // Process operator rightaway if not whitespace
@@ -1089,7 +1215,16 @@ module if_else_parser_2 (
                             
                             2: if(ascii_char == "d") begin
                                 keyword_index <= 0;
-                                state <= EVALUATE;
+                                if(REARM) begin
+                                    if(TRACE_MAX >= 1 && trace_level >= 1)
+                                        $fwrite(trace_fd, "EVALUATING: x=%d, valC=%d, comparator=%b, const1=%d, const2=%d\n",
+                                        x, valC, comparator, const1, const2);
+                                    p <= select_branch(comparator, x, valC, const1, const2);
+                                    assignment_var <= packed_assignment_var(assignment_var_length);
+                                    parsing_done <= 1;
+                                    rearm_block;
+                                end
+                                else state <= EVALUATE;
                             end else begin
                                 error_flag <= 1;
                                 error_code <= INVALID_KEYWORD;
@@ -1111,21 +1246,13 @@ module if_else_parser_2 (
                         state <= IDLE;
                     end
                     
-                    if(!parsing_done) begin
-                        $display("EVALUATING: x=%d, valC=%d, comparator=%b, const1=%d, const2=%d",
+                    if(!parsing_done && TRACE_MAX >= 1 && trace_level >= 1) begin
+                        $fwrite(trace_fd, "EVALUATING: x=%d, valC=%d, comparator=%b, const1=%d, const2=%d\n",
                         x, valC, comparator, const1, const2);
                     end 
 
                     if(!error_flag) begin
-                        case(comparator)
-                            EQ:  if(x == valC) p <= const1; else p <= const2;
-                            NE:  if(x != valC) p <= const1; else p <= const2;
-                            LT:  if(x <  valC) p <= const1; else p <= const2;
-                            GT:  if(x >  valC) p <= const1; else p <= const2;
-                            LE:  if(x <= valC) p <= const1; else p <= const2;
-                            GE:  if(x >= valC) p <= const1; else p <= const2;
-                            default: p <= 0;
-                        endcase
+                        p <= select_branch(comparator, x, valC, const1, const2);
                         parsing_done <= 1;
                     end
                 end
@@ -0,0 +1,253 @@
+// Array of if_else_parser_2 lanes behind a block dispatcher and a result collector.
+//
+// Blocks arrive on a BEAT-character input bus (valid/ready). A block is every beat up to and
+// including the one with in_last. Its tag and x are taken from the first beat. The dispatcher
+// gives each new block to the lowest idle lane and pushes its characters into that lane's
+// DEPTH-character buffer. The lane's parser then drains the buffer one character per cycle,
+// so while one lane is busy parsing, the input can already fill the next one. Aggregate
+// throughput is up to min(LANES, BEAT) characters per cycle.
+//
+// Each lane posts one result per block: the tag, p, assignment_var, parsing_done and the error
+// code. Once the parser is done or has flagged an error, the rest of the block is dropped, in
+// the same way the testbenches stop feeding a single parser. A lane whose block ends without a
+// result posts parsing_done = 0, error_flag = 0. The collector returns pending results lowest
+// lane first, so results come out in completion order. Use the tag to match them to their blocks.
+// After its result is taken, a lane's parser gets a one-cycle reset and the lane is free again.
+//
+// The lane parsers are built with TRACE_SUFFIX = 1, so +trace_file=t.log gives each lane a trace
+// file of its own, t.log.<array instance>.lane[i].parser.
+module if_else_parser_array #(
+    parameter LANES = 4,    // Number of parser instances
+    parameter BEAT  = 4,    // Characters per input beat
+    parameter DEPTH = 256,  // Per-lane input buffer, in characters (at least BEAT)
+    parameter TAG_W = 8
+) (
+    input  wire               clk,
+    input  wire               rst,
+
+    // Block input
+    input  wire [BEAT*7-1:0]  in_chars,     // character i of the beat in bits [i*7 +: 7]
+    input  wire [BEAT-1:0]    in_keep,      // which characters of the beat are present
+    input  wire               in_last,      // last beat of the block
+    input  wire [TAG_W-1:0]   in_tag,
+    input  wire signed [31:0] in_x,
+    input  wire               in_valid,
+    output reg                in_ready,
+
+    // Results
+    output wire               out_valid,
+    input  wire               out_ready,
+    output reg  [TAG_W-1:0]   out_tag,
+    output reg signed [31:0]  out_p,
+    output reg  [16*7-1:0]    out_assignment_var,
+    output reg  [3:0]         out_assignment_var_length,
+    output reg                out_parsing_done,
+    output reg                out_error_flag,
+    output reg  [3:0]         out_error_code
+);
+
+    // Per-lane parser connections
+    wire [LANES*7-1:0]  lane_char;
+    wire [LANES-1:0]    lane_char_valid;
+    wire [LANES*32-1:0] lane_p;
+    wire [LANES*112-1:0] lane_var;
+    wire [LANES*4-1:0]  lane_var_length;
+    wire [LANES-1:0]    lane_done;
+    wire [LANES-1:0]    lane_error_flag;
+    wire [LANES*4-1:0]  lane_error_code;
+
+    // Lane state
+    reg [LANES-1:0]     busy;         // holds a block
+    reg [LANES-1:0]     input_done;   // the block's last beat has arrived
+    reg [LANES-1:0]     finished;     // the parser has produced its result
+    reg [LANES-1:0]     lane_rst;     // one-cycle parser reset after a block
+    reg [TAG_W-1:0]     lane_tag [0:LANES-1];
+    reg signed [31:0]   lane_x [0:LANES-1];
+    reg [1:0]           drain [0:LANES-1]; // cycles since the buffer ran dry at the end of a block
+
+    // Per-lane input buffers
+    reg [6:0]           buffer [0:LANES*DEPTH-1];
+    reg [31:0]          wr_ptr [0:LANES-1];
+    reg [31:0]          rd_ptr [0:LANES-1];
+    reg [31:0]          count  [0:LANES-1];
+
+    // Posted results
+    reg [LANES-1:0]     res_pending;
+    reg [TAG_W-1:0]     res_tag [0:LANES-1];
+    reg signed [31:0]   res_p [0:LANES-1];
+    reg [16*7-1:0]      res_var [0:LANES-1];
+    reg [3:0]           res_var_length [0:LANES-1];
+    reg [LANES-1:0]     res_done;
+    reg [LANES-1:0]     res_error_flag;
+    reg [3:0]           res_error_code [0:LANES-1];
+
+    // Dispatcher
+    reg                 in_block;     // a block is being received
+    integer             cur_lane;     // its lane
+    integer             idle_lane;    // lowest idle lane, -1 if none
+    integer             dispatch_lane;
+    integer             out_lane;     // lowest lane with a pending result, -1 if none
+
+    integer l, b, push, pop, n, m;
+
+    genvar g;
+    generate
+        for (g = 0; g < LANES; g = g + 1) begin : lane
+            wire signed [31:0] x = lane_x[g];
+
+            assign lane_char[g*7 +: 7] = buffer[g*DEPTH + rd_ptr[g]];
+            assign lane_char_valid[g] = busy[g] && !finished[g] && !lane_rst[g] && count[g] != 0 &&
+                                        !lane_done[g] && !lane_error_flag[g];
+
+            if_else_parser_2 #(.TRACE_SUFFIX(1)) parser (
+                .clk(clk),
+                .rst(rst || lane_rst[g]),
+                .x(x),
+                .ascii_char(lane_char[g*7 +: 7]),
+                .char_valid(lane_char_valid[g]),
+                .p(lane_p[g*32 +: 32]),
+                .assignment_var(lane_var[g*112 +: 112]),
+                .assignment_var_length(lane_var_length[g*4 +: 4]),
+                .parsing_done(lane_done[g]),
+                .error_flag(lane_error_flag[g]),
+                .error_code(lane_error_code[g*4 +: 4])
+            );
+        end
+    endgenerate
+
+    // Dispatch: a new block goes to the lowest idle lane, the rest of it to the same lane as
+    // long as its buffer has room for a full beat
+    always @* begin
+        idle_lane = -1;
+        for (n = LANES - 1; n >= 0; n = n - 1)
+            if (!busy[n])
+                idle_lane = n;
+
+        dispatch_lane = in_block ? cur_lane : idle_lane;
+        if (in_block)
+            in_ready = (DEPTH - count[cur_lane]) >= BEAT;
+        else
+            in_ready = (idle_lane >= 0);
+    end
+
+    // Collect: lowest lane with a pending result first
+    assign out_valid = |res_pending;
+
+    always @* begin
+        out_lane = -1;
+        for (m = LANES - 1; m >= 0; m = m - 1)
+            if (res_pending[m])
+                out_lane = m;
+
+        out_tag = 0;
+        out_p = 0;
+        out_assignment_var = 0;
+        out_assignment_var_length = 0;
+        out_parsing_done = 0;
+        out_error_flag = 0;
+        out_error_code = 0;
+        if (out_lane >= 0) begin
+            out_tag = res_tag[out_lane];
+            out_p = res_p[out_lane];
+            out_assignment_var = res_var[out_lane];
+            out_assignment_var_length = res_var_length[out_lane];
+            out_parsing_done = res_done[out_lane];
+            out_error_flag = res_error_flag[out_lane];
+            out_error_code = res_error_code[out_lane];
+        end
+    end
+
+    always @(posedge clk or posedge rst) begin
+        if (rst) begin
+            busy        <= 0;
+            input_done  <= 0;
+            finished    <= 0;
+            lane_rst    <= 0;
+            res_pending <= 0;
+            res_done    <= 0;
+            res_error_flag <= 0;
+            in_block    <= 0;
+            cur_lane    <= 0;
+            for (l = 0; l < LANES; l = l + 1) begin
+                lane_tag[l] <= 0;
+                lane_x[l]   <= 0;
+                drain[l]    <= 0;
+                wr_ptr[l]   <= 0;
+                rd_ptr[l]   <= 0;
+                count[l]    <= 0;
+            end
+        end
+        else begin
+            // Accept a beat
+            if (in_valid && in_ready) begin
+                if (!in_block) begin
+                    busy[dispatch_lane]     <= 1;
+                    lane_tag[dispatch_lane] <= in_tag;
+                    lane_x[dispatch_lane]   <= in_x;
+                    cur_lane                <= dispatch_lane;
+                end
+                in_block <= !in_last;
+                if (in_last)
+                    input_done[dispatch_lane] <= 1;
+            end
+
+            for (l = 0; l < LANES; l = l + 1) begin
+                lane_rst[l] <= 0;
+
+                // Buffer the beat, unless the parser is already done with this block
+                push = 0;
+                if (in_valid && in_ready && dispatch_lane == l && !finished[l]) begin
+                    for (b = 0; b < BEAT; b = b + 1) begin
+                        if (in_keep[b]) begin
+                            buffer[l*DEPTH + (wr_ptr[l] + push) % DEPTH] <= in_chars[b*7 +: 7];
+                            push = push + 1;
+                        end
+                    end
+                end
+                pop = lane_char_valid[l] ? 1 : 0;
+
+                if (finished[l]) begin
+                    rd_ptr[l] <= wr_ptr[l];
+                    count[l]  <= 0;
+                end
+                else begin
+                    wr_ptr[l] <= (wr_ptr[l] + push) % DEPTH;
+                    rd_ptr[l] <= (rd_ptr[l] + pop) % DEPTH;
+                    count[l]  <= count[l] + push - pop;
+                end
+
+                // Post the result once the parser is done, has flagged an error, or has
+                // run out of characters (EVALUATE needs two cycles after the last one)
+                if (busy[l] && !finished[l] && !lane_rst[l]) begin
+                    if (lane_done[l] || lane_error_flag[l] || drain[l] == 3) begin
+                        finished[l]       <= 1;
+                        res_pending[l]    <= 1;
+                        res_tag[l]        <= lane_tag[l];
+                        res_p[l]          <= lane_p[l*32 +: 32];
+                        res_var[l]        <= lane_var[l*112 +: 112];
+                        res_var_length[l] <= lane_var_length[l*4 +: 4];
+                        res_done[l]       <= lane_done[l];
+                        res_error_flag[l] <= lane_error_flag[l];
+                        res_error_code[l] <= lane_error_code[l*4 +: 4];
+                    end
+                    else if (input_done[l] && count[l] == 0)
+                        drain[l] <= drain[l] + 1;
+                end
+
+                // Hand the result to the collector
+                if (out_valid && out_ready && out_lane == l)
+                    res_pending[l] <= 0;
+
+                // Free the lane once its block is fully received and its result is taken
+                if (busy[l] && finished[l] && input_done[l] && !res_pending[l]) begin
+                    busy[l]       <= 0;
+                    finished[l]   <= 0;
+                    input_done[l] <= 0;
+                    drain[l]      <= 0;
+                    lane_rst[l]   <= 1;
+                end
+            end
+        end
+    end
+
+endmodule
@@ -0,0 +1,229 @@
+// Throughput testbench for if_else_parser_array
+//
+// Compile once:  iverilog -o parser_array_tb if_else_parser_2.v if_else_parser_array.v if_else_parser_array_tb.v
+// Run:           vvp parser_array_tb +x=5 +stim=stimulus.hex
+//
+// The stimulus block (see if_else_parser_tb.v) is sent BLOCKS times, block b tagged b with
+// x = <x> + b - BLOCKS/2, to two arrays: a single-lane reference and one with LANES lanes.
+// The testbench checks that every tag gets the same result from both, and reports the cycles
+// each array needed for the whole batch. Change the lane count with
+// -Pif_else_parser_array_tb.LANES=8 (and BEAT, so the input can keep the lanes busy).
+//
+// +cut=<n> sends only the first half of every n-th block (tags n-1, 2n-1, ...). Those blocks end
+// without a result, so their lanes post one once the drain counter runs out, and must come back
+// with parsing_done = 0. +stall=1 holds out_ready of the LANES-lane array low on three cycles in
+// four, at random (+seed=<n>), so results wait in their lanes and the lanes are freed late. The testbench prints the result
+// of every block from the LANES-lane array.
+`timescale 1ns / 1ps
+
+module if_else_parser_array_tb();
+
+    parameter MAX_CHARS = 1 << 16; // Size of the stimulus memory
+    parameter LANES  = 4;
+    parameter BEAT   = 4;
+    parameter BLOCKS = 64;         // At most 256, the tags are 8 bits
+
+    reg clk, rst;
+    reg signed [31:0] x;
+
+    reg [7:0] stim_mem [0:MAX_CHARS-1];
+    reg [8*256:1] stim_file;
+    integer char_count;
+    integer cut, stall, seed;
+    integer len_1, len_n;
+    reg     out_ready_n;
+
+    // Single-lane reference (_1) and the LANES-lane array (_n)
+    reg  [BEAT*7-1:0] in_chars_1, in_chars_n;
+    reg  [BEAT-1:0]   in_keep_1, in_keep_n;
+    reg               in_last_1, in_last_n;
+    reg  [7:0]        in_tag_1, in_tag_n;
+    reg signed [31:0] in_x_1, in_x_n;
+    reg               in_valid_1, in_valid_n;
+    wire              in_ready_1, in_ready_n;
+
+    wire              out_valid_1, out_valid_n;
+    wire [7:0]        out_tag_1, out_tag_n;
+    wire signed [31:0] out_p_1, out_p_n;
+    wire [16*7-1:0]   out_var_1, out_var_n;
+    wire [3:0]        out_var_length_1, out_var_length_n;
+    wire              out_done_1, out_done_n;
+    wire              out_error_flag_1, out_error_flag_n;
+    wire [3:0]        out_error_code_1, out_error_code_n;
+
+    // Results by tag
+    reg signed [31:0] p_1 [0:BLOCKS-1], p_n [0:BLOCKS-1];
+    reg [16*7-1:0]    var_1 [0:BLOCKS-1], var_n [0:BLOCKS-1];
+    reg [3:0]         code_1 [0:BLOCKS-1], code_n [0:BLOCKS-1];
+    reg [BLOCKS-1:0]  done_1, done_n;
+    integer           got_1, got_n;
+    integer           cycles_1, cycles_n;
+
+    integer pos_1, pos_n, blk_1, blk_n, k_1, k_n, t, mismatches;
+
+    if_else_parser_array #(.LANES(1), .BEAT(BEAT)) uut_1 (
+        .clk(clk), .rst(rst),
+        .in_chars(in_chars_1), .in_keep(in_keep_1), .in_last(in_last_1),
+        .in_tag(in_tag_1), .in_x(in_x_1), .in_valid(in_valid_1), .in_ready(in_ready_1),
+        .out_valid(out_valid_1), .out_ready(1'b1), .out_tag(out_tag_1), .out_p(out_p_1),
+        .out_assignment_var(out_var_1), .out_assignment_var_length(out_var_length_1),
+        .out_parsing_done(out_done_1), .out_error_flag(out_error_flag_1),
+        .out_error_code(out_error_code_1)
+    );
+
+    if_else_parser_array #(.LANES(LANES), .BEAT(BEAT)) uut_n (
+        .clk(clk), .rst(rst),
+        .in_chars(in_chars_n), .in_keep(in_keep_n), .in_last(in_last_n),
+        .in_tag(in_tag_n), .in_x(in_x_n), .in_valid(in_valid_n), .in_ready(in_ready_n),
+        .out_valid(out_valid_n), .out_ready(out_ready_n), .out_tag(out_tag_n), .out_p(out_p_n),
+        .out_assignment_var(out_var_n), .out_assignment_var_length(out_var_length_n),
+        .out_parsing_done(out_done_n), .out_error_flag(out_error_flag_n),
+        .out_error_code(out_error_code_n)
+    );
+
+    // Generate a clock: 10 ns period
+    always #5 clk = ~clk;
+
+    // Consumer stalls, driven on the falling edge
+    always @(negedge clk)
+        out_ready_n <= stall == 0 || ($random(seed) & 3) == 0;
+
+    // Collect results and count cycles until the whole batch is back
+    always @(posedge clk) begin
+        if (!rst && out_valid_1) begin
+            p_1[out_tag_1]    <= out_p_1;
+            var_1[out_tag_1]  <= out_var_1;
+            code_1[out_tag_1] <= out_error_code_1;
+            done_1[out_tag_1] <= out_done_1;
+            got_1 <= got_1 + 1;
+        end
+        if (!rst && out_valid_n && out_ready_n) begin
+            p_n[out_tag_n]    <= out_p_n;
+            var_n[out_tag_n]  <= out_var_n;
+            code_n[out_tag_n] <= out_error_code_n;
+            done_n[out_tag_n] <= out_done_n;
+            got_n <= got_n + 1;
+        end
+        if (!rst && got_1 < BLOCKS)
+            cycles_1 <= cycles_1 + 1;
+        if (!rst && got_n < BLOCKS)
+            cycles_n <= cycles_n + 1;
+    end
+
+    initial begin
+        clk = 0;
+        rst = 1;
+        in_valid_1 = 0;
+        in_valid_n = 0;
+        got_1 = 0;
+        got_n = 0;
+        cycles_1 = 0;
+        cycles_n = 0;
+        out_ready_n = 1;
+
+        if (!$value$plusargs("x=%d", x))
+            x = 0;
+        if (!$value$plusargs("cut=%d", cut))
+            cut = 0;
+        if (!$value$plusargs("stall=%d", stall))
+            stall = 0;
+        if (!$value$plusargs("seed=%d", seed))
+            seed = 1;
+        if (!$value$plusargs("stim=%s", stim_file))
+            stim_file = "stimulus.hex";
+
+        $readmemh(stim_file, stim_mem);
+
+        char_count = 0;
+        while (char_count < MAX_CHARS && stim_mem[char_count] !== 8'h00 && ^stim_mem[char_count] !== 1'bx)
+            char_count = char_count + 1;
+        if (char_count == 0) begin
+            $display("Error: no stimulus in %0s", stim_file);
+            $finish;
+        end
+
+        #20;
+        rst = 0;
+
+        // Beats are driven on the falling edge and held until the array is ready on the rising one
+        fork
+            begin
+                for (blk_1 = 0; blk_1 < BLOCKS; blk_1 = blk_1 + 1) begin
+                    pos_1 = 0;
+                    len_1 = (cut > 0 && blk_1 % cut == cut - 1) ? char_count / 2 : char_count;
+                    while (pos_1 < len_1) begin
+                        in_chars_1 = 0;
+                        in_keep_1 = 0;
+                        for (k_1 = 0; k_1 < BEAT && pos_1 < len_1; k_1 = k_1 + 1) begin
+                            in_chars_1[k_1*7 +: 7] = stim_mem[pos_1][6:0];
+                            in_keep_1[k_1] = 1'b1;
+                            pos_1 = pos_1 + 1;
+                        end
+                        in_last_1 = (pos_1 >= len_1);
+                        in_tag_1 = blk_1;
+                        in_x_1 = x + blk_1 - BLOCKS / 2;
+                        in_valid_1 = 1;
+                        #4;
+                        while (!in_ready_1) #10;
+                        #6;
+                    end
+                end
+                in_valid_1 = 0;
+            end
+            begin
+                for (blk_n = 0; blk_n < BLOCKS; blk_n = blk_n + 1) begin
+                    pos_n = 0;
+                    len_n = (cut > 0 && blk_n % cut == cut - 1) ? char_count / 2 : char_count;
+                    while (pos_n < len_n) begin
+                        in_chars_n = 0;
+                        in_keep_n = 0;
+                        for (k_n = 0; k_n < BEAT && pos_n < len_n; k_n = k_n + 1) begin
+                            in_chars_n[k_n*7 +: 7] = stim_mem[pos_n][6:0];
+                            in_keep_n[k_n] = 1'b1;
+                            pos_n = pos_n + 1;
+                        end
+                        in_last_n = (pos_n >= len_n);
+                        in_tag_n = blk_n;
+                        in_x_n = x + blk_n - BLOCKS / 2;
+                        in_valid_n = 1;
+                        #4;
+                        while (!in_ready_n) #10;
+                        #6;
+                    end
+                end
+                in_valid_n = 0;
+            end
+        join
+
+        // Wait for the results, with a generous bound
+        t = 0;
+        while ((got_1 < BLOCKS || got_n < BLOCKS) && t < 4 * char_count + 64) begin
+            #10;
+            t = t + 1;
+        end
+
+        mismatches = 0;
+        for (t = 0; t < BLOCKS; t = t + 1) begin
+            $display("block %0d: x=%0d p=%0d done=%0d error=%0d%0s", t, x + t - BLOCKS / 2,
+                    p_n[t], done_n[t], code_n[t], (cut > 0 && t % cut == cut - 1) ? " cut" : "");
+            if (p_1[t] !== p_n[t] || var_1[t] !== var_n[t] || code_1[t] !== code_n[t] || done_1[t] !== done_n[t]) begin
+                $display("MISMATCH on block %0d: 1 lane p=%0d error=%0d, %0d lanes p=%0d error=%0d",
+                        t, p_1[t], code_1[t], LANES, p_n[t], code_n[t]);
+                mismatches = mismatches + 1;
+            end
+            else if (cut > 0 && t % cut == cut - 1 && done_n[t] !== 1'b0) begin
+                $display("MISMATCH on block %0d: the block was cut but parsing_done is set", t);
+                mismatches = mismatches + 1;
+            end
+        end
+
+        if (got_1 < BLOCKS || got_n < BLOCKS)
+            $display("Missing results: %0d and %0d of %0d", got_1, got_n, BLOCKS);
+        else if (mismatches == 0)
+            $display("All %0d results match the single-lane array.", BLOCKS);
+        $display("%0d blocks of %0d characters: 1 lane %0d cycles, %0d lanes %0d cycles (%0.2fx throughput)",
+                BLOCKS, char_count, cycles_1, LANES, cycles_n, cycles_1 * 1.0 / (cycles_n > 0 ? cycles_n : 1));
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,153 @@
+// Streaming front end for if_else_parser_2: valid/ready input, an input FIFO and one result
+// per block on a valid/ready output.
+//
+// Characters come in AXI-Stream style (s_data/s_valid/s_ready). s_last marks the last
+// character of each block. They go through a DEPTH-entry FIFO into an if_else_parser_2 built
+// with REARM = 1, which returns to IDLE by itself on the final "d". Back-to-back well-formed
+// blocks therefore parse at one character per cycle, with no reset and no dead cycles.
+//
+// Each block produces exactly one result on the m_* port:
+//   - parsed:     m_parsing_done = 1 and p / assignment_var. Characters after the final "d"
+//                 (up to s_last) are dropped.
+//   - error:      m_error_flag = 1 and the error code. The rest of the block is dropped, and
+//                 the parser gets a one-cycle reset.
+//   - incomplete: both flags 0, when s_last arrives before the block is finished. The parser
+//                 gets a one-cycle reset.
+// Only well-formed blocks re-arm for free. After an error or an incomplete block, resolving it
+// and the reset cost up to two cycles before the next block's first character.
+// Results are buffered two deep. A character is only fed to the parser while there is room
+// for the result it might complete, so m_ready backpressure never loses a result.
+module if_else_parser_stream #(
+    parameter DEPTH = 16     // Input FIFO entries
+) (
+    input  wire               clk,
+    input  wire               rst,
+    input  wire signed [31:0] x,
+
+    // Character input
+    input  wire [6:0]         s_data,
+    input  wire               s_last,
+    input  wire               s_valid,
+    output wire               s_ready,
+
+    // Results
+    output wire               m_valid,
+    input  wire               m_ready,
+    output wire signed [31:0] m_p,
+    output wire [16*7-1:0]    m_assignment_var,
+    output wire [3:0]         m_assignment_var_length,
+    output wire               m_parsing_done,
+    output wire               m_error_flag,
+    output wire [3:0]         m_error_code
+);
+
+    // Input FIFO, {last, character}
+    reg  [7:0]  fifo [0:DEPTH-1];
+    reg  [31:0] fifo_wr, fifo_rd, fifo_count;
+    wire        head_valid = (fifo_count != 0);
+    wire [6:0]  head_char  = fifo[fifo_rd][6:0];
+    wire        head_last  = fifo[fifo_rd][7];
+    wire        push = s_valid && s_ready;
+
+    assign s_ready = (fifo_count < DEPTH);
+
+    // Result FIFO, two entries
+    reg signed [31:0] res_p [0:1];
+    reg [16*7-1:0]    res_var [0:1];
+    reg [3:0]         res_var_length [0:1];
+    reg [1:0]         res_done, res_error_flag;
+    reg [3:0]         res_error_code [0:1];
+    reg               res_wr, res_rd;
+    reg [1:0]         res_count;
+    wire              res_pop = m_valid && m_ready;
+
+    assign m_valid                 = (res_count != 0);
+    assign m_p                     = res_p[res_rd];
+    assign m_assignment_var        = res_var[res_rd];
+    assign m_assignment_var_length = res_var_length[res_rd];
+    assign m_parsing_done          = res_done[res_rd];
+    assign m_error_flag            = res_error_flag[res_rd];
+    assign m_error_code            = res_error_code[res_rd];
+
+    // Parser
+    wire signed [31:0] p;
+    wire [16*7-1:0]    assignment_var;
+    wire [3:0]         assignment_var_length;
+    wire               parsing_done, error_flag;
+    wire [3:0]         error_code;
+    reg                parser_rst;   // one-cycle reset after an error or incomplete block
+    wire               feed;
+
+    if_else_parser_2 #(.REARM(1)) parser (
+        .clk(clk),
+        .rst(rst || parser_rst),
+        .x(x),
+        .ascii_char(head_char),
+        .char_valid(feed),
+        .p(p),
+        .assignment_var(assignment_var),
+        .assignment_var_length(assignment_var_length),
+        .parsing_done(parsing_done),
+        .error_flag(error_flag),
+        .error_code(error_code)
+    );
+
+    // Block tracking. The parser's answer to a character shows up in the following cycle, so
+    // the block is resolved when that answer is done or error, or when the character was the
+    // block's last one.
+    reg  fed_last;   // the character fed last cycle carried s_last
+    reg  dropping;   // block already resolved, discard up to and including s_last
+    wire resolve = !dropping && (parsing_done || error_flag || fed_last);
+    wire drop    = head_valid && (dropping || (resolve && !fed_last));
+    wire needs_reset = resolve && !parsing_done; // parser_rst before the next block
+    wire room    = (res_count + resolve - res_pop) <= 1;
+    assign feed  = head_valid && !drop && !needs_reset && !parser_rst && room;
+    wire pop     = drop || feed;
+
+    always @(posedge clk or posedge rst) begin
+        if (rst) begin
+            fifo_wr    <= 0;
+            fifo_rd    <= 0;
+            fifo_count <= 0;
+            res_wr     <= 0;
+            res_rd     <= 0;
+            res_count  <= 0;
+            res_done   <= 0;
+            res_error_flag <= 0;
+            parser_rst <= 0;
+            fed_last   <= 0;
+            dropping   <= 0;
+        end
+        else begin
+            if (push) begin
+                fifo[fifo_wr % DEPTH] <= {s_last, s_data};
+                fifo_wr <= (fifo_wr + 1) % DEPTH;
+            end
+            if (pop)
+                fifo_rd <= (fifo_rd + 1) % DEPTH;
+            fifo_count <= fifo_count + push - pop;
+
+            fed_last   <= feed && head_last;
+            parser_rst <= needs_reset;
+
+            if (resolve) begin
+                res_p[res_wr]          <= parsing_done ? p : 0;
+                res_var[res_wr]        <= parsing_done ? assignment_var : 0;
+                res_var_length[res_wr] <= parsing_done ? assignment_var_length : 0;
+                res_done[res_wr]       <= parsing_done;
+                res_error_flag[res_wr] <= error_flag;
+                res_error_code[res_wr] <= error_flag ? error_code : 0;
+                res_wr <= !res_wr;
+                if (!fed_last)
+                    dropping <= 1;
+            end
+            if (drop && head_last)
+                dropping <= 0;
+
+            if (res_pop)
+                res_rd <= !res_rd;
+            res_count <= res_count + resolve - res_pop;
+        end
+    end
+
+endmodule
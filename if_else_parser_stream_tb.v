@@ -0,0 +1,214 @@
+// Stall testbench for if_else_parser_stream
+//
+// Compile once:  iverilog -o parser_stream_tb if_else_parser_2.v if_else_parser_stream.v if_else_parser_stream_tb.v
+// Run:           vvp parser_stream_tb +x=5 +seed=1 +blocks=200
+//
+// The testbench generates its own blocks, "if (v <op> K) begin a <= C1; end else begin a <= C2; end"
+// with random op, K, C1 and C2. Every seventh block misspells "begin", and every eleventh one
+// that is not misspelled carries s_last halfway through, so it must come back incomplete. The
+// producer stalls at random and the consumer drops m_ready at random. Every block must come
+// back, in order, with the expected p, error code or neither flag. With +stall=0 the run also
+// shows that back-to-back blocks take one cycle per character, plus at most two cycles after
+// each incomplete block. +stall=2 holds m_ready low for long runs, so results wait in the two-entry
+// buffer and the input backs up behind them.
+`timescale 1ns / 1ps
+
+module if_else_parser_stream_tb();
+
+    parameter MAX_BLOCKS = 4096;
+
+    reg clk, rst;
+    reg signed [31:0] x;
+
+    reg  [6:0]  s_data;
+    reg         s_last;
+    reg         s_valid;
+    wire        s_ready;
+    wire        m_valid;
+    reg         m_ready;
+    wire signed [31:0] m_p;
+    wire [16*7-1:0] m_assignment_var;
+    wire [3:0]  m_assignment_var_length;
+    wire        m_parsing_done;
+    wire        m_error_flag;
+    wire [3:0]  m_error_code;
+
+    // Expected results, by block
+    reg signed [31:0] exp_p [0:MAX_BLOCKS-1];
+    reg [3:0]         exp_code [0:MAX_BLOCKS-1];
+
+    reg [8*96:1] text;
+    reg               exp_cut [0:MAX_BLOCKS-1];
+
+    reg [8*96:1] text;
+    integer seed, first_seed, blocks, stall, received, errors, sent_chars, cycles;
+    integer result_waits, input_waits;
+    integer blk, pos, stop, k, op, c1, c2, timeout;
+    reg cond;
+
+    if_else_parser_stream uut (
+        .clk(clk),
+        .rst(rst),
+        .x(x),
+        .s_data(s_data),
+        .s_last(s_last),
+        .s_valid(s_valid),
+        .s_ready(s_ready),
+        .m_valid(m_valid),
+        .m_ready(m_ready),
+        .m_p(m_p),
+        .m_assignment_var(m_assignment_var),
+        .m_assignment_var_length(m_assignment_var_length),
+        .m_parsing_done(m_parsing_done),
+        .m_error_flag(m_error_flag),
+        .m_error_code(m_error_code)
+    );
+
+    // Generate a clock: 10 ns period
+    always #5 clk = ~clk;
+
+    // Consumer: random backpressure, checks each result against the block it belongs to
+    always @(posedge clk) begin
+        if (!rst && m_valid && m_ready) begin
+            if (received >= blocks) begin
+                $display("Extra result: p=%0d, error code %0d", m_p, m_error_code);
+                errors = errors + 1;
+            end
+            else if (exp_cut[received]) begin
+                if (m_parsing_done || m_error_flag) begin
+                    $display("Block %0d: expected an incomplete result, got done=%0d error=%0d p=%0d",
+                            received, m_parsing_done, m_error_code, m_p);
+                    errors = errors + 1;
+                end
+            end
+            else if (exp_code[received] != 0) begin
+                if (!m_error_flag || m_error_code != exp_code[received]) begin
+                    $display("Block %0d: expected error %0d, got done=%0d error=%0d p=%0d",
+                            received, exp_code[received], m_parsing_done, m_error_code, m_p);
+                    errors = errors + 1;
+                end
+            end
+            else if (!m_parsing_done || m_error_flag || m_p !== exp_p[received]) begin
+                $display("Block %0d: expected p=%0d, got done=%0d error=%0d p=%0d",
+                        received, exp_p[received], m_parsing_done, m_error_code, m_p);
+                errors = errors + 1;
+            end
+            received = received + 1;
+        end
+    end
+
+    always @(negedge clk) begin
+        if (stall == 2) begin
+            // About 32 cycles ready, then about 256 stalled, longer than a block takes
+            if ({$random(seed)} % (m_ready ? 32 : 256) == 0)
+                m_ready <= !m_ready;
+        end
+        else
+            m_ready <= (stall == 0) || ($random(seed) % 4 != 0);
+    end
+
+    // Cycles, and cycles on which a result or a character waited for the other side
+    always @(posedge clk)
+        if (!rst && received < blocks) begin
+            cycles = cycles + 1;
+            if (m_valid && !m_ready)
+                result_waits = result_waits + 1;
+            if (s_valid && !s_ready)
+                input_waits = input_waits + 1;
+        end
+
+    initial begin
+        clk = 0;
+        rst = 1;
+        s_valid = 0;
+        s_last = 0;
+        s_data = 0;
+        m_ready = 0;
+        received = 0;
+        errors = 0;
+        sent_chars = 0;
+        cycles = 0;
+        result_waits = 0;
+        input_waits = 0;
+
+        if (!$value$plusargs("x=%d", x))
+            x = 0;
+        if (!$value$plusargs("seed=%d", seed))
+            seed = 1;
+        if (!$value$plusargs("blocks=%d", blocks))
+            blocks = 200;
+        if (!$value$plusargs("stall=%d", stall))
+            stall = 1;
+        if (blocks > MAX_BLOCKS)
+            blocks = MAX_BLOCKS;
+        first_seed = seed;
+        m_ready = (stall != 2);
+
+        #20;
+        rst = 0;
+
+        for (blk = 0; blk < blocks; blk = blk + 1) begin
+            op = {$random(seed)} % 4;
+            k  = ($random(seed) % 20) + x;
+            c1 = $random(seed) % 1000;
+            c2 = $random(seed) % 1000;
+            case (op)
+                0: cond = (x <= k);
+                1: cond = (x >= k);
+                2: cond = (x == k);
+                default: cond = (x != k);
+            endcase
+            exp_p[blk] = cond ? c1 : c2;
+            exp_code[blk] = (blk % 7 == 6) ? 4'd1 : 4'd0; // INVALID_KEYWORD
+            exp_cut[blk] = (blk % 11 == 10) && (blk % 7 != 6);
+
+            $sformat(text, "if (v %0s %0d)\n begin\n  a <= %0d;\n end\nelse\n begin\n  a <= %0d;\n end\n",
+                    op == 0 ? "<=" : op == 1 ? ">=" : op == 2 ? "==" : "!=", k, c1, c2);
+            if (blk % 7 == 6)
+                $sformat(text, "if (v <= %0d)\n begn\n  a <= %0d;\n end\nelse\n begin\n  a <= %0d;\n end\n", k, c1, c2);
+
+            // $sformat right-aligns the string, skip the leading zero bytes
+            pos = 96;
+            while (pos > 0 && text[pos*8 -: 8] == 0)
+                pos = pos - 1;
+
+            // Producer: drive on the falling edge, hold until accepted, stall at random. A cut
+            // block stops halfway, with s_last on its last character sent.
+            stop = exp_cut[blk] ? pos / 2 : 0;
+            while (pos > stop) begin
+                if (stall != 0 && $random(seed) % 3 == 0) begin
+                    s_valid = 0;
+                    #10;
+                end
+                else begin
+                    s_data = text[pos*8 -: 8];
+                    s_last = (pos == stop + 1);
+                    s_valid = 1;
+                    #4;
+                    while (!s_ready) #10;
+                    #6;
+                    pos = pos - 1;
+                    sent_chars = sent_chars + 1;
+                end
+            end
+        end
+        s_valid = 0;
+
+        timeout = 0;
+        while (received < blocks && timeout < 10000) begin
+            #10;
+            timeout = timeout + 1;
+        end
+
+        if (received == blocks && errors == 0)
+            $display("All %0d blocks returned in order with the expected results.", blocks);
+        else
+            $display("FAILED: %0d of %0d results, %0d errors", received, blocks, errors);
+        $display("%0d characters in %0d cycles (x = %0d, seed %0d, stalls %0s)",
+                sent_chars, cycles, x, first_seed, stall == 2 ? "long" : stall != 0 ? "on" : "off");
+        $display("Results waited for m_ready on %0d cycles, characters waited for s_ready on %0d",
+                result_waits, input_waits);
+        $finish;
+    end
+
+endmodule
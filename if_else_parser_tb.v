@@ -0,0 +1,155 @@
+// Reusable testbench for if_else_parser_2
+//
+// Compile once:  iverilog -o parser_tb if_else_parser_2.v if_else_parser_tb.v
+// Run:           vvp parser_tb +x=5 +stim=stimulus.hex
+// Trace:         vvp parser_tb +x=5 +trace=1 [+trace_file=trace.log]   (levels in if_else_parser_2.v)
+// No tracing:    iverilog -Pif_else_parser_tb.TRACE_MAX=0 ... compiles the parser's tracing out
+//
+// The character stream comes from a $readmemh file with one hex byte per line, as written
+// by c_parser_2. The stream ends at the first 00 byte or at the end of the file, so the same
+// compiled image serves every input and every value of x.
+`timescale 1ns / 1ps
+
+module if_else_parser_tb();
+
+    parameter MAX_CHARS = 1 << 20; // Size of the stimulus memory
+    parameter TRACE_MAX = 2;       // Highest trace level built into the parser
+
+    reg clk, rst;
+    reg signed [31:0] x;
+    reg [6:0] ascii_char;
+    reg char_valid;
+    wire signed [31:0] p;
+    wire [16*7-1:0] assignment_var;
+    wire [3:0] assignment_var_length;
+    wire parsing_done;
+    wire error_flag;
+    wire [3:0] error_code;
+
+    reg [7:0] stim_mem [0:MAX_CHARS-1];
+    reg [8*256:1] stim_file;
+    integer char_count;
+    integer sent;
+    integer timeout;
+
+    // Error codes
+    parameter NO_ERROR          = 4'd0,
+              INVALID_KEYWORD   = 4'd1,
+              VAR_MISMATCH      = 4'd2,
+              INVALID_CHAR      = 4'd3,
+              MISSING_SEMICOLON = 4'd4,
+              MISSING_OPERATOR  = 4'd5,
+              SYNTAX_ERROR      = 4'd6,
+              PAREN_MISMATCH    = 4'd7;
+
+    // Instantiate the parser
+    if_else_parser_2 #(.TRACE_MAX(TRACE_MAX)) uut (
+        .clk(clk),
+        .rst(rst),
+        .x(x),
+        .ascii_char(ascii_char),
+        .char_valid(char_valid),
+        .p(p),
+        .assignment_var(assignment_var),
+        .assignment_var_length(assignment_var_length),
+        .parsing_done(parsing_done),
+        .error_flag(error_flag),
+        .error_code(error_code)
+    );
+
+    // Generate a clock: 10 ns period
+    always #5 clk = ~clk;
+
+    // Task to send a character for one cycle.
+    task send_char(input [6:0] ch);
+    begin
+        ascii_char = ch;
+        char_valid = 1;
+        #5;
+        #5; // full clock cycle complete
+        char_valid = 0;
+    end
+    endtask
+
+    // Helper function to extract variable name from packed format
+    function [8*16:1] extract_var_name;
+        input [16*7-1:0] packed_var;
+        input [3:0] length;
+        reg [6:0] char;
+        integer i;
+    begin
+        extract_var_name = 0;
+        for (i = 0; i < length; i = i + 1) begin
+            char = (packed_var >> (i*7)) & 7'h7F;
+            extract_var_name[8*(length-i) -: 8] = char;
+        end
+    end
+    endfunction
+
+    initial begin
+        clk = 0;
+        rst = 1;
+        char_valid = 0;
+        ascii_char = 0;
+
+        // Plusargs: +x=<value> (default 0) and +stim=<hex file> (default stimulus.hex)
+        if (!$value$plusargs("x=%d", x))
+            x = 0;
+        if (!$value$plusargs("stim=%s", stim_file))
+            stim_file = "stimulus.hex";
+
+        $readmemh(stim_file, stim_mem);
+
+        // Stop at the terminating 00 byte, or at the first entry the file did not fill
+        char_count = 0;
+        while (char_count < MAX_CHARS && stim_mem[char_count] !== 8'h00 && ^stim_mem[char_count] !== 1'bx)
+            char_count = char_count + 1;
+        if (char_count == 0) begin
+            $display("Error: no stimulus in %0s", stim_file);
+            $finish;
+        end
+
+        #20;
+        rst = 0;
+
+        // Send the stream, stopping early once the parser is done or has flagged an error
+        sent = 0;
+        while (sent < char_count && !parsing_done && !error_flag) begin
+            send_char(stim_mem[sent][6:0]);
+            sent = sent + 1;
+        end
+
+        // The FSM evaluates one cycle after the last keyword, give it a few cycles
+        timeout = 0;
+        while (timeout < 8 && !parsing_done && !error_flag) begin
+            @(posedge clk);
+            timeout = timeout + 1;
+        end
+        #20;
+
+        // Display results
+        if (parsing_done && !error_flag) begin
+            $display("Test passed! Value %d assigned to the variable: %s. (var length: %d)", 
+                    p, extract_var_name(assignment_var, assignment_var_length),
+                    assignment_var_length);
+        end
+        else if (error_flag) begin
+            $display("Error: %s (%0d)", 
+                    error_code == 0 ? "No Error" :
+                    error_code == 1 ? "Invalid Keyword. One of more of the keywords 'begin', 'end', 'if', 'else' are missing or misspelled." :
+                    error_code == 2 ? "Variable Mismatch. The variable names in the true and false branch assignments do not match." :
+                    error_code == 3 ? "Invalid Character. You may have entered a character that is not allowed." :
+                    error_code == 4 ? "Missing Semicolon." :
+                    error_code == 5 ? "Missing Operator." :
+                    error_code == 6 ? "Syntax Error." :
+                    error_code == 7 ? "Parenthesis Mismatch. You may have mismatched parentheses, or parantheses at invalid places." : "Unknown Error",
+                    error_code);
+        end
+        else begin
+            $display("Parsing not finished.");
+        end
+        $display("%0d of %0d characters sent (x = %0d, stimulus %0s)", sent, char_count, x, stim_file);
+        $finish;
+    end
+
+endmodule
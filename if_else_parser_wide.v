@@ -0,0 +1,1251 @@
+// Multi-character-per-cycle variant of if_else_parser_2.
+//
+// The parser takes LANES characters per clock on a wide bus. Lane 0 holds the first character
+// in stream order, and a per-lane valid mask marks which lanes carry data. Inside a beat the
+// lanes are consumed one after another by the same per-character step as the 1-char parser,
+// so a whitespace run, a keyword or the digits of a constant finish together in a single
+// cycle. The results (p, assignment_var, parsing_done, error_code) are the ones
+// if_else_parser_2 produces for the same stream.
+//
+// A beat stops at the lane that takes the FSM to EVALUATE or ERROR, or that raises error_flag.
+// Any later lanes in that beat are dropped, just as the 1-char testbench stops sending once the
+// parser is done or has flagged an error. EVALUATE and ERROR take one cycle each and ignore the
+// bus, exactly as in if_else_parser_2.
+//
+// The step is unrolled LANES times, so the combinational path grows with LANES.
+//
+// TRACE_MAX, TRACE_SUFFIX, +trace=<level> and +trace_file=<path> work as in if_else_parser_2.
+// This module only has the level 1 messages.
+module if_else_parser_wide #(
+    parameter LANES = 4,
+    parameter TRACE_MAX = 1,
+    parameter TRACE_SUFFIX = 0
+) (
+    input  wire        clk,
+    input  wire        rst,
+    input  wire signed [31:0] x,
+    input  wire [LANES*7-1:0] ascii_chars,     // lane i in bits [i*7 +: 7]
+    input  wire [LANES-1:0]   chars_valid,     // per-lane valid mask
+    output reg signed  [31:0] p,
+    output reg         [16*7-1:0] assignment_var,  // array to support multi-char variables
+    output reg         [3:0] assignment_var_length, // Length of variable name
+    output reg         parsing_done,
+    output reg         error_flag,
+    output reg [3:0]   error_code
+);
+
+    // Error codes
+    parameter NO_ERROR            = 4'd0,
+              INVALID_KEYWORD     = 4'd1,
+              VAR_MISMATCH        = 4'd2,
+              INVALID_CHAR        = 4'd3,
+              MISSING_SEMICOLON   = 4'd4,
+              MISSING_OPERATOR    = 4'd5,
+              SYNTAX_ERROR        = 4'd6,
+              PAREN_MISMATCH      = 4'd7;
+
+    // State encoding, shared with if_else_parser_2
+    parameter IDLE                      = 0,
+              READ_IF                   = 1,
+              READ_OPEN_PAREN           = 2,
+              READ_VAR                  = 3,
+              READ_COND_OPERATOR        = 4,
+              READ_COND_OPERATOR2       = 5,
+              READ_VALC                 = 6,
+              READ_CLOSE_PAREN          = 7,
+              READ_BEGIN                = 8,
+              READ_ASSIGNMENT_VAR       = 9,
+              READ_ASSIGNMENT_OPERATOR  = 10,
+              READ_CONST1               = 11,
+              READ_SEMICOLON1           = 12,
+              READ_END1                 = 13,
+              READ_ELSE                 = 14,
+              READ_BEGIN2               = 16,
+              READ_ASSIGNMENT_VAR2      = 18,
+              READ_ASSIGNMENT_OPERATOR2 = 19,
+              READ_CONST2               = 20,
+              READ_SEMICOLON2           = 21,
+              READ_END2                 = 22,
+              EVALUATE                  = 23,
+              ERROR                     = 24;
+
+    reg [4:0] state;
+
+    // Keyword parsing support
+    reg [31:0] keyword_buffer;
+    reg [2:0]  keyword_index;
+    reg        keyword_complete;
+
+    // Variable name tracking
+    reg [6:0]  cond_var[0:15];
+    reg [3:0]  cond_var_length;
+    reg [3:0]  cond_var_idx;
+
+    reg [6:0]  assignment_var_array[0:15];
+    reg [16*7-1:0] assignment_var2;
+    reg [3:0]  assignment_var2_length;
+    reg [3:0]  assignment_var2_idx;
+    reg [6:0]  assignment_var2_array[0:15];
+    reg        var_match;
+    reg        reading_var;
+
+    // Data registers
+    integer    valC, const1, const2;
+    integer    num_buffer;
+    reg        parsing_number;
+
+    integer paren_count = 0;
+    integer whitespace_count = 0;
+
+    // Assignment type flags
+    reg        blocking_assignment1;
+    reg        blocking_assignment2;
+
+    reg [2:0] comparator;
+    parameter EQ = 3'b000, NE = 3'b001, LE = 3'b100, GE = 3'b101, LT = 3'b010, GT = 3'b011;
+
+    reg [6:0] op_first;
+
+    // Flags for negative integers valC, const1, const2
+    reg is_valC_negative, is_const1_negative, is_const2_negative;
+
+    // Next-state copies of the registers. The FSM block loads them, runs the lanes of the beat
+    // on them and commits them all with nonblocking assignments.
+    reg [4:0]  n_state;
+    reg [31:0] n_keyword_buffer;
+    reg [2:0]  n_keyword_index;
+    reg [6:0]  n_cond_var[0:15];
+    reg [3:0]  n_cond_var_length;
+    reg [3:0]  n_cond_var_idx;
+    reg [6:0]  n_assignment_var_array[0:15];
+    reg [16*7-1:0] n_assignment_var2;
+    reg [3:0]  n_assignment_var2_length;
+    reg [3:0]  n_assignment_var2_idx;
+    reg [6:0]  n_assignment_var2_array[0:15];
+    reg        n_var_match;
+    reg        n_reading_var;
+    integer    n_valC, n_const1, n_const2;
+    integer    n_num_buffer;
+    reg        n_parsing_number;
+    integer    n_paren_count;
+    integer    n_whitespace_count;
+    reg        n_blocking_assignment1;
+    reg        n_blocking_assignment2;
+    reg [2:0]  n_comparator;
+    reg [6:0]  n_op_first;
+    reg        n_is_valC_negative, n_is_const1_negative, n_is_const2_negative;
+    reg signed [31:0] n_p;
+    reg [16*7-1:0] n_assignment_var;
+    reg [3:0]  n_assignment_var_length;
+    reg        n_parsing_done;
+    reg        n_error_flag;
+    reg [3:0]  n_error_code;
+
+    integer lane, i;
+
+    // Trace control
+    integer trace_level;
+    integer trace_fd;
+    reg [8*256:1] trace_file;
+
+    // Set here rather than in the declarations, which could run after this block
+    initial begin
+        trace_level = 0;
+        trace_fd = 32'h8000_0001; // stdout
+        if (TRACE_MAX > 0) begin
+            if (!$value$plusargs("trace=%d", trace_level))
+                trace_level = 0;
+            if (trace_level > TRACE_MAX)
+                trace_level = TRACE_MAX;
+            if (trace_level > 0 && $value$plusargs("trace_file=%s", trace_file)) begin
+                if (TRACE_SUFFIX)
+                    $sformat(trace_file, "%0s.%m", trace_file);
+                trace_fd = $fopen(trace_file, "w");
+                if (trace_fd == 0) begin
+                    $display("Cannot open trace file %0s, tracing to stdout", trace_file);
+                    trace_fd = 32'h8000_0001;
+                end
+            end
+        end
+    end
+
+    // Function to check if variable names match
+    function var_names_match;
+        input integer max_idx;
+        integer k;
+        begin
+            if (n_assignment_var_length != n_assignment_var2_length) begin
+                var_names_match = 0;
+            end else begin
+                var_names_match = 1;
+                for (k = 0; k < n_assignment_var_length; k = k + 1) begin
+                    if (n_assignment_var_array[k] != n_assignment_var2_array[k]) begin
+                        var_names_match = 0;
+                        if (TRACE_MAX >= 1 && trace_level >= 1)
+                            $fwrite(trace_fd, "Mismatch at position %0d: '%c' vs '%c'\n",
+                                    k, n_assignment_var_array[k], n_assignment_var2_array[k]);
+                    end
+                end
+            end
+        end
+    endfunction
+
+    // One character of if_else_parser_2's FSM, run on the next-state copies. They are updated
+    // with blocking assignments so the next lane of the beat sees this lane's result; every
+    // copy is read before it is written, which keeps the 1-char parser's nonblocking semantics.
+    task step(input [6:0] ch, input new_char);
+        reg is_digit, is_letter, is_underscore, is_id_start, is_id_char, is_whitespace;
+        reg names_match;
+        begin
+            is_digit = (ch >= "0" && ch <= "9");
+            is_letter = ((ch >= "a" && ch <= "z") || (ch >= "A" && ch <= "Z"));
+            is_underscore = (ch == "_");
+            is_id_start = is_letter;
+            is_id_char = is_letter || is_digit || is_underscore;
+            is_whitespace = (ch == " " || ch == "\t" || ch == "\n");
+
+            case(n_state)
+                IDLE: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = IDLE;
+                        end
+                        else if(ch == "i") begin
+                            n_keyword_index = 1;
+                            n_state = READ_IF;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_IF: begin
+                    if(new_char) begin
+                        if(ch == "f") begin
+                            n_keyword_index = 0;
+                            n_state = READ_OPEN_PAREN;
+                        end else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_OPEN_PAREN: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = READ_OPEN_PAREN;
+                        end
+                        else if(ch == "(") begin
+                            n_paren_count = n_paren_count + 1;
+                            n_state = READ_VAR;
+                            n_cond_var_idx = 0;
+                            n_cond_var_length = 0;
+                            n_reading_var = 0;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_VAR: begin
+                    if(new_char) begin
+                        if(is_whitespace && !n_reading_var) begin
+                            n_state = READ_VAR;
+                        end
+                        else if(!n_reading_var && is_id_start) begin
+                            n_cond_var[0] = ch;
+                            n_cond_var_idx = 1;
+                            n_cond_var_length = 1;
+                            n_reading_var = 1;
+                        end
+                        else if(n_reading_var && is_id_char) begin
+                            n_cond_var[n_cond_var_idx] = ch;
+                            if(n_cond_var_idx == 15) begin  // Max length reached
+                                n_state = READ_COND_OPERATOR;
+                                n_reading_var = 0;
+                            end
+                            n_cond_var_idx = n_cond_var_idx + 1;
+                            n_cond_var_length = n_cond_var_length + 1;
+                        end
+                        else if(ch == ")" && n_reading_var) begin
+                            n_paren_count = n_paren_count - 1;
+                        end
+                        else if(n_reading_var && (is_whitespace || ch == ">" || ch == "<" ||
+                                ch == "=" || ch == "!")) begin
+                            n_state = READ_COND_OPERATOR;
+                            n_reading_var = 0;
+
+                            if(!is_whitespace) begin
+                                if(n_paren_count == 0) begin
+                                    n_error_flag = 1;
+                                    n_error_code = SYNTAX_ERROR;
+                                    n_state = ERROR;
+                                end
+                                n_op_first = ch;
+                                n_state = READ_COND_OPERATOR2;
+                            end
+                        end
+                        else if(ch == "(") begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_COND_OPERATOR: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = READ_COND_OPERATOR;
+                        end
+                        else if(ch == ")") begin
+                            if(n_paren_count == 0) begin
+                                n_error_flag = 1;
+                                n_error_code = PAREN_MISMATCH;
+                                n_state = ERROR;
+                            end
+                            n_paren_count = n_paren_count - 1;
+                        end
+                        else if(ch == "<" || ch == ">" || ch == "=" || ch == "!") begin
+                            if(n_paren_count == 0) begin
+                                n_error_flag = 1;
+                                n_error_code = PAREN_MISMATCH;
+                                n_state = ERROR;
+                            end
+                            n_op_first = ch;
+                            n_state = READ_COND_OPERATOR2;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_CHAR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_COND_OPERATOR2: begin
+                    if(new_char) begin
+                        if(ch == "-") begin
+                            n_is_valC_negative = 1;
+                        end
+                        case(n_op_first)
+                            "<": begin
+                                if(ch == "=") begin
+                                    n_comparator = LE;
+                                    n_state = READ_VALC;
+                                end
+                                else if(is_digit) begin
+                                    n_comparator = LT;
+                                    n_num_buffer = (n_num_buffer * 10) + (ch - "0");
+                                    n_parsing_number = 1;
+                                    n_state = READ_VALC;
+                                end
+                                else if(ch == "(") begin
+                                    n_paren_count = n_paren_count + 1;
+                                    n_state = READ_VALC;
+                                end
+                                else begin
+                                    n_error_flag = 1;
+                                    n_error_code = SYNTAX_ERROR;
+                                    n_state = ERROR;
+                                end
+                            end
+                            ">": begin
+                                if(ch == "=") begin
+                                    n_comparator = GE;
+                                    n_state = READ_VALC;
+                                end
+                                else if(is_digit) begin
+                                    n_comparator = GT;
+                                    n_num_buffer = (n_num_buffer * 10) + (ch - "0");
+                                    n_parsing_number = 1;
+                                    n_state = READ_VALC;
+                                end
+                                else if(ch == "(") begin
+                                    n_paren_count = n_paren_count + 1;
+                                    n_state = READ_VALC;
+                                end
+                                else begin
+                                    n_error_flag = 1;
+                                    n_error_code = SYNTAX_ERROR;
+                                    n_state = ERROR;
+                                end
+                            end
+                            "=": begin
+                                if(ch == "=") begin
+                                    n_comparator = EQ;
+                                    n_state = READ_VALC;
+                                end
+                                else begin
+                                    n_error_flag = 1;
+                                    n_error_code = MISSING_OPERATOR;
+                                    n_state = ERROR;
+                                end
+                            end
+                            "!": begin
+                                if(ch == "=") begin
+                                    n_comparator = NE;
+                                    n_state = READ_VALC;
+                                end
+                                else begin
+                                    n_error_flag = 1;
+                                    n_error_code = MISSING_OPERATOR;
+                                    n_state = ERROR;
+                                end
+                            end
+                            default: begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                READ_VALC: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = READ_VALC;
+                        end
+                        else if(ch == "-" && !n_parsing_number) begin
+                            n_is_valC_negative = 1;
+                        end
+                        else if(ch == "(" && !n_parsing_number) begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else if(is_digit) begin
+                            n_num_buffer = (n_num_buffer * 10) + (ch - "0");
+                            n_parsing_number = 1;
+                        end
+                        else if(n_parsing_number) begin
+                            if(n_is_valC_negative)
+                                n_valC = -n_num_buffer;
+                            else
+                                n_valC = n_num_buffer;
+
+                            n_num_buffer = 0;
+                            n_parsing_number = 0;
+
+                            if(ch == ")") begin
+                                if(n_paren_count == 0) begin
+                                    n_error_flag = 1;
+                                    n_error_code = PAREN_MISMATCH;
+                                    n_state = ERROR;
+                                end
+                                n_paren_count = n_paren_count - 1;
+                                n_state = READ_CLOSE_PAREN;
+                            end
+                            else begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        end
+                    end
+                end
+
+                READ_CLOSE_PAREN: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = READ_CLOSE_PAREN;
+                        end
+                        else if(ch == "b") begin
+                            n_keyword_index = 1;
+                            n_keyword_buffer = "b";
+                            if(n_paren_count != 0) begin
+                                n_error_flag = 1;
+                                n_error_code = PAREN_MISMATCH;
+                                n_state = ERROR;
+                            end
+                            n_state = READ_BEGIN;
+                        end
+                        else if(ch == ")") begin
+                            n_paren_count = n_paren_count - 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_BEGIN: begin
+                    if(new_char) begin
+                        case(n_keyword_index)
+                            1: if(ch == "e") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "e";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            2: if(ch == "g") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "g";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            3: if(ch == "i") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "i";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            4: if(ch == "n") begin
+                                n_whitespace_count = 0;
+                                n_keyword_index = 0;
+                                n_state = READ_ASSIGNMENT_VAR;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            default: begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                READ_ASSIGNMENT_VAR: begin
+                    if(new_char) begin
+                        if(is_whitespace) n_whitespace_count = n_whitespace_count + 1;
+                        else if(n_whitespace_count == 0) begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                        else if(is_whitespace && !n_reading_var) begin
+                            n_state = READ_ASSIGNMENT_VAR;
+                        end
+                        else if(!n_reading_var && is_id_start) begin
+                            n_assignment_var_array[0] = ch;
+                            n_assignment_var_length = 1;
+                            n_cond_var_idx = 1; // Reuse this counter for tracking position
+                            n_reading_var = 1;
+                        end
+                        else if(n_reading_var && is_id_char) begin
+                            n_assignment_var_array[n_cond_var_idx] = ch;
+                            if(n_cond_var_idx == 15) begin  // Max length reached
+                                n_state = READ_ASSIGNMENT_OPERATOR;
+                                n_reading_var = 0;
+                            end
+                            n_cond_var_idx = n_cond_var_idx + 1;
+                            n_assignment_var_length = n_assignment_var_length + 1;
+                        end
+                        else if(ch == ")" && n_reading_var) begin
+                            n_paren_count = n_paren_count - 1;
+                        end
+                        else if(n_reading_var && (is_whitespace || ch == "=" || ch == "<")) begin
+                            n_state = READ_ASSIGNMENT_OPERATOR;
+                            n_reading_var = 0;
+
+                            if(!is_whitespace) begin
+                                if(ch == "<") begin
+                                    n_blocking_assignment1 = 0;
+                                    n_op_first = "<";
+                                end
+                                else if(ch == "=") begin
+                                    n_blocking_assignment1 = 1;
+                                    n_op_first = 0;
+                                    n_num_buffer = 0;
+                                    n_parsing_number = 0;
+                                    n_is_const1_negative = 0;
+                                    n_state = READ_CONST1;
+                                end
+                            end
+                        end
+                        else if(ch == "(") begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_ASSIGNMENT_OPERATOR: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_whitespace_count = n_whitespace_count + 1;
+                            n_state = READ_ASSIGNMENT_OPERATOR;
+                        end
+                        else if(n_whitespace_count == 0) begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                        else if(ch == ")") n_paren_count = n_paren_count - 1;
+                        else if(ch == "<") begin
+                            n_blocking_assignment1 = 0;
+                            n_state = READ_ASSIGNMENT_OPERATOR;
+                        end
+                        else if(ch == "=") begin
+                            if(n_op_first == "<") begin
+                                n_blocking_assignment1 = 0;
+                            end else begin
+                                n_blocking_assignment1 = 1;
+                            end
+                            n_op_first = 0;
+                            n_num_buffer = 0;
+                            n_parsing_number = 0;
+                            n_is_const1_negative = 0;
+                            n_state = READ_CONST1;
+                        end
+                        else begin
+                            n_op_first = ch;
+                        end
+                    end
+                end
+
+                READ_CONST1: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            if(n_is_const1_negative || n_parsing_number) begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                            else begin
+                                n_state = READ_CONST1;
+                            end
+                        end
+                        else if(ch == "(" && !n_parsing_number) begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else if(ch == ")") begin
+                            if(n_num_buffer == 0) begin
+                                n_error_flag = 1;
+                                n_error_code = PAREN_MISMATCH;
+                                n_state = ERROR;
+                            end
+                            else begin
+                                n_paren_count = n_paren_count - 1;
+                            end
+                        end
+                        else if(ch == "-" && !n_parsing_number) begin
+                            n_is_const1_negative = 1;
+                        end
+                        else if(is_digit) begin
+                            n_num_buffer = (n_num_buffer * 10) + (ch - "0");
+                            n_parsing_number = 1;
+                        end
+                        else if(n_parsing_number) begin
+                            if(n_is_const1_negative)
+                                n_const1 = -n_num_buffer;
+                            else
+                                n_const1 = n_num_buffer;
+
+                            n_num_buffer = 0;
+                            n_parsing_number = 0;
+
+                            if(ch == ";") begin
+                                n_state = READ_SEMICOLON1;
+                            end
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_SEMICOLON1: begin
+                    if(new_char) begin
+                        if(n_paren_count != 0) begin
+                            n_error_flag = 1;
+                            n_error_code = PAREN_MISMATCH;
+                            n_state = ERROR;
+                        end
+                        if(is_whitespace) begin
+                            n_state = READ_SEMICOLON1;
+                        end
+                        else if(ch == "e") begin
+                            n_keyword_index = 1;
+                            n_keyword_buffer = "e";
+                            n_state = READ_END1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_END1: begin
+                    if(new_char) begin
+                        case(n_keyword_index)
+                            1: if(ch == "n") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "n";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            2: if(ch == "d") begin
+                                n_whitespace_count = 0;
+                                n_keyword_index = 0;
+                                n_state = READ_ELSE;
+                            end
+
+                            default: begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                READ_ELSE: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_whitespace_count = n_whitespace_count + 1;
+                            n_state = READ_ELSE;
+                        end
+                        else if(n_whitespace_count == 0) begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                        else if(ch == "e") begin
+                            n_keyword_index = 1;
+                            n_keyword_buffer = "e";
+                            n_state = READ_ELSE + 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_ELSE + 1: begin
+                    if(new_char) begin
+                        case(n_keyword_index)
+                            1: if(ch == "l") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "l";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            2: if(ch == "s") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "s";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            3: if(ch == "e") begin
+                                n_whitespace_count = 0;
+                                n_keyword_index = 0;
+                                n_state = READ_BEGIN2;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            default: begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                READ_BEGIN2: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_whitespace_count = n_whitespace_count + 1;
+                            n_state = READ_BEGIN2;
+                        end
+                        else if(n_whitespace_count == 0) begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                        else if(ch == "b") begin
+                            n_keyword_index = 1;
+                            n_keyword_buffer = "b";
+                            n_state = READ_BEGIN2 + 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_BEGIN2 + 1: begin
+                    if(new_char) begin
+                        case(n_keyword_index)
+                            1: if(ch == "e") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "e";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            2: if(ch == "g") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "g";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            3: if(ch == "i") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "i";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            4: if(ch == "n") begin
+                                n_whitespace_count = 0;
+                                n_keyword_index = 0;
+                                n_state = READ_ASSIGNMENT_VAR2;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                READ_ASSIGNMENT_VAR2: begin
+                    if(new_char) begin
+                        if(is_whitespace && !n_reading_var) begin
+                            n_whitespace_count = n_whitespace_count + 1;
+                            n_state = READ_ASSIGNMENT_VAR2;
+                        end
+                        else if(!is_whitespace && n_whitespace_count == 0) begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                        else if(!n_reading_var && is_id_start) begin
+                            n_assignment_var2_array[0] = ch;
+                            n_assignment_var2_idx = 1;
+                            n_assignment_var2_length = 1;
+                            n_reading_var = 1;
+                        end
+                        else if(n_reading_var && is_id_char) begin
+                            if(n_assignment_var2_idx == 15) begin  // Max length reached
+                                // Compared before this character is stored, as in the 1-char parser
+                                names_match = var_names_match(15);
+                                n_state = READ_ASSIGNMENT_OPERATOR2;
+                                n_reading_var = 0;
+                                n_var_match = names_match;
+                                if(!names_match) begin
+                                    n_error_flag = 1;
+                                    n_error_code = VAR_MISMATCH;
+                                    n_state = ERROR;
+                                    if (TRACE_MAX >= 1 && trace_level >= 1)
+                                        $fwrite(trace_fd, "ERROR: Variables mismatch between branches!\n");
+                                end
+                            end
+                            n_assignment_var2_array[n_assignment_var2_idx] = ch;
+                            n_assignment_var2_idx = n_assignment_var2_idx + 1;
+                            n_assignment_var2_length = n_assignment_var2_length + 1;
+                        end
+                        else if(ch == ")" && n_reading_var) begin
+                            n_paren_count = n_paren_count - 1;
+                        end
+                        else if(n_reading_var && (is_whitespace || ch == "=" || ch == "<")) begin
+                            n_state = READ_ASSIGNMENT_OPERATOR2;
+                            n_reading_var = 0;
+
+                            names_match = var_names_match(15);
+                            n_var_match = names_match;
+                            if(!names_match) begin
+                                n_error_flag = 1;
+                                n_error_code = VAR_MISMATCH;
+                                n_state = ERROR;
+                                if (TRACE_MAX >= 1 && trace_level >= 1)
+                                    $fwrite(trace_fd, "ERROR: Variables mismatch between branches!\n");
+                            end
+
+                            if(!is_whitespace) begin
+                                if(ch == "<") begin
+                                    n_blocking_assignment2 = 0;
+                                    n_op_first = "<";
+                                end
+                                else if(ch == "=") begin
+                                    n_blocking_assignment2 = 1;
+                                    n_op_first = 0;
+                                    n_num_buffer = 0;
+                                    n_parsing_number = 0;
+                                    n_is_const2_negative = 0;
+                                    n_state = READ_CONST2;
+                                end
+                            end
+                        end
+                        else if(ch == "(") begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_ASSIGNMENT_OPERATOR2: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            n_state = READ_ASSIGNMENT_OPERATOR2;
+                        end
+                        else if(ch == ")") n_paren_count = n_paren_count - 1;
+                        else if(ch == "<") begin
+                            n_blocking_assignment2 = 0;
+                            n_state = READ_ASSIGNMENT_OPERATOR2;
+                        end
+                        else if(ch == "=") begin
+                            if(n_op_first == "<") begin
+                                n_blocking_assignment2 = 0;
+                            end else begin
+                                n_blocking_assignment2 = 1;
+                            end
+                            n_op_first = 0;
+                            n_num_buffer = 0;
+                            n_parsing_number = 0;
+                            n_is_const2_negative = 0;
+                            n_state = READ_CONST2;
+                        end
+                        else begin
+                            n_op_first = ch;
+                        end
+                    end
+                end
+
+                READ_CONST2: begin
+                    if(new_char) begin
+                        if(is_whitespace) begin
+                            if(n_is_const2_negative || n_parsing_number) begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                            else begin
+                                n_state = READ_CONST2;
+                            end
+                        end
+                        else if(ch == "(" && !n_parsing_number) begin
+                            n_paren_count = n_paren_count + 1;
+                        end
+                        else if(ch == ")") begin
+                            if(n_num_buffer == 0) begin
+                                n_error_flag = 1;
+                                n_error_code = PAREN_MISMATCH;
+                                n_state = ERROR;
+                            end
+                            else begin
+                                n_paren_count = n_paren_count - 1;
+                            end
+                        end
+                        else if(ch == "-" && !n_parsing_number) begin
+                            n_is_const2_negative = 1;
+                        end
+                        else if(is_digit) begin
+                            n_num_buffer = (n_num_buffer * 10) + (ch - "0");
+                            n_parsing_number = 1;
+                        end
+                        else if(n_parsing_number) begin
+                            if(n_is_const2_negative)
+                                n_const2 = -n_num_buffer;
+                            else
+                                n_const2 = n_num_buffer;
+
+                            n_num_buffer = 0;
+                            n_parsing_number = 0;
+
+                            if(ch == ";") begin
+                                n_state = READ_SEMICOLON2;
+                            end
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_SEMICOLON2: begin
+                    if(new_char) begin
+                        if(n_paren_count != 0) begin
+                            n_error_flag = 1;
+                            n_error_code = SYNTAX_ERROR;
+                            n_state = ERROR;
+                        end
+                        if(is_whitespace) begin
+                            n_state = READ_SEMICOLON2;
+                        end
+                        else if(ch == "e") begin
+                            n_keyword_index = 1;
+                            n_keyword_buffer = "e";
+                            n_state = READ_END2;
+                        end
+                        else begin
+                            n_error_flag = 1;
+                            n_error_code = INVALID_KEYWORD;
+                            n_state = ERROR;
+                        end
+                    end
+                end
+
+                READ_END2: begin
+                    if(new_char) begin
+                        case(n_keyword_index)
+                            1: if(ch == "n") begin
+                                n_keyword_buffer = (n_keyword_buffer << 8) | "n";
+                                n_keyword_index = n_keyword_index + 1;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            2: if(ch == "d") begin
+                                n_keyword_index = 0;
+                                n_state = EVALUATE;
+                            end else begin
+                                n_error_flag = 1;
+                                n_error_code = INVALID_KEYWORD;
+                                n_state = ERROR;
+                            end
+
+                            default: begin
+                                n_error_flag = 1;
+                                n_error_code = SYNTAX_ERROR;
+                                n_state = ERROR;
+                            end
+                        endcase
+                    end
+                end
+
+                EVALUATE: begin
+                    if(n_parsing_done) begin
+                        n_state = IDLE;
+                    end
+
+                    if(!n_parsing_done && TRACE_MAX >= 1 && trace_level >= 1) begin
+                        $fwrite(trace_fd, "EVALUATING: x=%d, valC=%d, comparator=%b, const1=%d, const2=%d\n",
+                        x, n_valC, n_comparator, n_const1, n_const2);
+                    end
+
+                    if(!n_error_flag) begin
+                        case(n_comparator)
+                            EQ:  if(x == n_valC) n_p = n_const1; else n_p = n_const2;
+                            NE:  if(x != n_valC) n_p = n_const1; else n_p = n_const2;
+                            LT:  if(x <  n_valC) n_p = n_const1; else n_p = n_const2;
+                            GT:  if(x >  n_valC) n_p = n_const1; else n_p = n_const2;
+                            LE:  if(x <= n_valC) n_p = n_const1; else n_p = n_const2;
+                            GE:  if(x >= n_valC) n_p = n_const1; else n_p = n_const2;
+                            default: n_p = 0;
+                        endcase
+                        n_parsing_done = 1;
+                    end
+                end
+
+                ERROR: begin
+                    n_parsing_done = 0;
+                    n_p = 0;
+                    n_assignment_var = 0;
+                    n_assignment_var_length = 0;
+                end
+
+                default: begin
+                    if(n_error_flag) begin
+                        n_state = ERROR;
+                    end
+                    else n_state = IDLE;
+                end
+            endcase
+        end
+    endtask
+
+    // FSM. A beat runs on the next-state copies, loaded from the registers, and every register
+    // and output is committed with a single nonblocking assignment at the end.
+    always @(posedge clk or posedge rst) begin
+        if(rst) begin
+            state               <= IDLE;
+            keyword_buffer      <= 0;
+            keyword_index       <= 0;
+            keyword_complete    <= 0;
+            cond_var_length     <= 0;
+            cond_var_idx        <= 0;
+            assignment_var_length  <= 0;
+            assignment_var2_length <= 0;
+            assignment_var2_idx <= 0;
+            var_match           <= 0;
+            reading_var         <= 0;
+            valC                <= 0;
+            is_valC_negative    <= 0;
+            const1              <= 0;
+            is_const1_negative  <= 0;
+            const2              <= 0;
+            is_const2_negative  <= 0;
+            num_buffer          <= 0;
+            parsing_number      <= 0;
+            parsing_done        <= 0;
+            error_flag          <= 0;
+            error_code          <= NO_ERROR;
+            comparator          <= 0;
+            op_first            <= 0;
+            blocking_assignment1 <= 0;
+            blocking_assignment2 <= 0;
+            p                    <= 0;
+            assignment_var       <= 0;
+            assignment_var2      <= 0;
+            paren_count          <= 0;
+            whitespace_count     <= 0;
+            for (i = 0; i < 16; i = i + 1) begin
+                cond_var[i] <= 0;
+                assignment_var_array[i] <= 0;
+                assignment_var2_array[i] <= 0;
+            end
+        end
+        else begin
+            n_state                  = state;
+            n_keyword_buffer         = keyword_buffer;
+            n_keyword_index          = keyword_index;
+            n_cond_var_length        = cond_var_length;
+            n_cond_var_idx           = cond_var_idx;
+            n_assignment_var2        = assignment_var2;
+            n_assignment_var2_length = assignment_var2_length;
+            n_assignment_var2_idx    = assignment_var2_idx;
+            n_var_match              = var_match;
+            n_reading_var            = reading_var;
+            n_valC                   = valC;
+            n_const1                 = const1;
+            n_const2                 = const2;
+            n_num_buffer             = num_buffer;
+            n_parsing_number         = parsing_number;
+            n_paren_count            = paren_count;
+            n_whitespace_count       = whitespace_count;
+            n_blocking_assignment1   = blocking_assignment1;
+            n_blocking_assignment2   = blocking_assignment2;
+            n_comparator             = comparator;
+            n_op_first               = op_first;
+            n_is_valC_negative       = is_valC_negative;
+            n_is_const1_negative     = is_const1_negative;
+            n_is_const2_negative     = is_const2_negative;
+            n_p                      = p;
+            n_assignment_var         = assignment_var;
+            n_assignment_var_length  = assignment_var_length;
+            n_parsing_done           = parsing_done;
+            n_error_flag             = error_flag;
+            n_error_code             = error_code;
+            for (i = 0; i < 16; i = i + 1) begin
+                n_cond_var[i] = cond_var[i];
+                n_assignment_var_array[i] = assignment_var_array[i];
+                n_assignment_var2_array[i] = assignment_var2_array[i];
+            end
+
+            if(n_state < EVALUATE) begin
+                // Consume the lanes in order until the beat is used up or the FSM leaves the reading states
+                for (lane = 0; lane < LANES; lane = lane + 1) begin
+                    if(chars_valid[lane] && n_state < EVALUATE && !n_error_flag)
+                        step(ascii_chars[lane*7 +: 7], 1'b1);
+                end
+
+                // Pack the assignment variables as soon as the block is complete
+                if(n_state == EVALUATE) begin
+                    n_assignment_var = 0;
+                    n_assignment_var2 = 0;
+                    for (i = 0; i < n_assignment_var_length; i = i + 1)
+                        n_assignment_var = n_assignment_var | (n_assignment_var_array[i] << (i*7));
+                    for (i = 0; i < n_assignment_var2_length; i = i + 1)
+                        n_assignment_var2 = n_assignment_var2 | (n_assignment_var2_array[i] << (i*7));
+                end
+            end
+            else begin
+                step(7'd0, 1'b0);
+            end
+
+            state                  <= n_state;
+            keyword_buffer         <= n_keyword_buffer;
+            keyword_index          <= n_keyword_index;
+            cond_var_length        <= n_cond_var_length;
+            cond_var_idx           <= n_cond_var_idx;
+            assignment_var2        <= n_assignment_var2;
+            assignment_var2_length <= n_assignment_var2_length;
+            assignment_var2_idx    <= n_assignment_var2_idx;
+            var_match              <= n_var_match;
+            reading_var            <= n_reading_var;
+            valC                   <= n_valC;
+            const1                 <= n_const1;
+            const2                 <= n_const2;
+            num_buffer             <= n_num_buffer;
+            parsing_number         <= n_parsing_number;
+            paren_count            <= n_paren_count;
+            whitespace_count       <= n_whitespace_count;
+            blocking_assignment1   <= n_blocking_assignment1;
+            blocking_assignment2   <= n_blocking_assignment2;
+            comparator             <= n_comparator;
+            op_first               <= n_op_first;
+            is_valC_negative       <= n_is_valC_negative;
+            is_const1_negative     <= n_is_const1_negative;
+            is_const2_negative     <= n_is_const2_negative;
+            p                      <= n_p;
+            assignment_var         <= n_assignment_var;
+            assignment_var_length  <= n_assignment_var_length;
+            parsing_done           <= n_parsing_done;
+            error_flag             <= n_error_flag;
+            error_code             <= n_error_code;
+            for (i = 0; i < 16; i = i + 1) begin
+                cond_var[i] <= n_cond_var[i];
+                assignment_var_array[i] <= n_assignment_var_array[i];
+                assignment_var2_array[i] <= n_assignment_var2_array[i];
+            end
+        end
+    end
+
+endmodule
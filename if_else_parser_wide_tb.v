@@ -0,0 +1,201 @@
+// Side-by-side testbench for if_else_parser_wide and if_else_parser_2
+//
+// Compile once:  iverilog -o parser_wide_tb if_else_parser_2.v if_else_parser_wide.v if_else_parser_wide_tb.v
+// Run:           vvp parser_wide_tb +x=5 +stim=stimulus.hex
+//
+// Both parsers get the same $readmemh stream (see if_else_parser_tb.v): the 1-char parser one
+// character per cycle, the wide parser LANES characters per cycle. The testbench checks that
+// both end with the same p, assignment_var, parsing_done and error_code, and reports how many
+// cycles each one took. Override the lane count with -Pif_else_parser_wide_tb.LANES=8.
+//
+// The stimulus may hold several blocks, each one ended by a 00 byte and the last one by 00 00.
+// Both parsers are reset before every block, and the testbench prints one line per block and a
+// count of the blocks whose results differ. With +trace_file=t.log each parser writes its own
+// trace, t.log.if_else_parser_wide_tb.uut_1 and t.log.if_else_parser_wide_tb.uut_n.
+`timescale 1ns / 1ps
+
+module if_else_parser_wide_tb();
+
+    parameter MAX_CHARS = 1 << 20; // Size of the stimulus memory
+    parameter LANES = 4;
+
+    reg clk, rst;
+    reg signed [31:0] x;
+
+    // 1-char parser
+    reg [6:0] ascii_char;
+    reg char_valid;
+    wire signed [31:0] p_1;
+    wire [16*7-1:0] assignment_var_1;
+    wire [3:0] assignment_var_length_1;
+    wire parsing_done_1;
+    wire error_flag_1;
+    wire [3:0] error_code_1;
+
+    // Wide parser
+    reg [LANES*7-1:0] ascii_chars;
+    reg [LANES-1:0] chars_valid;
+    wire signed [31:0] p_n;
+    wire [16*7-1:0] assignment_var_n;
+    wire [3:0] assignment_var_length_n;
+    wire parsing_done_n;
+    wire error_flag_n;
+    wire [3:0] error_code_n;
+
+    reg [7:0] stim_mem [0:MAX_CHARS-1];
+    reg [8*256:1] stim_file;
+    integer start, char_count, total_chars;
+    integer blocks, mismatches;
+    integer sent_1, sent_n;
+    integer cycles_1, cycles_n;
+    integer timeout_1, timeout_n;
+    integer lane;
+
+    if_else_parser_2 #(.TRACE_SUFFIX(1)) uut_1 (
+        .clk(clk),
+        .rst(rst),
+        .x(x),
+        .ascii_char(ascii_char),
+        .char_valid(char_valid),
+        .p(p_1),
+        .assignment_var(assignment_var_1),
+        .assignment_var_length(assignment_var_length_1),
+        .parsing_done(parsing_done_1),
+        .error_flag(error_flag_1),
+        .error_code(error_code_1)
+    );
+
+    if_else_parser_wide #(.LANES(LANES), .TRACE_SUFFIX(1)) uut_n (
+        .clk(clk),
+        .rst(rst),
+        .x(x),
+        .ascii_chars(ascii_chars),
+        .chars_valid(chars_valid),
+        .p(p_n),
+        .assignment_var(assignment_var_n),
+        .assignment_var_length(assignment_var_length_n),
+        .parsing_done(parsing_done_n),
+        .error_flag(error_flag_n),
+        .error_code(error_code_n)
+    );
+
+    // Generate a clock: 10 ns period
+    always #5 clk = ~clk;
+
+    // Count the cycles each parser spends before it is done or has flagged an error
+    always @(posedge clk) begin
+        if (!rst && !parsing_done_1 && !error_flag_1)
+            cycles_1 <= cycles_1 + 1;
+        if (!rst && !parsing_done_n && !error_flag_n)
+            cycles_n <= cycles_n + 1;
+    end
+
+    initial begin
+        clk = 0;
+        rst = 1;
+        char_valid = 0;
+        ascii_char = 0;
+        chars_valid = 0;
+        ascii_chars = 0;
+        cycles_1 = 0;
+        cycles_n = 0;
+
+        if (!$value$plusargs("x=%d", x))
+            x = 0;
+        if (!$value$plusargs("stim=%s", stim_file))
+            stim_file = "stimulus.hex";
+
+        $readmemh(stim_file, stim_mem);
+
+        start = 0;
+        blocks = 0;
+        mismatches = 0;
+        total_chars = 0;
+        while (start < MAX_CHARS && stim_mem[start] !== 8'h00 && ^stim_mem[start] !== 1'bx) begin
+            char_count = 0;
+            while (start + char_count < MAX_CHARS && stim_mem[start + char_count] !== 8'h00 &&
+                   ^stim_mem[start + char_count] !== 1'bx)
+                char_count = char_count + 1;
+
+            rst = 1;
+            #20;
+            rst = 0;
+
+            fork
+                // One character per cycle
+                begin
+                    sent_1 = 0;
+                    while (sent_1 < char_count && !parsing_done_1 && !error_flag_1) begin
+                        ascii_char = stim_mem[start + sent_1][6:0];
+                        char_valid = 1;
+                        #10;
+                        char_valid = 0;
+                        sent_1 = sent_1 + 1;
+                    end
+                    timeout_1 = 0;
+                    while (timeout_1 < 8 && !parsing_done_1 && !error_flag_1) begin
+                        #10;
+                        timeout_1 = timeout_1 + 1;
+                    end
+                end
+                // LANES characters per cycle, the last beat padded with invalid lanes
+                begin
+                    sent_n = 0;
+                    while (sent_n < char_count && !parsing_done_n && !error_flag_n) begin
+                        ascii_chars = 0;
+                        chars_valid = 0;
+                        for (lane = 0; lane < LANES && sent_n < char_count; lane = lane + 1) begin
+                            ascii_chars[lane*7 +: 7] = stim_mem[start + sent_n][6:0];
+                            chars_valid[lane] = 1'b1;
+                            sent_n = sent_n + 1;
+                        end
+                        #10;
+                        chars_valid = 0;
+                    end
+                    timeout_n = 0;
+                    while (timeout_n < 8 && !parsing_done_n && !error_flag_n) begin
+                        #10;
+                        timeout_n = timeout_n + 1;
+                    end
+                end
+            join
+            #20;
+
+            if (parsing_done_n && !error_flag_n)
+                $display("block %0d: %0d-lane parser: value %0d assigned (var length %0d)",
+                        blocks, LANES, p_n, assignment_var_length_n);
+            else if (error_flag_n)
+                $display("block %0d: %0d-lane parser: error code %0d", blocks, LANES, error_code_n);
+            else
+                $display("block %0d: %0d-lane parser: parsing not finished", blocks, LANES);
+
+            if (!(p_1 === p_n && assignment_var_1 === assignment_var_n &&
+                  assignment_var_length_1 === assignment_var_length_n &&
+                  parsing_done_1 === parsing_done_n && error_flag_1 === error_flag_n &&
+                  error_code_1 === error_code_n)) begin
+                $display("MISMATCH in block %0d: 1-char p=%0d done=%0d error=%0d, %0d-lane p=%0d done=%0d error=%0d",
+                        blocks, p_1, parsing_done_1, error_code_1, LANES, p_n, parsing_done_n, error_code_n);
+                mismatches = mismatches + 1;
+            end
+
+            total_chars = total_chars + char_count;
+            blocks = blocks + 1;
+            start = start + char_count + 1;
+        end
+
+        if (blocks == 0) begin
+            $display("Error: no stimulus in %0s", stim_file);
+            $finish;
+        end
+
+        if (mismatches == 0)
+            $display("Results match the 1-char parser in %0d blocks.", blocks);
+        else
+            $display("MISMATCH: %0d of %0d blocks differ from the 1-char parser.", mismatches, blocks);
+
+        $display("%0d characters: 1-char parser %0d cycles, %0d-lane parser %0d cycles (%0.2fx fewer)",
+                total_chars, cycles_1, LANES, cycles_n, cycles_1 * 1.0 / (cycles_n > 0 ? cycles_n : 1));
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,4301 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "carser.h"
+
+// Most variables per block whose positions are found by a scan, see Assignments below
+#define LINEAR_ASSIGNMENTS 8
+
+// Forget the assignments of the block, clearing any slots set for the first branch
+static void clear_assignments(Parser *parser)
+{
+    size_t first = parser->branch_index == 0 ? parser->assignment_count : parser->branch_size;
+
+    // Only a block with more than LINEAR_ASSIGNMENTS variables has set var_slots
+    for (size_t i = 0; first > LINEAR_ASSIGNMENTS && i < first; i++)
+    {
+        size_t var_id = (size_t)parser->assignments[i].var_id;
+
+        if (var_id < parser->var_slot_count)
+            parser->var_slots[var_id] = 0;
+    }
+
+    parser->assignment_count = 0;
+    parser->branch_index = 0;
+    parser->branch_size = 0;
+    parser->branch_filled = 0;
+    parser->in_else_branch = false;
+    parser->var_mismatch = false;
+    parser->branches = NULL;
+}
+
+// Ast arena
+//
+// The Asts of nested blocks are bump allocated from chunks that are only freed all at once,
+// by parser_reset (which keeps the newest chunk for the next parse) and parser_cleanup. The
+// block being read is built in place at the end of the newest chunk, its header followed by
+// its nodes, and a node is appended by bumping node_count. When the chunk is full the block
+// moves to a chunk twice as large, so its nodes stay contiguous; they are only referred to by
+// index while the block is read. Resetting node_count drops a block that is not kept.
+#define AST_CHUNK_SIZE 16384
+#define AST_SIZE(node_count) (offsetof(Ast, nodes) + (node_count) * sizeof(AstNode))
+
+typedef struct AstChunk
+{
+    struct AstChunk *prev;  // Older chunk, holding Asts of earlier blocks
+    size_t size;            // Bytes of data
+    size_t used;            // Bytes taken by kept Asts, a multiple of 8
+    unsigned char data[];
+} AstChunk;
+
+struct AstArena
+{
+    AstChunk *chunk;
+    size_t node_count;      // Nodes of the block being read
+    size_t node_capacity;   // Nodes that fit in the chunk behind its header
+};
+
+// Header of the block being read
+static inline Ast *ast_building(const AstArena *arena)
+{
+    return (Ast *)(arena->chunk->data + arena->chunk->used);
+}
+
+static void ast_arena_fit(AstArena *arena)
+{
+    AstChunk *chunk = arena->chunk;
+
+    arena->node_count = 0;
+    arena->node_capacity = chunk->size >= chunk->used + AST_SIZE(0) ?
+                           (chunk->size - chunk->used - AST_SIZE(0)) / sizeof(AstNode) : 0;
+}
+
+// Free every chunk but the newest and empty that one
+static void ast_arena_empty(AstArena *arena)
+{
+    if (arena == NULL || arena->chunk == NULL)
+        return;
+
+    while (arena->chunk->prev != NULL)
+    {
+        AstChunk *prev = arena->chunk->prev;
+
+        arena->chunk->prev = prev->prev;
+        free(prev);
+    }
+    arena->chunk->used = 0;
+    ast_arena_fit(arena);
+}
+
+static void ast_arena_destroy(AstArena *arena)
+{
+    if (arena == NULL)
+        return;
+
+    while (arena->chunk != NULL)
+    {
+        AstChunk *prev = arena->chunk->prev;
+
+        free(arena->chunk);
+        arena->chunk = prev;
+    }
+    free(arena);
+}
+
+// Nesting frames
+struct NestFrame
+{
+    // Fields of the enclosing block, restored by the final end of the nested one
+    int state;              // READ_SEMICOLON1 or READ_SEMICOLON2, where the block goes on
+    int cond_var_id;
+    int comparator;
+    int valC;
+    int assignment_var_id;
+    int assignment_var2_id;
+    int const1;
+    int const2;
+    bool blocking_assignment1;
+    bool blocking_assignment2;
+    bool in_else_branch;
+    bool var_mismatch;
+    size_t arm_count;
+    size_t assignment_count;
+    size_t branch_index;
+    size_t branch_size;
+    size_t branch_filled;
+    size_t ast_if;
+    size_t ast_first_if;
+
+    // Swapped with the parser's buffers while the nested block is read, so every depth has
+    // buffers of its own that are kept from one block to the next
+    LadderArm *arms;
+    size_t arm_capacity;
+    Assignment *assignments;
+    size_t assignment_capacity;
+    int *var_slots;
+    size_t var_slot_count;
+};
+
+static void nest_swap_buffers(Parser *parser, NestFrame *frame)
+{
+    LadderArm *arms = parser->arms;
+    size_t arm_capacity = parser->arm_capacity;
+    Assignment *assignments = parser->assignments;
+    size_t assignment_capacity = parser->assignment_capacity;
+    int *var_slots = parser->var_slots;
+    size_t var_slot_count = parser->var_slot_count;
+
+    parser->arms = frame->arms;
+    parser->arm_capacity = frame->arm_capacity;
+    parser->assignments = frame->assignments;
+    parser->assignment_capacity = frame->assignment_capacity;
+    parser->var_slots = frame->var_slots;
+    parser->var_slot_count = frame->var_slot_count;
+
+    frame->arms = arms;
+    frame->arm_capacity = arm_capacity;
+    frame->assignments = assignments;
+    frame->assignment_capacity = assignment_capacity;
+    frame->var_slots = var_slots;
+    frame->var_slot_count = var_slot_count;
+}
+
+// Go back to the enclosing block, whose assignments must have been cleared
+static void nest_pop(Parser *parser)
+{
+    NestFrame *frame = &parser->frames[--parser->depth];
+
+    nest_swap_buffers(parser, frame);
+    parser->state = frame->state;
+    parser->cond_var_id = frame->cond_var_id;
+    parser->comparator = frame->comparator;
+    parser->valC = frame->valC;
+    parser->assignment_var_id = frame->assignment_var_id;
+    parser->assignment_var2_id = frame->assignment_var2_id;
+    parser->const1 = frame->const1;
+    parser->const2 = frame->const2;
+    parser->blocking_assignment1 = frame->blocking_assignment1;
+    parser->blocking_assignment2 = frame->blocking_assignment2;
+    parser->in_else_branch = frame->in_else_branch;
+    parser->var_mismatch = frame->var_mismatch;
+    parser->arm_count = frame->arm_count;
+    parser->assignment_count = frame->assignment_count;
+    parser->branch_index = frame->branch_index;
+    parser->branch_size = frame->branch_size;
+    parser->branch_filled = frame->branch_filled;
+    parser->ast_if = frame->ast_if;
+    parser->ast_first_if = frame->ast_first_if;
+    parser->keyword_index = 0;
+    parser->reading_var = false;
+}
+
+// Reset the per-block fields so the next if-else block can be parsed, the
+// configuration (debug_mode, engine) is kept
+void parser_reset_block(Parser *parser)
+{
+    // A block that ended inside a nested one, give every depth its buffers back
+    while (parser->depth > 0)
+    {
+        clear_assignments(parser);
+        nest_pop(parser);
+    }
+
+    parser->state = IDLE;
+    parser->keyword_index = 0;
+    parser->keyword_complete = false;
+
+    parser->cond_var_id = -1;
+    parser->assignment_var_id = -1;
+    parser->assignment_var2_id = -1;
+    parser->name_length = 0;
+    parser->arm_count = 0;
+    parser->ladder = NULL;
+    clear_assignments(parser);
+    parser->nested = false;
+    if (parser->arena != NULL)
+        parser->arena->node_count = 0;
+    parser->ast_if = 0;
+    parser->ast_first_if = 0;
+    parser->ast = NULL;
+    parser->compound = false;
+    parser->cond_term_count = 0;
+    parser->cond_stack_count = 0;
+    parser->cond_code_size = 0;
+    parser->var_match = false;
+    parser->reading_var = false;
+
+    parser->x = 0;
+    parser->valC = 0;
+    parser->is_valC_negative = false;
+    parser->const1 = 0;
+    parser->is_const1_negative = false;
+    parser->const2 = 0;
+    parser->is_const2_negative = false;
+    parser->num_buffer = 0;
+    parser->parsing_number = false;
+
+    parser->paren_count = 0;
+
+    parser->blocking_assignment1 = false;
+    parser->blocking_assignment2 = false;
+
+    parser->comparator = 0;
+    parser->op_first = 0;
+
+    parser->p = 0;
+    parser->parsing_done = false;
+    parser->error_flag = false;
+    parser->error_code = NO_ERROR;
+    parser->error_offset = 0;
+}
+
+void parser_init(Parser *parser)
+{
+    parser->name_buffer = NULL;
+    parser->name_capacity = 0;
+    parser->symbols = NULL;
+    parser->arms = NULL;
+    parser->arm_capacity = 0;
+    parser->assignments = NULL;
+    parser->assignment_count = 0;
+    parser->assignment_capacity = 0;
+    parser->branch_index = 0;
+    parser->var_slots = NULL;
+    parser->var_slot_count = 0;
+    parser->frames = NULL;
+    parser->depth = 0;
+    parser->frame_capacity = 0;
+    parser->arena = NULL;
+    parser->cond_terms = NULL;
+    parser->cond_term_capacity = 0;
+    parser->cond_stack = NULL;
+    parser->cond_stack_capacity = 0;
+    parser->cond_code = NULL;
+    parser->cond_code_capacity = 0;
+    parser->interned = NULL;
+
+    parser_reset_block(parser);
+
+    parser->debug_mode = false;
+    parser->engine = ENGINE_TABLE;
+    parser->recover = false;
+    parser->cache = NULL;
+
+    parser->offset = 0;
+    parser->block_start = 0;
+    parser->resyncing = false;
+    parser->resync_held = 0;
+    parser->resync_prev = 0;
+
+    parser->blocks = NULL;
+    parser->block_head = 0;
+    parser->block_count = 0;
+    parser->block_capacity = 0;
+    parser->next_block_index = 0;
+}
+
+// parser_reset without emptying the arena
+static void parser_rewind(Parser *parser)
+{
+    parser_reset_block(parser);
+
+    parser->offset = 0;
+    parser->block_start = 0;
+    parser->resyncing = false;
+    parser->resync_held = 0;
+    parser->resync_prev = 0;
+
+    parser->block_head = 0;
+    parser->block_count = 0;
+    parser->next_block_index = 0;
+}
+
+// Clear all parsing state and queued blocks, keeping the configuration and the queue memory
+void parser_reset(Parser *parser)
+{
+    parser_rewind(parser);
+    ast_arena_empty(parser->arena);
+}
+
+// Reset, then carry on as if the input before offset had been parsed into block_index blocks.
+// The blocks kept from before offset may have Asts, so the arena is left as it is.
+void parser_restart(Parser *parser, size_t offset, size_t block_index)
+{
+    parser_rewind(parser);
+
+    parser->offset = offset;
+    parser->block_start = offset;
+    parser->next_block_index = block_index;
+}
+
+Parser *parser_create(void)
+{
+    Parser *parser = malloc(sizeof(Parser));
+
+    if (parser != NULL)
+        parser_init(parser);
+    return parser;
+}
+
+void parser_cleanup(Parser *parser)
+{
+    // Hand the buffers of every depth back to the parser to free them
+    parser_reset_block(parser);
+    for (size_t d = 0; d < parser->frame_capacity; d++)
+    {
+        free(parser->frames[d].arms);
+        free(parser->frames[d].assignments);
+        free(parser->frames[d].var_slots);
+    }
+    free(parser->frames);
+    ast_arena_destroy(parser->arena);
+    free(parser->blocks);
+    free(parser->name_buffer);
+    free(parser->arms);
+    free(parser->assignments);
+    free(parser->var_slots);
+    free(parser->cond_terms);
+    free(parser->cond_stack);
+    free(parser->cond_code);
+    symbol_table_destroy(parser->symbols);
+    symbol_table_destroy(parser->interned);
+
+    parser->blocks = NULL;
+    parser->block_head = 0;
+    parser->block_count = 0;
+    parser->block_capacity = 0;
+    parser->name_buffer = NULL;
+    parser->name_capacity = 0;
+    parser->symbols = NULL;
+    parser->arms = NULL;
+    parser->arm_count = 0;
+    parser->arm_capacity = 0;
+    parser->ladder = NULL;
+    parser->assignments = NULL;
+    parser->assignment_count = 0;
+    parser->assignment_capacity = 0;
+    parser->branch_index = 0;
+    parser->var_slots = NULL;
+    parser->var_slot_count = 0;
+    parser->branches = NULL;
+    parser->frames = NULL;
+    parser->frame_capacity = 0;
+    parser->arena = NULL;
+    parser->ast = NULL;
+    parser->cond_terms = NULL;
+    parser->cond_term_capacity = 0;
+    parser->cond_stack = NULL;
+    parser->cond_stack_capacity = 0;
+    parser->cond_code = NULL;
+    parser->cond_code_capacity = 0;
+    parser->interned = NULL;
+}
+
+void parser_destroy(Parser *parser)
+{
+    if (parser == NULL)
+        return;
+
+    parser_cleanup(parser);
+    free(parser);
+}
+
+// Symbol table
+//
+// Open addressing on a 32-bit FNV-1a hash, the slots hold ID + 1 so 0 marks an empty slot.
+// The table is kept at most half full. Names are allocated one by one and never move, so
+// the pointers handed out by symbol_name stay valid until the table is destroyed.
+struct SymbolTable
+{
+    int *slots;
+    size_t slot_count;   // Power of two
+
+    // Indexed by ID
+    char **names;
+    size_t *lengths;
+    uint32_t *hashes;
+    size_t count;
+    size_t capacity;
+};
+
+static uint32_t symbol_hash(const char *name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+SymbolTable *symbol_table_create(void)
+{
+    SymbolTable *table = calloc(1, sizeof(SymbolTable));
+
+    if (table == NULL)
+        return NULL;
+
+    table->slot_count = 64;
+    table->slots = calloc(table->slot_count, sizeof(int));
+    if (table->slots == NULL)
+    {
+        free(table);
+        return NULL;
+    }
+    return table;
+}
+
+void symbol_table_destroy(SymbolTable *table)
+{
+    if (table == NULL)
+        return;
+
+    for (size_t i = 0; i < table->count; i++)
+        free(table->names[i]);
+    free(table->names);
+    free(table->lengths);
+    free(table->hashes);
+    free(table->slots);
+    free(table);
+}
+
+// Double the slot array and reinsert every ID
+static bool symbol_table_grow(SymbolTable *table)
+{
+    size_t slot_count = table->slot_count * 2;
+    int *slots = calloc(slot_count, sizeof(int));
+
+    if (slots == NULL)
+        return false;
+
+    for (size_t id = 0; id < table->count; id++)
+    {
+        size_t idx = table->hashes[id] & (slot_count - 1);
+        while (slots[idx] != 0)
+            idx = (idx + 1) & (slot_count - 1);
+        slots[idx] = (int)id + 1;
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->slot_count = slot_count;
+    return true;
+}
+
+int symbol_intern(SymbolTable *table, const char *name, size_t length)
+{
+    uint32_t hash = symbol_hash(name, length);
+    size_t mask = table->slot_count - 1;
+    size_t idx = hash & mask;
+
+    for (; table->slots[idx] != 0; idx = (idx + 1) & mask)
+    {
+        int id = table->slots[idx] - 1;
+
+        if (table->hashes[id] == hash && table->lengths[id] == length && memcmp(table->names[id], name, length) == 0)
+            return id;
+    }
+
+    // New name
+    if (table->count == table->capacity)
+    {
+        size_t capacity = table->capacity ? table->capacity * 2 : 32;
+        char **names = realloc(table->names, capacity * sizeof(char *));
+        if (names != NULL)
+            table->names = names;
+        size_t *lengths = realloc(table->lengths, capacity * sizeof(size_t));
+        if (lengths != NULL)
+            table->lengths = lengths;
+        uint32_t *hashes = realloc(table->hashes, capacity * sizeof(uint32_t));
+        if (hashes != NULL)
+            table->hashes = hashes;
+
+        if (names == NULL || lengths == NULL || hashes == NULL)
+            return -1;
+        table->capacity = capacity;
+    }
+
+    char *copy = malloc(length + 1);
+    if (copy == NULL)
+        return -1;
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+
+    int id = (int)table->count++;
+    table->names[id] = copy;
+    table->lengths[id] = length;
+    table->hashes[id] = hash;
+    table->slots[idx] = id + 1;
+
+    if (table->count * 2 > table->slot_count && !symbol_table_grow(table))
+    {
+        // Keep the table consistent, the name is simply not added
+        table->slots[idx] = 0;
+        table->count--;
+        free(copy);
+        return -1;
+    }
+    return id;
+}
+
+const char *symbol_name(const SymbolTable *table, int id)
+{
+    if (table == NULL || id < 0 || (size_t)id >= table->count)
+        return "";
+    return table->names[id];
+}
+
+size_t symbol_count(const SymbolTable *table)
+{
+    return table != NULL ? table->count : 0;
+}
+
+// Identifier being read. Chars collect in name_buffer (so a name may span input chunks) and
+// the complete name is interned, returning false or -1 with OUT_OF_MEMORY flagged on failure.
+static bool name_reserve(Parser *parser, size_t extra)
+{
+    size_t capacity = parser->name_capacity ? parser->name_capacity : 32;
+    char *buffer;
+
+    if (parser->name_length + extra <= parser->name_capacity)
+        return true;
+
+    while (capacity < parser->name_length + extra)
+        capacity *= 2;
+    buffer = realloc(parser->name_buffer, capacity);
+    if (buffer == NULL)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return false;
+    }
+
+    parser->name_buffer = buffer;
+    parser->name_capacity = capacity;
+    return true;
+}
+
+static bool name_append(Parser *parser, char ascii_char)
+{
+    if (!name_reserve(parser, 1))
+        return false;
+
+    parser->name_buffer[parser->name_length++] = ascii_char;
+    return true;
+}
+
+// The name read is "if", where an assignment would start that begins a nested if-else
+static inline bool name_is_if(const Parser *parser)
+{
+    return parser->name_length == 2 && parser->name_buffer[0] == 'i' && parser->name_buffer[1] == 'f';
+}
+
+static int name_end(Parser *parser)
+{
+    int id = -1;
+
+    if (parser->symbols == NULL)
+        parser->symbols = symbol_table_create();
+    if (parser->symbols != NULL)
+        id = symbol_intern(parser->symbols, parser->name_buffer, parser->name_length);
+
+    if (id < 0)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+    }
+    return id;
+}
+
+// Function to check if variable names match: every branch read so far assigns the variables
+// of the first one
+bool var_names_match(Parser *parser)
+{
+    return !parser->var_mismatch;
+}
+
+// Interned copy of size bytes, NULL with OUT_OF_MEMORY flagged on failure
+static const void *intern_bytes(Parser *parser, const void *data, size_t size)
+{
+    int id = -1;
+
+    if (parser->interned == NULL)
+        parser->interned = symbol_table_create();
+    if (parser->interned != NULL)
+        id = symbol_intern(parser->interned, data, size);
+
+    if (id < 0)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return NULL;
+    }
+    return symbol_name(parser->interned, id);
+}
+
+// Room for count more nodes behind the block being read, in a new chunk if need be. Returns
+// false with OUT_OF_MEMORY flagged on failure.
+static bool ast_reserve(Parser *parser, size_t count)
+{
+    AstArena *arena = parser->arena;
+    AstChunk *chunk;
+    size_t size;
+
+    if (arena != NULL && arena->node_count + count <= arena->node_capacity)
+        return true;
+
+    if (arena == NULL)
+    {
+        arena = calloc(1, sizeof(AstArena));
+        if (arena == NULL)
+            goto failed;
+        parser->arena = arena;
+    }
+    if (arena->node_count + count > UINT32_MAX)
+        goto failed;
+
+    size = arena->chunk != NULL ? arena->chunk->size * 2 : AST_CHUNK_SIZE;
+    while (size < AST_SIZE(arena->node_count + count))
+        size *= 2;
+
+    if (arena->chunk != NULL && arena->chunk->used == 0)
+    {
+        // Nothing is kept in the chunk yet, it can move
+        chunk = realloc(arena->chunk, sizeof(AstChunk) + size);
+        if (chunk == NULL)
+            goto failed;
+    }
+    else
+    {
+        chunk = malloc(sizeof(AstChunk) + size);
+        if (chunk == NULL)
+            goto failed;
+        chunk->prev = arena->chunk;
+        chunk->used = 0;
+        if (arena->chunk != NULL)
+            memcpy(chunk->data, ast_building(arena), AST_SIZE(arena->node_count));
+    }
+    chunk->size = size;
+    arena->chunk = chunk;
+    arena->node_capacity = (size - AST_SIZE(0)) / sizeof(AstNode);
+    return true;
+
+failed:
+    parser->error_flag = true;
+    parser->error_code = OUT_OF_MEMORY;
+    return false;
+}
+
+// Append a node to the block being read, NULL with OUT_OF_MEMORY flagged on failure. The
+// first node appended is preceded by node 0, the AST_IF of the outermost condition.
+static AstNode *ast_append(Parser *parser, int kind)
+{
+    AstArena *arena;
+    AstNode *nodes;
+    AstNode *node;
+
+    if (!ast_reserve(parser, 2))
+        return NULL;
+
+    arena = parser->arena;
+    nodes = ast_building(arena)->nodes;
+    if (arena->node_count == 0)
+    {
+        nodes[0].kind = AST_IF;
+        arena->node_count = 1;
+    }
+
+    node = &nodes[arena->node_count++];
+    node->kind = (uint8_t)kind;
+    node->end = (uint32_t)arena->node_count;
+    return node;
+}
+
+// Assignments
+//
+// Every "var <= const;" is pushed at its ';'. The first branch appends its pairs, and a later
+// branch writes each pair to its variable's position in a branch_size block of its own,
+// counting the positions it fills. A variable missing from the first branch, or a position
+// left empty when the branch closes, sets var_mismatch. A variable assigned twice in a branch
+// keeps the last value, as in Verilog.
+//
+// Positions are found by scanning the first branch while it has at most LINEAR_ASSIGNMENTS
+// variables, which covers nearly every block. Past that, var_slots maps variable IDs to
+// positions; it is indexed by ID, so a block that needs it touches one slot per assignment
+// rather than the whole table.
+
+// 1 + position of var_id among the first branch's first_count variables, 0 if it is not one
+static int assignment_slot(const Parser *parser, int var_id, size_t first_count)
+{
+    if (first_count > LINEAR_ASSIGNMENTS)
+        return (size_t)var_id < parser->var_slot_count ? parser->var_slots[var_id] : 0;
+
+    for (size_t i = 0; i < first_count; i++)
+    {
+        if (parser->assignments[i].var_id == var_id)
+            return (int)i + 1;
+    }
+    return 0;
+}
+
+// Record the position of the first branch's assignment i in var_slots
+static bool assignment_index(Parser *parser, size_t i)
+{
+    size_t var_id = (size_t)parser->assignments[i].var_id;
+
+    if (var_id >= parser->var_slot_count)
+    {
+        size_t count = parser->var_slot_count ? parser->var_slot_count * 2 : 64;
+        int *slots;
+
+        while (count <= var_id)
+            count *= 2;
+        slots = realloc(parser->var_slots, count * sizeof(int));
+        if (slots == NULL)
+        {
+            parser->error_flag = true;
+            parser->error_code = OUT_OF_MEMORY;
+            return false;
+        }
+        memset(slots + parser->var_slot_count, 0, (count - parser->var_slot_count) * sizeof(int));
+        parser->var_slots = slots;
+        parser->var_slot_count = count;
+    }
+
+    parser->var_slots[var_id] = (int)i + 1;
+    return true;
+}
+
+// The branch being read is complete. Closing an arm's own branch also completes its AST_IF,
+// whose else branch starts with the next node.
+static void close_branch(Parser *parser)
+{
+    AstArena *arena = parser->arena;
+
+    if (!parser->in_else_branch && arena != NULL && parser->ast_if < arena->node_count)
+    {
+        AstNode *node = &ast_building(arena)->nodes[parser->ast_if];
+
+        node->comparator = (uint8_t)parser->comparator;
+        node->var_id = parser->cond_var_id;
+        node->value = parser->valC;
+        node->jump = (uint32_t)arena->node_count;
+    }
+
+    if (parser->branch_index == 0)
+        parser->branch_size = parser->assignment_count;
+    else if (parser->branch_filled != parser->branch_size)
+        parser->var_mismatch = true;
+    parser->branch_index++;
+}
+
+static bool assignment_reserve(Parser *parser, size_t extra)
+{
+    size_t capacity = parser->assignment_capacity ? parser->assignment_capacity : 16;
+    Assignment *assignments;
+
+    if (parser->assignment_count + extra <= parser->assignment_capacity)
+        return true;
+
+    while (capacity < parser->assignment_count + extra)
+        capacity *= 2;
+    assignments = realloc(parser->assignments, capacity * sizeof(Assignment));
+    if (assignments == NULL)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return false;
+    }
+
+    parser->assignments = assignments;
+    parser->assignment_capacity = capacity;
+    return true;
+}
+
+// The final else's branch is closed by its first statement, as the "begin" before it may be
+// taken by a keyword fast path
+static void open_else_branch(Parser *parser)
+{
+    close_branch(parser);
+    parser->in_else_branch = true;
+}
+
+// Add var_id to the variables of the branch being read
+static void assignment_record(Parser *parser, int var_id, int value)
+{
+    if (parser->branch_index == 0)
+    {
+        size_t count = parser->assignment_count;
+        int slot = assignment_slot(parser, var_id, count);
+
+        if (slot != 0)
+        {
+            parser->assignments[slot - 1].value = value;
+            return;
+        }
+        if (!assignment_reserve(parser, 1))
+            return;
+        parser->assignments[count].var_id = var_id;
+        parser->assignments[count].value = value;
+        parser->assignment_count++;
+
+        // Switch to var_slots when the scan gets too long
+        if (count + 1 == LINEAR_ASSIGNMENTS + 1)
+        {
+            for (size_t i = 0; i <= count; i++)
+            {
+                if (!assignment_index(parser, i))
+                    return;
+            }
+        }
+        else if (count + 1 > LINEAR_ASSIGNMENTS + 1)
+        {
+            assignment_index(parser, count);
+        }
+        return;
+    }
+
+    // A later branch, its block is opened by its first assignment
+    if (parser->assignment_count == parser->branch_index * parser->branch_size)
+    {
+        if (!assignment_reserve(parser, parser->branch_size))
+            return;
+        for (size_t i = 0; i < parser->branch_size; i++)
+            parser->assignments[parser->assignment_count + i].var_id = -1;
+        parser->assignment_count += parser->branch_size;
+        parser->branch_filled = 0;
+    }
+
+    int slot = assignment_slot(parser, var_id, parser->branch_size);
+    if (slot == 0)
+    {
+        parser->var_mismatch = true;
+        return;
+    }
+
+    Assignment *pair = &parser->assignments[parser->branch_index * parser->branch_size + slot - 1];
+    if (pair->var_id < 0)
+        parser->branch_filled++;
+    pair->var_id = var_id;
+    pair->value = value;
+}
+
+// An assignment has been read. Kept out of line like the other block-level work.
+static __attribute__((noinline)) void assignment_push(Parser *parser, int var_id, int value, bool final_else)
+{
+    AstNode *node;
+
+    if (final_else && !parser->in_else_branch)
+        open_else_branch(parser);
+
+    node = ast_append(parser, AST_ASSIGN);
+    if (node == NULL)
+        return;
+    node->var_id = var_id;
+    node->value = value;
+    assignment_record(parser, var_id, value);
+}
+
+// Intern the assignments of a parsed block that assigns several variables
+static bool branches_finish(Parser *parser)
+{
+    size_t size = sizeof(BranchAssignments) + parser->assignment_count * sizeof(Assignment);
+    BranchAssignments *branches;
+
+    if (parser->branch_size < 2)
+        return true;
+
+    branches = malloc(size);
+    if (branches == NULL)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return false;
+    }
+    branches->count = parser->branch_size;
+    branches->branch_count = parser->branch_index;
+    memcpy(branches->pairs, parser->assignments, parser->assignment_count * sizeof(Assignment));
+    parser->branches = intern_bytes(parser, branches, size);
+    free(branches);
+    return parser->branches != NULL;
+}
+
+// Else-if ladders
+//
+// "else if" keeps the arm just read in parser->arms and goes back to READ_IF for the next
+// one, so every arm is read by the same states as a single if. When the final else is read,
+// the arms are compiled into a Ladder and interned with intern_bytes: a ladder is built
+// deterministically from its arms, so equal ladders get the same copy and memory grows with
+// the number of distinct ladders.
+//
+// The threshold table: each condition on x is true over at most two runs of the integer
+// line, bounded at valC and valC + 1. Cutting the line at all of those bounds gives
+// intervals on which every condition is constant. The arms are applied in order, each one
+// taking the intervals where it holds that no earlier arm took (a skip list of untaken
+// intervals keeps that linear), then neighbours taking the same branch are merged.
+static bool arm_push(Parser *parser)
+{
+    if (parser->arm_count == parser->arm_capacity)
+    {
+        size_t capacity = parser->arm_capacity ? parser->arm_capacity * 2 : 8;
+        LadderArm *arms = realloc(parser->arms, capacity * sizeof(LadderArm));
+
+        if (arms == NULL)
+        {
+            parser->error_flag = true;
+            parser->error_code = OUT_OF_MEMORY;
+            return false;
+        }
+        parser->arms = arms;
+        parser->arm_capacity = capacity;
+    }
+
+    LadderArm *arm = &parser->arms[parser->arm_count++];
+    arm->cond_var_id = parser->cond_var_id;
+    arm->comparator = parser->comparator;
+    arm->valC = parser->valC;
+    arm->value = parser->const1;
+    return true;
+}
+
+// "else if": keep the arm just read and clear the fields of the next one. The arm's branch
+// is closed here, so a mismatch with the first branch is flagged at the 'i'.
+// Like ladder_finish, kept out of line so it does not grow process_char's hot switch.
+static __attribute__((noinline)) void start_else_if(Parser *parser)
+{
+    close_branch(parser);
+    if (!var_names_match(parser))
+    {
+        parser->error_flag = true;
+        parser->error_code = VAR_MISMATCH;
+        return;
+    }
+    if (!arm_push(parser) || ast_append(parser, AST_IF) == NULL)
+        return;
+    parser->ast_if = parser->arena->node_count - 1;
+
+    parser->cond_var_id = -1;
+    parser->assignment_var_id = -1;
+    parser->reading_var = false;
+    parser->valC = 0;
+    parser->is_valC_negative = false;
+    parser->const1 = 0;
+    parser->is_const1_negative = false;
+    parser->num_buffer = 0;
+    parser->parsing_number = false;
+    parser->blocking_assignment1 = false;
+    parser->comparator = 0;
+    parser->op_first = 0;
+
+    // The 'i' of the "if"
+    parser->keyword_index = 1;
+    parser->state = READ_IF;
+}
+
+static int compare_bounds(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Index of the interval starting at bound, count if bound is past INT_MAX
+static size_t interval_at(const int64_t *starts, size_t count, int64_t bound)
+{
+    size_t lo = 0;
+    size_t hi = count;
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (starts[mid] < bound)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+// First untaken interval at or after i, compressing the path behind it
+static size_t untaken_from(size_t *next, size_t i)
+{
+    size_t root = i;
+
+    while (next[root] != root)
+        root = next[root];
+    while (next[i] != root)
+    {
+        size_t up = next[i];
+        next[i] = root;
+        i = up;
+    }
+    return root;
+}
+
+static void take_intervals(size_t *next, int *branches, size_t from, size_t to, int branch)
+{
+    for (size_t i = untaken_from(next, from); i < to; i = untaken_from(next, i + 1))
+    {
+        branches[i] = branch;
+        next[i] = i + 1;
+    }
+}
+
+// Build the threshold table of arms that all test one variable into thresholds and branches
+// (room for 2 * count + 1 entries each), returns the number of entries or 0 if memory ran out
+static size_t ladder_table(const LadderArm *arms, size_t count, int *thresholds, int *branches)
+{
+    int64_t *starts = malloc((2 * count + 1) * sizeof(int64_t));
+    int *interval_branches = malloc((2 * count + 1) * sizeof(int));
+    size_t *next = malloc((2 * count + 2) * sizeof(size_t));
+    size_t n = 0;
+    size_t table_count = 0;
+
+    if (starts == NULL || interval_branches == NULL || next == NULL)
+        goto done;
+
+    // Bounds of every condition, INT_MIN starts the first interval
+    starts[n++] = INT_MIN;
+    for (size_t a = 0; a < count; a++)
+    {
+        starts[n++] = arms[a].valC;
+        if (arms[a].valC < INT_MAX)
+            starts[n++] = (int64_t)arms[a].valC + 1;
+    }
+    qsort(starts, n, sizeof(int64_t), compare_bounds);
+
+    size_t unique = 1;
+    for (size_t i = 1; i < n; i++)
+    {
+        if (starts[i] != starts[unique - 1])
+            starts[unique++] = starts[i];
+    }
+    n = unique;
+
+    for (size_t i = 0; i <= n; i++)
+        next[i] = i;
+
+    for (size_t a = 0; a < count; a++)
+    {
+        size_t at = interval_at(starts, n, arms[a].valC);
+        size_t after = interval_at(starts, n, (int64_t)arms[a].valC + 1);
+        int branch = (int)a;
+
+        switch (arms[a].comparator)
+        {
+        case EQ: take_intervals(next, interval_branches, at, after, branch); break;
+        case NE:
+            take_intervals(next, interval_branches, 0, at, branch);
+            take_intervals(next, interval_branches, after, n, branch);
+            break;
+        case LT: take_intervals(next, interval_branches, 0, at, branch); break;
+        case GT: take_intervals(next, interval_branches, after, n, branch); break;
+        case LE: take_intervals(next, interval_branches, 0, after, branch); break;
+        case GE: take_intervals(next, interval_branches, at, n, branch); break;
+        default: break;
+        }
+    }
+    take_intervals(next, interval_branches, 0, n, (int)count);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (table_count == 0 || interval_branches[i] != branches[table_count - 1])
+        {
+            thresholds[table_count] = (int)starts[i];
+            branches[table_count] = interval_branches[i];
+            table_count++;
+        }
+    }
+
+done:
+    free(starts);
+    free(interval_branches);
+    free(next);
+    return table_count;
+}
+
+// The final else of a ladder has been read: add the last arm, then compile and intern the
+// ladder. The values are those of each branch's first variable. Returns false with
+// OUT_OF_MEMORY flagged on failure.
+static __attribute__((noinline)) bool ladder_finish(Parser *parser)
+{
+    size_t count;
+    size_t size;
+    Ladder *ladder;
+
+    if (!arm_push(parser))
+        return false;
+
+    count = parser->arm_count;
+    size = sizeof(Ladder) + count * sizeof(LadderArm) + 2 * (2 * count + 1) * sizeof(int);
+    ladder = calloc(1, size);
+    if (ladder == NULL)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return false;
+    }
+
+    ladder->arm_count = count;
+    ladder->cond_var_id = parser->arms[0].cond_var_id;
+    ladder->default_value = parser->assignments[count * parser->branch_size].value;
+    memcpy(ladder->arms, parser->arms, count * sizeof(LadderArm));
+    for (size_t a = 0; a < count; a++)
+    {
+        ladder->arms[a].value = parser->assignments[a * parser->branch_size].value;
+        if (parser->arms[a].cond_var_id != ladder->cond_var_id)
+            ladder->cond_var_id = -1;
+    }
+
+    // Build the table at its largest size, then move the branches down behind the thresholds
+    int *thresholds = (int *)(ladder->arms + count);
+    int *branches = thresholds + 2 * count + 1;
+    if (ladder->cond_var_id >= 0)
+    {
+        ladder->threshold_count = ladder_table(parser->arms, count, thresholds, branches);
+        memmove(thresholds + ladder->threshold_count, branches, ladder->threshold_count * sizeof(int));
+    }
+
+    parser->ladder = NULL;
+    if (ladder->cond_var_id < 0 || ladder->threshold_count > 0)
+    {
+        size = sizeof(Ladder) + count * sizeof(LadderArm) + 2 * ladder->threshold_count * sizeof(int);
+        parser->ladder = intern_bytes(parser, ladder, size);
+    }
+    else
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+    }
+    free(ladder);
+    return parser->ladder != NULL;
+}
+
+// Compound conditions
+//
+// A condition is read as a single comparison until a "&&", "||" or "!" makes it compound.
+// From there on its comparisons and operators are put in postfix order with an operator
+// stack (shunting-yard): a comparison goes straight to cond_terms, an operator waits on
+// cond_stack until one that binds less tightly ("||" below "&&" below "!") or a ')' moves it
+// over. The parentheses still open when the condition turns compound, the if's own among
+// them, were all opened before its first comparison, so they go on the stack first. A
+// parenthesis around a name or a constant is read as one around its comparison.
+//
+// The ')' that closes the if's own parenthesis compiles the terms into a Condition appended
+// to cond_code, which ast_finish copies behind the variables of the block's Ast. A block
+// with a compound condition is always kept as an Ast.
+#define COND_OPEN 0xff                      // An open parenthesis on cond_stack
+#define COND_MAX_REGS 256
+#define COND_MAX_COMPARES (UINT16_MAX - 2)  // Leaves room for COND_TRUE and COND_FALSE
+
+static const int cond_precedence[] = {[COND_AND] = 2, [COND_OR] = 1, [COND_NOT] = 3};
+
+// The comparator that holds exactly when comparator does not
+static const uint8_t cond_negated[6] = {[EQ] = NE, [NE] = EQ, [LT] = GE, [GT] = LE, [LE] = GT, [GE] = LT};
+
+// One of the condition buffers with room for count items of size bytes, NULL with
+// OUT_OF_MEMORY flagged on failure
+static void *cond_reserve(Parser *parser, void *buffer, size_t *capacity, size_t count, size_t size)
+{
+    size_t new_capacity = *capacity ? *capacity : 16;
+    void *grown;
+
+    if (count <= *capacity)
+        return buffer;
+
+    while (new_capacity < count)
+        new_capacity *= 2;
+    grown = realloc(buffer, new_capacity * size);
+    if (grown == NULL)
+    {
+        parser->error_flag = true;
+        parser->error_code = OUT_OF_MEMORY;
+        return NULL;
+    }
+
+    *capacity = new_capacity;
+    return grown;
+}
+
+static bool cond_push_term(Parser *parser, int kind)
+{
+    CondTerm *terms = cond_reserve(parser, parser->cond_terms, &parser->cond_term_capacity,
+                                   parser->cond_term_count + 1, sizeof(CondTerm));
+    CondTerm *term;
+
+    if (terms == NULL)
+        return false;
+    parser->cond_terms = terms;
+
+    term = &terms[parser->cond_term_count++];
+    term->kind = (uint8_t)kind;
+    term->comparator = kind == COND_COMPARE ? (uint8_t)parser->comparator : 0;
+    term->var_id = kind == COND_COMPARE ? parser->cond_var_id : -1;
+    term->value = kind == COND_COMPARE ? parser->valC : 0;
+    return true;
+}
+
+// The comparison just read
+static bool cond_compare(Parser *parser)
+{
+    return cond_push_term(parser, COND_COMPARE);
+}
+
+// An operator or an open parenthesis. A binary operator first moves over the waiting ones
+// that bind at least as tightly; "!" is a prefix, it waits for its operand.
+static bool cond_push_op(Parser *parser, uint8_t op)
+{
+    uint8_t *stack;
+
+    if (op == COND_AND || op == COND_OR)
+    {
+        while (parser->cond_stack_count > 0)
+        {
+            uint8_t top = parser->cond_stack[parser->cond_stack_count - 1];
+
+            if (top == COND_OPEN || cond_precedence[top] < cond_precedence[op])
+                break;
+            if (!cond_push_term(parser, top))
+                return false;
+            parser->cond_stack_count--;
+        }
+    }
+
+    stack = cond_reserve(parser, parser->cond_stack, &parser->cond_stack_capacity, parser->cond_stack_count + 1,
+                         sizeof(uint8_t));
+    if (stack == NULL)
+        return false;
+    parser->cond_stack = stack;
+    stack[parser->cond_stack_count++] = op;
+    return true;
+}
+
+// The condition turns compound, with_compare if its first comparison has been read
+static bool cond_start(Parser *parser, bool with_compare)
+{
+    parser->compound = true;
+    parser->cond_term_count = 0;
+    parser->cond_stack_count = 0;
+
+    for (int i = 0; i < parser->paren_count; i++)
+    {
+        if (!cond_push_op(parser, COND_OPEN))
+            return false;
+    }
+    return !with_compare || cond_compare(parser);
+}
+
+// Where a compiled condition goes next from each of its terms: to on_true if the term holds,
+// else to on_false, both op indices. start is the first term of the term's operand tree and
+// leaf the number of comparisons before it.
+typedef struct
+{
+    uint32_t start;
+    uint16_t leaf;
+    uint16_t on_true;
+    uint16_t on_false;
+} CondLink;
+
+// Compile the terms of the condition just read into a Condition at the end of cond_code,
+// and leave it in the comparator and valC registers.
+//
+// The ops are the comparisons in input order, then COND_TRUE and COND_FALSE. Where each one
+// goes is worked out from the root down, the root going to COND_TRUE or COND_FALSE: the left
+// operand of "a && b" goes on to the first comparison of b if it holds and to where the
+// whole goes if it does not, the left one of "a || b" the other way round, and "!" swaps
+// the two. The right operand goes where the whole goes. Either way one of the two is the op
+// right after, so each comparison becomes a single op that jumps on one outcome and falls
+// through on the other, with its comparator negated when the jump is for the false outcome.
+static __attribute__((noinline)) void cond_compile(Parser *parser)
+{
+    const CondTerm *terms = parser->cond_terms;
+    size_t term_count = parser->cond_term_count;
+    unsigned char *code;
+    size_t compare_count = 0;
+    size_t reg_count = 0;
+    size_t base = parser->cond_code_size;
+    size_t size;
+    Condition *cond;
+    CondLink *links;
+    int *vars;
+
+    for (size_t i = 0; i < term_count; i++)
+        compare_count += terms[i].kind == COND_COMPARE;
+    if (compare_count > COND_MAX_COMPARES || base > INT_MAX)
+    {
+        parser->error_flag = true;
+        parser->error_code = COND_TOO_LARGE;
+        return;
+    }
+
+    // Room for the largest Condition these terms make and, past it, the links
+    size = offsetof(Condition, ops) + (compare_count + 2) * sizeof(CondOp) + compare_count * sizeof(int) +
+           term_count * sizeof(CondTerm);
+    code = cond_reserve(parser, parser->cond_code, &parser->cond_code_capacity,
+                        base + size + term_count * sizeof(CondLink), 1);
+    if (code == NULL)
+        return;
+    parser->cond_code = code;
+    cond = (Condition *)(code + base);
+    links = (CondLink *)(code + base + size);
+    vars = (int *)(cond->ops + compare_count + 2);
+
+    // Operand trees, and a register for each variable
+    for (size_t i = 0, leaf = 0; i < term_count; i++)
+    {
+        const CondTerm *term = &terms[i];
+
+        links[i].leaf = (uint16_t)leaf;
+        if (term->kind == COND_COMPARE)
+        {
+            size_t reg = 0;
+
+            while (reg < reg_count && vars[reg] != term->var_id)
+                reg++;
+            if (reg == reg_count)
+            {
+                if (reg_count == COND_MAX_REGS)
+                {
+                    parser->error_flag = true;
+                    parser->error_code = COND_TOO_LARGE;
+                    return;
+                }
+                vars[reg_count++] = term->var_id;
+            }
+            cond->ops[leaf].reg = (uint8_t)reg;
+            cond->ops[leaf].value = term->value;
+            links[i].start = (uint32_t)i;
+            leaf++;
+        }
+        else if (term->kind == COND_NOT)
+        {
+            links[i].start = links[i - 1].start;
+        }
+        else
+        {
+            links[i].start = links[links[i - 1].start - 1].start;
+        }
+    }
+
+    // Jumps, from the root down: a term comes after the terms of its operands
+    links[term_count - 1].on_true = (uint16_t)compare_count;
+    links[term_count - 1].on_false = (uint16_t)(compare_count + 1);
+    for (size_t i = term_count; i-- > 0;)
+    {
+        const CondLink *link = &links[i];
+        size_t right = i - 1;
+
+        switch (terms[i].kind)
+        {
+        case COND_COMPARE:
+        {
+            CondOp *op = &cond->ops[link->leaf];
+
+            if (link->on_false == link->leaf + 1)
+            {
+                op->op = terms[i].comparator;
+                op->target = link->on_true;
+            }
+            else
+            {
+                op->op = cond_negated[terms[i].comparator];
+                op->target = link->on_false;
+            }
+            break;
+        }
+
+        case COND_NOT:
+            links[right].on_true = link->on_false;
+            links[right].on_false = link->on_true;
+            break;
+
+        case COND_AND:
+            links[links[right].start - 1].on_true = links[links[right].start].leaf;
+            links[links[right].start - 1].on_false = link->on_false;
+            links[right].on_true = link->on_true;
+            links[right].on_false = link->on_false;
+            break;
+
+        case COND_OR:
+            links[links[right].start - 1].on_true = link->on_true;
+            links[links[right].start - 1].on_false = links[links[right].start].leaf;
+            links[right].on_true = link->on_true;
+            links[right].on_false = link->on_false;
+            break;
+        }
+    }
+    cond->ops[compare_count].op = COND_TRUE;
+    cond->ops[compare_count + 1].op = COND_FALSE;
+
+    cond->op_count = (uint16_t)(compare_count + 2);
+    cond->reg_count = (uint16_t)reg_count;
+    cond->term_count = (uint32_t)term_count;
+    memcpy(vars + reg_count, terms, term_count * sizeof(CondTerm));
+    parser->cond_code_size = base + offsetof(Condition, ops) + (compare_count + 2) * sizeof(CondOp) +
+                             reg_count * sizeof(int) + term_count * sizeof(CondTerm);
+
+    parser->comparator = COMPOUND;
+    parser->valC = (int)base;
+    parser->cond_var_id = reg_count == 1 ? vars[0] : -1;
+    parser->compound = false;
+    parser->nested = true;
+}
+
+// '&' or '|' after a comparison or a ')', the first char of "&&" or "||"
+static __attribute__((noinline)) void cond_logic(Parser *parser, char ascii_char)
+{
+    if (!parser->compound && !cond_start(parser, true))
+        return;
+    parser->op_first = ascii_char;
+    parser->state = READ_COND_LOGIC;
+}
+
+// The second char of "&&" or "||", the next comparison starts after it
+static __attribute__((noinline)) void cond_next(Parser *parser, char ascii_char)
+{
+    if (ascii_char != parser->op_first)
+    {
+        parser->error_flag = true;
+        parser->error_code = SYNTAX_ERROR;
+        return;
+    }
+    if (!cond_push_op(parser, ascii_char == '&' ? COND_AND : COND_OR))
+        return;
+
+    parser->cond_var_id = -1;
+    parser->comparator = 0;
+    parser->valC = 0;
+    parser->is_valC_negative = false;
+    parser->num_buffer = 0;
+    parser->parsing_number = false;
+    parser->op_first = 0;
+    parser->reading_var = false;
+    parser->state = READ_VAR;
+}
+
+// "!" where a comparison could start. It has to be followed by a parenthesis: "!x < 5"
+// compares !x in Verilog.
+static __attribute__((noinline)) void cond_not(Parser *parser)
+{
+    if (!parser->compound && !cond_start(parser, false))
+        return;
+    if (cond_push_op(parser, COND_NOT))
+        parser->state = READ_COND_NOT;
+}
+
+// A ')' of a compound condition, paren_count already down: move over the operators of the
+// group. The if's own closes the condition.
+static __attribute__((noinline)) void cond_close(Parser *parser)
+{
+    while (parser->cond_stack_count > 0 && parser->cond_stack[parser->cond_stack_count - 1] != COND_OPEN)
+    {
+        if (!cond_push_term(parser, parser->cond_stack[parser->cond_stack_count - 1]))
+            return;
+        parser->cond_stack_count--;
+    }
+    if (parser->cond_stack_count == 0)
+    {
+        parser->error_flag = true;
+        parser->error_code = SYNTAX_ERROR;
+        return;
+    }
+    parser->cond_stack_count--;
+
+    if (parser->paren_count == 0)
+        cond_compile(parser);
+}
+
+// A ')' right after the name of a comparison, "(x) < 5". As "!(x)" would be !x, the group
+// cannot follow a "!", nor be the if's own.
+static __attribute__((noinline)) void cond_close_name(Parser *parser)
+{
+    size_t count = parser->cond_stack_count;
+
+    if (parser->paren_count == 0 || count < 2 || parser->cond_stack[count - 1] != COND_OPEN ||
+        parser->cond_stack[count - 2] == COND_NOT)
+    {
+        parser->error_flag = true;
+        parser->error_code = SYNTAX_ERROR;
+        return;
+    }
+    parser->cond_stack_count--;
+}
+
+// Nested if-else
+//
+// An "if" where an assignment could start opens a nested block. The fields of the enclosing
+// block are saved in a frame, and the nested block is read by the same states as a block of
+// its own, with the buffers of its depth. Its final "end" restores the enclosing block, which
+// goes on as after an assignment, with the variables of the nested block added to the branch
+// it is in. So the branches of every depth are checked against each other as usual.
+//
+// Every block is read into an Ast as well, kept only if it turns out to be nested. Nodes are
+// appended as they are read, which lays them out depth first: an arm's AST_IF when the arm
+// starts, completed when its branch closes and ended with its block, and an AST_ASSIGN at
+// every ';'. Where an assignment goes on to is only known once the whole block is read,
+// ast_link sets it.
+typedef struct
+{
+    uint32_t node;          // An AST_IF around the node being linked
+    uint32_t after;         // Node that runs after its if-else
+} AstLink;
+
+// The block of this depth is read, the AST_IF of each of its arms ends here
+static void ast_end_arms(Parser *parser)
+{
+    AstNode *nodes = ast_building(parser->arena)->nodes;
+    uint32_t end = (uint32_t)parser->arena->node_count;
+
+    for (size_t i = parser->ast_first_if; ; i = nodes[i].jump)
+    {
+        nodes[i].end = end;
+        if (i == parser->ast_if)
+            break;
+    }
+}
+
+// Point every AST_ASSIGN at the node that runs after it, and set its slot. That is the next
+// statement of its branch, or for the last one what runs after the if-else around it;
+// node_count after the outermost one. The stack of enclosing AST_IFs has room for every node.
+static void ast_link(const Parser *parser, Ast *ast, AstLink *stack)
+{
+    AstNode *nodes = ast->nodes;
+    size_t top = 0;
+
+    for (size_t i = 0; i < ast->node_count; i++)
+    {
+        AstNode *node = &nodes[i];
+        uint32_t after = (uint32_t)ast->node_count;
+
+        while (top > 0 && nodes[stack[top - 1].node].end <= i)
+            top--;
+        if (top > 0)
+        {
+            const AstNode *parent = &nodes[stack[top - 1].node];
+            bool last = node->end == parent->jump || node->end == parent->end;
+
+            after = last ? stack[top - 1].after : node->end;
+        }
+
+        if (node->kind == AST_IF)
+        {
+            stack[top].node = (uint32_t)i;
+            stack[top].after = after;
+            top++;
+        }
+        else
+        {
+            node->jump = after;
+            node->slot = (uint32_t)(assignment_slot(parser, node->var_id, ast->var_count) - 1);
+        }
+    }
+}
+
+// The outermost block of a nested one is read: store its variables and Conditions behind
+// the nodes, link the assignments and keep the Ast. Returns false with OUT_OF_MEMORY flagged
+// on failure.
+static __attribute__((noinline)) bool ast_finish(Parser *parser)
+{
+    size_t var_count = parser->branch_size;
+    size_t count = parser->arena->node_count;
+    size_t condition_size = parser->cond_code_size;
+    AstChunk *chunk;
+    Ast *ast;
+    int *vars;
+
+    ast_end_arms(parser);
+
+    // Room for the variables, the Conditions and, past them, ast_link's stack
+    if (!ast_reserve(parser, (var_count * sizeof(int) + condition_size + count * sizeof(AstLink)) / sizeof(AstNode) +
+                             1))
+        return false;
+
+    chunk = parser->arena->chunk;
+    ast = ast_building(parser->arena);
+    ast->node_count = count;
+    ast->var_count = var_count;
+    ast->condition_size = condition_size;
+    vars = (int *)(ast->nodes + count);
+    for (size_t i = 0; i < var_count; i++)
+        vars[i] = parser->assignments[i].var_id;
+    if (condition_size > 0)
+        memcpy(vars + var_count, parser->cond_code, condition_size);
+    ast_link(parser, ast, (AstLink *)((unsigned char *)(vars + var_count) + condition_size));
+
+    ast->cond_var_id = ast->nodes[0].var_id;
+    for (size_t i = 1; i < count; i++)
+    {
+        if (ast->nodes[i].kind == AST_IF && ast->nodes[i].var_id != ast->cond_var_id)
+            ast->cond_var_id = -1;
+    }
+
+    chunk->used = (chunk->used + AST_SIZE(count) + var_count * sizeof(int) + condition_size + 7) & ~(size_t)7;
+    ast_arena_fit(parser->arena);
+    parser->ast = ast;
+    return true;
+}
+
+// "if" read where an assignment starts (state is where the enclosing block goes on after
+// the nested one), ascii_char is the char after it
+static __attribute__((noinline)) void start_nested_if(Parser *parser, char ascii_char, int state)
+{
+    NestFrame *frame;
+
+    if (state == READ_SEMICOLON2 && !parser->in_else_branch)
+        open_else_branch(parser);
+
+    if (parser->depth == parser->frame_capacity)
+    {
+        size_t capacity = parser->frame_capacity ? parser->frame_capacity * 2 : 8;
+        NestFrame *frames = realloc(parser->frames, capacity * sizeof(NestFrame));
+
+        if (frames == NULL)
+        {
+            parser->error_flag = true;
+            parser->error_code = OUT_OF_MEMORY;
+            return;
+        }
+        memset(frames + parser->frame_capacity, 0, (capacity - parser->frame_capacity) * sizeof(NestFrame));
+        parser->frames = frames;
+        parser->frame_capacity = capacity;
+    }
+
+    if (ast_append(parser, AST_IF) == NULL)
+        return;
+
+    frame = &parser->frames[parser->depth++];
+    frame->state = state;
+    frame->cond_var_id = parser->cond_var_id;
+    frame->comparator = parser->comparator;
+    frame->valC = parser->valC;
+    frame->assignment_var_id = parser->assignment_var_id;
+    frame->assignment_var2_id = parser->assignment_var2_id;
+    frame->const1 = parser->const1;
+    frame->const2 = parser->const2;
+    frame->blocking_assignment1 = parser->blocking_assignment1;
+    frame->blocking_assignment2 = parser->blocking_assignment2;
+    frame->in_else_branch = parser->in_else_branch;
+    frame->var_mismatch = parser->var_mismatch;
+    frame->arm_count = parser->arm_count;
+    frame->assignment_count = parser->assignment_count;
+    frame->branch_index = parser->branch_index;
+    frame->branch_size = parser->branch_size;
+    frame->branch_filled = parser->branch_filled;
+    frame->ast_if = parser->ast_if;
+    frame->ast_first_if = parser->ast_first_if;
+    nest_swap_buffers(parser, frame);
+
+    // The nested block starts like a block of its own after its "if"
+    parser->cond_var_id = -1;
+    parser->comparator = 0;
+    parser->valC = 0;
+    parser->is_valC_negative = false;
+    parser->assignment_var_id = -1;
+    parser->assignment_var2_id = -1;
+    parser->const1 = 0;
+    parser->const2 = 0;
+    parser->blocking_assignment1 = false;
+    parser->blocking_assignment2 = false;
+    parser->in_else_branch = false;
+    parser->var_mismatch = false;
+    parser->arm_count = 0;
+    parser->assignment_count = 0;
+    parser->branch_index = 0;
+    parser->branch_size = 0;
+    parser->branch_filled = 0;
+    parser->ast_if = parser->arena->node_count - 1;
+    parser->ast_first_if = parser->ast_if;
+    parser->nested = true;
+
+    parser->reading_var = false;
+    parser->keyword_index = 0;
+    parser->op_first = 0;
+    parser->state = READ_OPEN_PAREN;
+    if (ascii_char == '(')
+        process_char(parser, ascii_char);
+}
+
+// The final end of a nested block: go back to the enclosing one and add the variables the
+// nested block assigns to its branch
+static void nest_finish(Parser *parser)
+{
+    NestFrame *frame = &parser->frames[parser->depth - 1];
+    size_t count = parser->branch_size;
+
+    ast_end_arms(parser);
+    clear_assignments(parser);
+    nest_pop(parser);
+
+    // The pairs are still in the buffer the frame got back
+    for (size_t i = 0; i < count && !parser->error_flag; i++)
+        assignment_record(parser, frame->assignments[i].var_id, 0);
+}
+
+// The final 'd' has been read: check the branches against each other and build the results
+// that outlive the parse. Returns true once the outermost block is complete; false when a
+// nested block ends, or with the error flagged on failure.
+static __attribute__((noinline)) bool block_finish(Parser *parser)
+{
+    close_branch(parser);
+    parser->var_match = var_names_match(parser);
+    if (!parser->var_match)
+    {
+        parser->error_flag = true;
+        parser->error_code = VAR_MISMATCH;
+        return false;
+    }
+    if (parser->depth > 0)
+    {
+        nest_finish(parser);
+        return false;
+    }
+    if (parser->nested)
+        return ast_finish(parser);
+    return branches_finish(parser) && (parser->arm_count == 0 || ladder_finish(parser));
+}
+
+// Another assignment starts after a ';'. The keyword_length letters of "end" already taken as
+// a keyword begin its name, and ascii_char is read as the next char of the name.
+static __attribute__((noinline)) void next_assignment(Parser *parser, int keyword_length, int state, char ascii_char)
+{
+    parser->name_length = 0;
+    for (int k = 0; k < keyword_length; k++)
+        name_append(parser, "end"[k]);
+    parser->keyword_index = 0;
+    parser->reading_var = keyword_length > 0;
+    parser->state = state;
+    process_char(parser, ascii_char);
+}
+
+static bool is_id_byte(char c)
+{
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// The "end" of a false branch has been read and the char after it does not continue a name
+static __attribute__((noinline)) void end_false_branch(Parser *parser)
+{
+    parser->keyword_index = 0;
+    if (block_finish(parser))
+    {
+        parser->state = EVALUATE;
+        parser->parsing_done = true;
+    }
+}
+
+// After a ';', "end" is only the keyword when the char after it cannot continue a name, as in
+// "end_flag <= 1;". The parse loops look at that char before they take it: when it completes
+// the outermost block it is left for whatever follows. Returns true if the "end" was closed.
+static inline bool end_at_boundary(Parser *parser, char next)
+{
+    if (parser->state != READ_END2 || parser->keyword_index != 3 || is_id_byte(next))
+        return false;
+    end_false_branch(parser);
+    return true;
+}
+
+// Largest magnitude of the literal read in state: INT_MAX, or INT_MAX + 1 after a '-'
+static inline int64_t literal_limit(const Parser *parser, int state)
+{
+    if (state == READ_VALC)
+        return (int64_t)INT_MAX + parser->is_valC_negative;
+    if (state == READ_CONST1)
+        return (int64_t)INT_MAX + parser->is_const1_negative;
+    return (int64_t)INT_MAX + parser->is_const2_negative;
+}
+
+// Append a decimal digit to num_buffer, flags NUM_OVERFLOW instead of going past the range
+// of int
+static void accumulate_digit(Parser *parser, char ascii_char)
+{
+    int digit = ascii_char - '0';
+
+    if (parser->num_buffer > (literal_limit(parser, parser->state) - digit) / 10)
+    {
+        parser->error_flag = true;
+        parser->error_code = NUM_OVERFLOW;
+        return;
+    }
+
+    parser->num_buffer = (parser->num_buffer * 10) + digit;
+}
+
+void debug_print(Parser *parser, char ascii_char)
+{
+    if (!parser->debug_mode)
+        return;
+
+    printf("State: %2d, curr_char: %c (0x%02x), parsing_number: %d\n",
+           parser->state, ascii_char, ascii_char, parser->parsing_number);
+
+    printf("cond_var: %-16s", symbol_name(parser->symbols, parser->cond_var_id));
+    printf(", assignment_var: %-16s", symbol_name(parser->symbols, parser->assignment_var_id));
+    printf(", assignment_var2: %-16s", symbol_name(parser->symbols, parser->assignment_var2_id));
+
+    printf(", paren_count: %d\n", parser->paren_count);
+    printf("valC: %11d, const1: %11d, const2: %11d, error_code: %2d\n",
+           parser->valC, parser->const1, parser->const2, parser->error_code);
+    printf("---------------------------------------------------------------------------------------------------------------------------------------------\n\n");
+}
+
+void process_char(Parser *parser, char ascii_char)
+{
+    debug_print(parser, ascii_char);
+
+    bool is_digit = isdigit((unsigned char)ascii_char);
+    bool is_letter = isalpha((unsigned char)ascii_char);
+    bool is_underscore = (ascii_char == '_');
+    bool is_id_start = is_letter;
+    bool is_id_char = is_letter || is_digit || is_underscore;
+    bool is_whitespace = (ascii_char == ' ' || ascii_char == '\t' || ascii_char == '\n' || ascii_char == '\r');
+
+    switch (parser->state)
+    {
+    case IDLE:
+        if (is_whitespace)
+        {
+            parser->state = IDLE;
+        }
+        else if (ascii_char == 'i')
+        {
+            parser->keyword_index = 1;
+            parser->state = READ_IF;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_IF:
+        if (ascii_char == 'f')
+        {
+            parser->keyword_index = 0;
+            parser->state = READ_OPEN_PAREN;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_OPEN_PAREN:
+        if (is_whitespace)
+        {
+            parser->state = READ_OPEN_PAREN;
+        }
+        else if (ascii_char == '(')
+        {
+            parser->paren_count++;
+            parser->state = READ_VAR;
+            parser->reading_var = false;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_VAR:
+        if (is_whitespace && !parser->reading_var)
+        {
+            parser->state = READ_VAR;
+        }
+        else if (!parser->reading_var && is_id_start)
+        {
+            // First character of identifier - must be a letter
+            parser->name_length = 0;
+            name_append(parser, ascii_char);
+            parser->reading_var = true;
+        }
+        else if (parser->reading_var && is_id_char)
+        {
+            // Subsequent characters - can be letter, digit, or underscore
+            name_append(parser, ascii_char);
+        }
+        else if (parser->reading_var && (is_whitespace || ascii_char == '>' || ascii_char == '<' ||
+                                         ascii_char == '=' || ascii_char == '!'))
+        {
+            // Variable name complete, ready for operator
+            parser->cond_var_id = name_end(parser);
+            parser->state = READ_COND_OPERATOR;
+            parser->reading_var = false;
+
+            // Process operator right away if not whitespace
+            if (!is_whitespace)
+            {
+                if (parser->paren_count == 0)
+                {
+                    parser->error_flag = true;
+                    parser->error_code = SYNTAX_ERROR;
+                }
+                parser->op_first = ascii_char;
+                parser->state = READ_COND_OPERATOR2;
+            }
+        }
+        else if (ascii_char == '(')
+        {
+            // Opening nested parenthesis
+            parser->paren_count++;
+            if (parser->compound)
+                cond_push_op(parser, COND_OPEN);
+        }
+        else if (ascii_char == '!' && !parser->reading_var)
+        {
+            cond_not(parser);
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_COND_OPERATOR:
+        if (is_whitespace)
+        {
+            parser->state = READ_COND_OPERATOR;
+        }
+        else if (ascii_char == ')')
+        {
+            if (parser->paren_count == 0)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            parser->paren_count--;
+            if (parser->compound)
+                cond_close_name(parser);
+        }
+        else if (ascii_char == '<' || ascii_char == '>' || ascii_char == '=' || ascii_char == '!')
+        {
+            if (parser->paren_count == 0)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            parser->op_first = ascii_char;
+            parser->state = READ_COND_OPERATOR2;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_CHAR;
+        }
+        break;
+
+    case READ_COND_OPERATOR2:
+        // Handle whitespace first
+        if (is_whitespace)
+        {
+            // Just stay in the same state
+            break;
+        }
+        // Check if there's a negative sign ("-") before the digit
+        else if (ascii_char == '-')
+        {
+            parser->is_valC_negative = true;
+        }
+
+        switch (parser->op_first)
+        {
+        case '<':
+            if (ascii_char == '=')
+            {
+                parser->comparator = LE;
+                parser->state = READ_VALC;
+            }
+            else if (is_digit)
+            {
+                parser->comparator = LT; // single-character "<"
+                // Start processing the digit immediately
+                accumulate_digit(parser, ascii_char);
+                parser->parsing_number = true;
+                parser->state = READ_VALC;
+            }
+            else if (ascii_char == '(')
+            {
+                parser->comparator = LT;
+                parser->paren_count++;
+                if (parser->compound)
+                    cond_push_op(parser, COND_OPEN);
+                parser->state = READ_VALC;
+            }
+            else if (!is_whitespace) 
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            break;
+
+        case '>':
+            if (ascii_char == '=')
+            {
+                parser->comparator = GE;
+                parser->state = READ_VALC;
+            }
+            else if (is_digit)
+            {
+                parser->comparator = GT; // single-character ">"
+                // Start processing the digit immediately
+                accumulate_digit(parser, ascii_char);
+                parser->parsing_number = true;
+                parser->state = READ_VALC;
+            }
+            else if (ascii_char == '(')
+            {
+                parser->comparator = GT;
+                parser->paren_count++;
+                if (parser->compound)
+                    cond_push_op(parser, COND_OPEN);
+                parser->state = READ_VALC;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            break;
+
+        case '=':
+            if (ascii_char == '=')
+            {
+                parser->comparator = EQ;
+                parser->state = READ_VALC;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = MISSING_OPERATOR;
+            }
+            break;
+
+        case '!':
+            if (ascii_char == '=')
+            {
+                parser->comparator = NE;
+                parser->state = READ_VALC;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = MISSING_OPERATOR;
+            }
+            break;
+
+        default:
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+            break;
+        }
+        break;
+
+    case READ_VALC:
+        if (is_whitespace)
+        {
+            parser->state = READ_VALC;
+        }
+        // Check if there's a negative sign ("-") before the digit
+        else if (ascii_char == '-' && !parser->parsing_number)
+        {
+            parser->is_valC_negative = true;
+        }
+        else if (ascii_char == '(' && !parser->parsing_number)
+        {
+            parser->paren_count++;
+            if (parser->compound)
+                cond_push_op(parser, COND_OPEN);
+        }
+        else if (is_digit)
+        {
+            accumulate_digit(parser, ascii_char);
+            parser->parsing_number = true;
+        }
+        else if (parser->parsing_number)
+        {
+            if (parser->is_valC_negative)
+                parser->valC = (int)-parser->num_buffer;
+            else
+                parser->valC = (int)parser->num_buffer;
+
+            parser->num_buffer = 0;
+            parser->parsing_number = false;
+            if (parser->compound)
+                cond_compare(parser);
+
+            if (ascii_char == ')')
+            {
+                if (parser->paren_count == 0)
+                {
+                    parser->error_flag = true;
+                    parser->error_code = SYNTAX_ERROR;
+                }
+                parser->paren_count--;
+                parser->state = READ_CLOSE_PAREN;
+                if (parser->compound && !parser->error_flag)
+                    cond_close(parser);
+            }
+            else if ((ascii_char == '&' || ascii_char == '|') && parser->paren_count > 0)
+            {
+                cond_logic(parser, ascii_char);
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+        }
+        break;
+
+    case READ_CLOSE_PAREN:
+        if (is_whitespace)
+        {
+            parser->state = READ_CLOSE_PAREN;
+        }
+        else if (ascii_char == 'b')
+        {
+            parser->keyword_index = 1;
+            strcpy(parser->keyword_buffer, "b");
+            if (parser->paren_count != 0)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            parser->state = READ_BEGIN;
+        }
+        else if (ascii_char == ')')
+        {
+            parser->paren_count--;
+            if (parser->compound)
+                cond_close(parser);
+        }
+        else if ((ascii_char == '&' || ascii_char == '|') && parser->paren_count > 0)
+        {
+            cond_logic(parser, ascii_char);
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_BEGIN:
+        switch (parser->keyword_index)
+        {
+        case 1:
+            if (ascii_char == 'e')
+            {
+                strcat(parser->keyword_buffer, "e");
+                parser->keyword_index++;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 2:
+            if (ascii_char == 'g')
+            {
+                strcat(parser->keyword_buffer, "g");
+                parser->keyword_index++;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 3:
+            if (ascii_char == 'i')
+            {
+                strcat(parser->keyword_buffer, "i");
+                parser->keyword_index++;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 4:
+            if (ascii_char == 'n')
+            {
+                parser->keyword_index = 0;
+                parser->state = READ_ASSIGNMENT_VAR;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        default:
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+            break;
+        }
+        break;
+
+    case READ_ASSIGNMENT_VAR:
+        if (is_whitespace && !parser->reading_var)
+        {
+            parser->state = READ_ASSIGNMENT_VAR;
+        }
+        else if (!parser->reading_var && is_id_start)
+        {
+            // First character of identifier - must be a letter
+            parser->name_length = 0;
+            name_append(parser, ascii_char);
+            parser->reading_var = true;
+        }
+        else if (parser->reading_var && is_id_char)
+        {
+            // Subsequent characters - can be letter, digit, or underscore
+            name_append(parser, ascii_char);
+        }
+        else if (parser->reading_var && (is_whitespace || ascii_char == '(') && name_is_if(parser))
+        {
+            start_nested_if(parser, ascii_char, READ_SEMICOLON1);
+        }
+        else if (parser->reading_var && (is_whitespace || ascii_char == '=' || ascii_char == '<'))
+        {
+            // Variable name complete, ready for operator
+            parser->assignment_var_id = name_end(parser);
+            parser->state = READ_ASSIGNMENT_OPERATOR;
+            parser->reading_var = false;
+
+            // Process operator rightaway if not whitespace
+            if (!is_whitespace)
+            {
+                if (ascii_char == '<')
+                {
+                    parser->blocking_assignment1 = false;
+                    parser->op_first = '<';
+                }
+                else if (ascii_char == '=')
+                {
+                    parser->blocking_assignment1 = true;
+                    parser->op_first = 0;
+                    parser->num_buffer = 0;
+                    parser->parsing_number = false;
+                    parser->is_const1_negative = false;
+                    parser->state = READ_CONST1;
+                }
+            }
+        }
+        else if (ascii_char == '(')
+        {
+            parser->paren_count++;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_ASSIGNMENT_OPERATOR:
+        if (is_whitespace)
+        {
+            parser->state = READ_ASSIGNMENT_OPERATOR;
+        }
+        else if (ascii_char == ')')
+            parser->paren_count--;
+        else if (ascii_char == '<')
+        {
+            parser->blocking_assignment1 = false;
+            parser->state = READ_ASSIGNMENT_OPERATOR;
+        }
+        else if (ascii_char == '=')
+        {
+            if (parser->op_first == '<')
+            {
+                parser->blocking_assignment1 = false; // non-blocking (<=)
+            }
+            else
+            {
+                parser->blocking_assignment1 = true; // blocking (=)
+            }
+            parser->op_first = 0;
+            parser->num_buffer = 0;
+            parser->parsing_number = false;
+            parser->is_const1_negative = false;
+            parser->state = READ_CONST1;
+        }
+        else
+        {
+            parser->op_first = ascii_char;
+        }
+        break;
+
+    case READ_CONST1:
+        if (is_whitespace)
+        {
+            if (parser->is_const1_negative || parser->parsing_number)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            else
+            {
+                parser->state = READ_CONST1;
+            }
+        }
+        else if (ascii_char == '(' && !parser->parsing_number)
+        {
+            parser->paren_count++;
+        }
+        else if (ascii_char == ')')
+        {
+            if (parser->num_buffer == 0)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            else
+            {
+                parser->paren_count--;
+            }
+        }
+        // Check if there's a negative sign ("-") before the digit
+        else if (ascii_char == '-' && !parser->parsing_number)
+        {
+            parser->is_const1_negative = true;
+        }
+        else if (is_digit)
+        {
+            accumulate_digit(parser, ascii_char);
+            parser->parsing_number = true;
+        }
+        else if (parser->parsing_number)
+        {
+            if (parser->is_const1_negative)
+                parser->const1 = (int)-parser->num_buffer;
+            else
+                parser->const1 = (int)parser->num_buffer;
+
+            parser->num_buffer = 0;
+            parser->parsing_number = false;
+
+            if (ascii_char == ';')
+            {
+                assignment_push(parser, parser->assignment_var_id, parser->const1, false);
+                parser->state = READ_SEMICOLON1;
+            }
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_SEMICOLON1:
+        if (parser->paren_count != 0)
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        if (is_whitespace)
+        {
+            parser->state = READ_SEMICOLON1;
+        }
+        else if (ascii_char == 'e')
+        {
+            parser->keyword_index = 1;
+            strcpy(parser->keyword_buffer, "e");
+            parser->state = READ_END1;
+        }
+        else if (is_id_start)
+        {
+            next_assignment(parser, 0, READ_ASSIGNMENT_VAR, ascii_char);
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_END1:
+        switch (parser->keyword_index)
+        {
+        case 1:
+            if (ascii_char == 'n')
+            {
+                strcat(parser->keyword_buffer, "n");
+                parser->keyword_index++;
+            }
+            else if (is_id_char || is_whitespace || ascii_char == '=' || ascii_char == '<')
+            {
+                // An assignment to a name that starts like "end"
+                next_assignment(parser, 1, READ_ASSIGNMENT_VAR, ascii_char);
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 2:
+            if (ascii_char == 'd')
+            {
+                parser->keyword_index++;
+            }
+            else if (is_id_char || is_whitespace || ascii_char == '=' || ascii_char == '<')
+            {
+                // An assignment to a name that starts like "end"
+                next_assignment(parser, 2, READ_ASSIGNMENT_VAR, ascii_char);
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 3:
+            // "end" is a keyword only if this char does not continue the name
+            if (is_id_char)
+            {
+                next_assignment(parser, 3, READ_ASSIGNMENT_VAR, ascii_char);
+            }
+            else
+            {
+                parser->keyword_index = 0;
+                parser->state = READ_ELSE;
+                process_char(parser, ascii_char);
+            }
+            break;
+
+        default:
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+            break;
+        }
+        break;
+
+    case READ_ELSE:
+        if (is_whitespace)
+        {
+            parser->state = READ_ELSE;
+        }
+        else if (ascii_char == 'e' && parser->keyword_index == 0)
+        {
+            parser->keyword_index = 1;
+            strcpy(parser->keyword_buffer, "e");
+        }
+        else if (parser->keyword_index == 1 && ascii_char == 'l')
+        {
+            strcat(parser->keyword_buffer, "l");
+            parser->keyword_index++;
+        }
+        else if (parser->keyword_index == 2 && ascii_char == 's')
+        {
+            strcat(parser->keyword_buffer, "s");
+            parser->keyword_index++;
+        }
+        else if (parser->keyword_index == 3 && ascii_char == 'e')
+        {
+            parser->keyword_index = 0;
+            parser->state = READ_BEGIN2;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_BEGIN2:
+        if (is_whitespace)
+        {
+            parser->state = READ_BEGIN2;
+        }
+        else if (ascii_char == 'i' && parser->keyword_index == 0)
+        {
+            // "else if", the next arm of a ladder
+            start_else_if(parser);
+        }
+        else if (ascii_char == 'b')
+        {
+            parser->keyword_index = 1;
+            strcpy(parser->keyword_buffer, "b");
+            parser->state = READ_BEGIN2;
+        }
+        else if (parser->keyword_index == 1 && ascii_char == 'e')
+        {
+            strcat(parser->keyword_buffer, "e");
+            parser->keyword_index++;
+        }
+        else if (parser->keyword_index == 2 && ascii_char == 'g')
+        {
+            strcat(parser->keyword_buffer, "g");
+            parser->keyword_index++;
+        }
+        else if (parser->keyword_index == 3 && ascii_char == 'i')
+        {
+            strcat(parser->keyword_buffer, "i");
+            parser->keyword_index++;
+        }
+        else if (parser->keyword_index == 4 && ascii_char == 'n')
+        {
+            parser->keyword_index = 0;
+            parser->state = READ_ASSIGNMENT_VAR2;
+            parser->reading_var = false;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_ASSIGNMENT_VAR2:
+        if (is_whitespace && !parser->reading_var)
+        {
+            parser->state = READ_ASSIGNMENT_VAR2;
+        }
+        else if (!parser->reading_var && is_id_start)
+        {
+            // First character of identifier - must be a letter
+            parser->name_length = 0;
+            name_append(parser, ascii_char);
+            parser->reading_var = true;
+        }
+        else if (parser->reading_var && is_id_char)
+        {
+            // Subsequent characters - can be letter, digit, or underscore
+            name_append(parser, ascii_char);
+        }
+        else if (parser->reading_var && (is_whitespace || ascii_char == '(') && name_is_if(parser))
+        {
+            start_nested_if(parser, ascii_char, READ_SEMICOLON2);
+        }
+        else if (parser->reading_var && (is_whitespace || ascii_char == '=' || ascii_char == '<'))
+        {
+            // Variable name complete, ready for operator
+            parser->assignment_var2_id = name_end(parser);
+            parser->state = READ_ASSIGNMENT_OPERATOR2;
+            parser->reading_var = false;
+
+            // Process operator rightaway if not whitespace
+            if (!is_whitespace)
+            {
+                if (ascii_char == '<')
+                {
+                    parser->blocking_assignment2 = false;
+                    parser->op_first = '<';
+                }
+                else if (ascii_char == '=')
+                {
+                    parser->blocking_assignment2 = true;
+                    parser->op_first = 0;
+                    parser->num_buffer = 0;
+                    parser->parsing_number = false;
+                    parser->is_const2_negative = false;
+                    parser->state = READ_CONST2;
+                }
+            }
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_ASSIGNMENT_OPERATOR2:
+        if (is_whitespace)
+        {
+            parser->state = READ_ASSIGNMENT_OPERATOR2;
+        }
+        else if (ascii_char == ')')
+            parser->paren_count--;
+        else if (ascii_char == '<')
+        {
+            parser->blocking_assignment2 = false;
+            parser->op_first = '<';
+        }
+        else if (ascii_char == '=')
+        {
+            if (parser->op_first == '<')
+            {
+                parser->blocking_assignment2 = false; // non-blocking (<=)
+            }
+            else
+            {
+                parser->blocking_assignment2 = true; // blocking (=)
+            }
+            parser->op_first = 0;
+            parser->num_buffer = 0;
+            parser->parsing_number = false;
+            parser->is_const2_negative = false;
+            parser->state = READ_CONST2;
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_CONST2:
+        if (is_whitespace)
+        {
+            if (parser->is_const2_negative || parser->parsing_number)
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+            else
+            {
+                parser->state = READ_CONST2;
+            }
+        }
+        else if (ascii_char == '(' && !parser->parsing_number)
+        {
+            parser->paren_count++;
+        }
+        else if (ascii_char == ')')
+        {
+            if (parser->parsing_number)
+            {
+                parser->paren_count--;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+        }
+        // Check if there's a negative sign ("-") before the digit
+        else if (ascii_char == '-' && !parser->parsing_number)
+        {
+            parser->is_const2_negative = true;
+        }
+        else if (is_digit)
+        {
+            accumulate_digit(parser, ascii_char);
+            parser->parsing_number = true;
+        }
+        else if (parser->parsing_number)
+        {
+            if (parser->is_const2_negative)
+                parser->const2 = (int)-parser->num_buffer;
+            else
+                parser->const2 = (int)parser->num_buffer;
+
+            parser->num_buffer = 0;
+            parser->parsing_number = false;
+
+            if (ascii_char == ';')
+            {
+                assignment_push(parser, parser->assignment_var2_id, parser->const2, true);
+                parser->state = READ_SEMICOLON2;
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = SYNTAX_ERROR;
+            }
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    case READ_SEMICOLON2:
+        if (parser->paren_count != 0)
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        if (is_whitespace)
+        {
+            parser->state = READ_SEMICOLON2;
+        }
+        else if (ascii_char == 'e')
+        {
+            parser->keyword_index = 1;
+            strcpy(parser->keyword_buffer, "e");
+            parser->state = READ_END2;
+        }
+        else if (is_id_start)
+        {
+            next_assignment(parser, 0, READ_ASSIGNMENT_VAR2, ascii_char);
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = INVALID_KEYWORD;
+        }
+        break;
+
+    case READ_END2:
+        switch (parser->keyword_index)
+        {
+        case 1:
+            if (ascii_char == 'n')
+            {
+                strcat(parser->keyword_buffer, "n");
+                parser->keyword_index++;
+            }
+            else if (is_id_char || is_whitespace || ascii_char == '=' || ascii_char == '<')
+            {
+                // An assignment to a name that starts like "end"
+                next_assignment(parser, 1, READ_ASSIGNMENT_VAR2, ascii_char);
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 2:
+            if (ascii_char == 'd')
+            {
+                parser->keyword_index++;
+            }
+            else if (is_id_char || is_whitespace || ascii_char == '=' || ascii_char == '<')
+            {
+                // An assignment to a name that starts like "end"
+                next_assignment(parser, 2, READ_ASSIGNMENT_VAR2, ascii_char);
+            }
+            else
+            {
+                parser->error_flag = true;
+                parser->error_code = INVALID_KEYWORD;
+            }
+            break;
+
+        case 3:
+            // The parse loops close the "end" with end_at_boundary before taking this char,
+            // here it is only reached one char at a time and the char goes with the block
+            if (is_id_char)
+            {
+                next_assignment(parser, 3, READ_ASSIGNMENT_VAR2, ascii_char);
+            }
+            else
+            {
+                // Check if variable names match between the branches
+                end_false_branch(parser);
+                if (!parser->parsing_done && !parser->error_flag)
+                    process_char(parser, ascii_char);
+            }
+            break;
+
+        default:
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+            break;
+        }
+        break;
+
+    case EVALUATE:
+        // This state is reached when the parser has successfully parsed the if-else construct
+        // Evaluation logic is handled in another function
+        break;
+
+    case READ_COND_LOGIC:
+        cond_next(parser, ascii_char);
+        break;
+
+    case READ_COND_NOT:
+        if (is_whitespace)
+        {
+            parser->state = READ_COND_NOT;
+        }
+        else if (ascii_char == '(')
+        {
+            parser->paren_count++;
+            cond_push_op(parser, COND_OPEN);
+            parser->reading_var = false;
+            parser->state = READ_VAR;
+        }
+        else if (ascii_char == '!')
+        {
+            cond_not(parser);
+        }
+        else
+        {
+            parser->error_flag = true;
+            parser->error_code = SYNTAX_ERROR;
+        }
+        break;
+
+    default:
+        parser->error_flag = true;
+        parser->error_code = SYNTAX_ERROR;
+        break;
+    }
+}
+
+// Whitespace scanning
+//
+// Indentation makes up much of a typical input and is ignored by almost every state, so runs
+// of whitespace are skipped 16 (SSE2) or 32 (AVX2) bytes at a time before they reach the
+// state machine. The implementation is picked once at runtime from the CPU features.
+typedef const char *(*SkipWhitespaceFn)(const char *p, const char *end);
+
+static inline bool is_ws_char(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static const char *skip_whitespace_scalar(const char *p, const char *end)
+{
+    while (p < end && is_ws_char(*p))
+        p++;
+    return p;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+__attribute__((target("sse2")))
+static const char *skip_whitespace_sse2(const char *p, const char *end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i carriage_return = _mm_set1_epi8('\r');
+
+    while (end - p >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(chunk, newline), _mm_cmpeq_epi8(chunk, carriage_return)));
+        unsigned int not_ws = ~(unsigned int)_mm_movemask_epi8(ws) & 0xFFFFu;
+
+        if (not_ws != 0)
+            return p + __builtin_ctz(not_ws);
+        p += 16;
+    }
+
+    return skip_whitespace_scalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char *skip_whitespace_avx2(const char *p, const char *end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i carriage_return = _mm256_set1_epi8('\r');
+
+    while (end - p >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(chunk, newline), _mm256_cmpeq_epi8(chunk, carriage_return)));
+        unsigned int not_ws = ~(unsigned int)_mm256_movemask_epi8(ws);
+
+        if (not_ws != 0)
+            return p + __builtin_ctz(not_ws);
+        p += 32;
+    }
+
+    return skip_whitespace_sse2(p, end);
+}
+#endif
+
+static SkipWhitespaceFn skip_whitespace_impl = skip_whitespace_scalar;
+static pthread_once_t skip_whitespace_once = PTHREAD_ONCE_INIT;
+
+static void skip_whitespace_select(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        skip_whitespace_impl = skip_whitespace_avx2;
+    else if (__builtin_cpu_supports("sse2"))
+        skip_whitespace_impl = skip_whitespace_sse2;
+#endif
+}
+
+// Returns a pointer to the first non-whitespace char in [p, end), or end
+const char *skip_whitespace(const char *p, const char *end)
+{
+    // Single separators are common, don't pay for a vector load on them
+    if (p + 1 >= end || !is_ws_char(p[1]))
+        return p < end && is_ws_char(*p) ? p + 1 : p;
+
+    pthread_once(&skip_whitespace_once, skip_whitespace_select);
+    return skip_whitespace_impl(p, end);
+}
+
+// True if process_char would ignore a whitespace char in the parser's current state
+static bool whitespace_is_noop(const Parser *parser)
+{
+    switch (parser->state)
+    {
+    case IDLE:
+    case READ_OPEN_PAREN:
+    case READ_COND_OPERATOR:
+    case READ_COND_OPERATOR2:
+    case READ_VALC:
+    case READ_CLOSE_PAREN:
+    case READ_ASSIGNMENT_OPERATOR:
+    case READ_ELSE:
+    case READ_BEGIN2:
+    case READ_ASSIGNMENT_OPERATOR2:
+    case READ_COND_NOT:
+        return true;
+
+    case READ_VAR:
+    case READ_ASSIGNMENT_VAR:
+    case READ_ASSIGNMENT_VAR2:
+        return !parser->reading_var;
+
+    case READ_CONST1:
+        return !parser->is_const1_negative && !parser->parsing_number;
+
+    case READ_CONST2:
+        return !parser->is_const2_negative && !parser->parsing_number;
+
+    case READ_SEMICOLON1:
+    case READ_SEMICOLON2:
+        return parser->paren_count == 0;
+
+    default:
+        return false;
+    }
+}
+
+// Word-at-a-time scanning
+//
+// Keywords and integer literals are matched 8 bytes at a time with one unaligned load:
+// a keyword is a masked compare against the expected word, a literal is classified and
+// converted with SWAR arithmetic. Both fast paths need a full word in the buffer and give
+// up on anything unusual (a literal that would overflow, a keyword in a state with pending
+// sub-state), leaving the buffer edges and the error reporting to the per-char paths.
+// The byte order of the conversion assumes a little-endian load.
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SWAR_ENABLED 1
+#else
+#define SWAR_ENABLED 0
+#endif
+#define SWAR_WIDTH 8
+
+static const uint32_t swar_pow10[SWAR_WIDTH + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static inline uint64_t swar_load(const char *p)
+{
+    uint64_t word;
+
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Number of leading decimal digits in the word, 0-8
+static inline int swar_digit_count(uint64_t word)
+{
+    // A byte is a digit if its high nibble is 3 and adding 6 to its low nibble does not carry
+    uint64_t high = (word & 0xF0F0F0F0F0F0F0F0ULL) ^ 0x3030303030303030ULL;
+    uint64_t low = ((word & 0x0F0F0F0F0F0F0F0FULL) + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+    uint64_t non_digit = high | low;
+
+    return non_digit ? __builtin_ctzll(non_digit) / 8 : SWAR_WIDTH;
+}
+
+// Value of the first count (1-8) digits of the word
+static inline uint32_t swar_digits_value(uint64_t word, int count)
+{
+    // Drop the bytes after the digits, the digits move up and leading zeros come in below
+    word = (word - 0x3030303030303030ULL) << (8 * (SWAR_WIDTH - count));
+
+    // Combine neighbouring lanes: 8 digits -> 4 pairs -> 2 groups of 4 -> 1 value
+    word = ((word * 10) + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+    word = ((word * 100) + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+    word = ((word * 10000) + (word >> 32)) & 0x00000000FFFFFFFFULL;
+    return (uint32_t)word;
+}
+
+// Append the run of digits at p to num_buffer, up to 8 of them, for a literal read in state.
+// Returns the number of digits taken, 0 if less than a word is left or the value would
+// overflow (the per-char path then flags NUM_OVERFLOW at the offending digit).
+static size_t swar_accumulate_digits(Parser *parser, int state, const char *p, const char *end)
+{
+    uint64_t word;
+    int count;
+    int64_t value;
+
+    if (!SWAR_ENABLED || end - p < SWAR_WIDTH)
+        return 0;
+
+    word = swar_load(p);
+    count = swar_digit_count(word);
+    if (count == 0)
+        return 0;
+
+    value = parser->num_buffer * swar_pow10[count] + swar_digits_value(word, count);
+    if (value > literal_limit(parser, state))
+        return 0;
+
+    parser->num_buffer = value;
+    return (size_t)count;
+}
+
+// Table-driven engine
+//
+// An alternative to the process_char switch for the hot loop. Every byte is mapped to a
+// character class through a 256-entry table, and (DFA state, class) selects the next DFA
+// state plus an action. DFA states split the Verilog-numbered states by the sub-state that
+// process_char keeps in keyword_index, reading_var and parsing_number, so the common
+// transitions (whitespace, identifier and digit runs, keyword letters) need no per-char tests.
+// Every transition that is rare or can raise an error is routed through process_char itself
+// (DFA_FALLBACK), so both engines accept the same inputs and report the same error codes.
+// keyword_buffer is not filled in by this engine, it is only scratch space for process_char.
+
+// Character classes
+enum
+{
+    CC_WS,
+    CC_DIGIT,
+    CC_LETTER,     // Letters that are not used by any keyword
+    CC_UNDERSCORE,
+    CC_I,          // Keyword letters of "if", "begin", "end" and "else"
+    CC_F,
+    CC_B,
+    CC_E,
+    CC_G,
+    CC_N,
+    CC_L,
+    CC_S,
+    CC_D,
+    CC_OTHER,
+    CC_NUM
+};
+
+// DFA states
+enum
+{
+    DS_SLOW,        // Sub-state not modelled by the table, every char goes to process_char
+    DS_IDLE,
+    DS_READ_IF,
+    DS_OPEN_PAREN,
+    DS_VAR_WAIT,
+    DS_VAR_IN,
+    DS_COND_OP,
+    DS_COND_OP2,
+    DS_VALC_WAIT,
+    DS_VALC_NUM,
+    DS_CLOSE_PAREN,
+    DS_BEGIN_K1,
+    DS_BEGIN_K2,
+    DS_BEGIN_K3,
+    DS_BEGIN_K4,
+    DS_AVAR_WAIT,
+    DS_AVAR_IN,
+    DS_AOP,
+    DS_CONST1_WAIT,
+    DS_CONST1_NUM,
+    DS_SEMI1,
+    DS_END1_K1,
+    DS_END1_K2,
+    DS_END1_K3,
+    DS_ELSE_K0,
+    DS_ELSE_K1,
+    DS_ELSE_K2,
+    DS_ELSE_K3,
+    DS_BEGIN2_K0,
+    DS_BEGIN2_K1,
+    DS_BEGIN2_K2,
+    DS_BEGIN2_K3,
+    DS_BEGIN2_K4,
+    DS_AVAR2_WAIT,
+    DS_AVAR2_IN,
+    DS_AOP2,
+    DS_CONST2_WAIT,
+    DS_CONST2_NUM,
+    DS_SEMI2,
+    DS_END2_K1,
+    DS_END2_K2,
+    DS_EVALUATE,
+    DS_NUM
+};
+
+// Transition actions
+enum
+{
+    DFA_NONE,
+    DFA_FALLBACK,     // Let process_char handle this char
+    DFA_SKIP_WS,      // Ignored whitespace, skip the whole run
+    DFA_NAME_START,   // First char of an identifier
+    DFA_NAME_APPEND,
+    DFA_VAR_END,      // Intern the identifier as the condition variable
+    DFA_AVAR_END,
+    DFA_AVAR2_END,
+    DFA_DIGIT,
+    DFA_WS_CONST1,    // Whitespace before const1, an error after a '-'
+    DFA_WS_CONST2,
+    DFA_WS_SEMI,      // Whitespace after a ';', an error with unbalanced parentheses
+    DFA_KEYWORD       // First letter of a keyword, try to match all of it at once
+};
+
+typedef struct
+{
+    unsigned char next;
+    unsigned char action;
+} DfaEntry;
+
+// Parser fields implied by a DFA state, -1 where the DFA state does not fix the field
+typedef struct
+{
+    signed char state;
+    signed char keyword_index;
+    signed char reading_var;
+    signed char parsing_number;
+} DfaStateInfo;
+
+static const DfaStateInfo dfa_state_info[DS_NUM] = {
+    [DS_SLOW]        = {-1, -1, -1, -1},
+    [DS_IDLE]        = {IDLE, 0, 0, 0},
+    [DS_READ_IF]     = {READ_IF, 1, 0, 0},
+    [DS_OPEN_PAREN]  = {READ_OPEN_PAREN, 0, 0, 0},
+    [DS_VAR_WAIT]    = {READ_VAR, 0, 0, 0},
+    [DS_VAR_IN]      = {READ_VAR, 0, 1, 0},
+    [DS_COND_OP]     = {READ_COND_OPERATOR, 0, 0, 0},
+    [DS_COND_OP2]    = {READ_COND_OPERATOR2, 0, 0, 0},
+    [DS_VALC_WAIT]   = {READ_VALC, 0, 0, 0},
+    [DS_VALC_NUM]    = {READ_VALC, 0, 0, 1},
+    [DS_CLOSE_PAREN] = {READ_CLOSE_PAREN, 0, 0, 0},
+    [DS_BEGIN_K1]    = {READ_BEGIN, 1, 0, 0},
+    [DS_BEGIN_K2]    = {READ_BEGIN, 2, 0, 0},
+    [DS_BEGIN_K3]    = {READ_BEGIN, 3, 0, 0},
+    [DS_BEGIN_K4]    = {READ_BEGIN, 4, 0, 0},
+    [DS_AVAR_WAIT]   = {READ_ASSIGNMENT_VAR, 0, 0, 0},
+    [DS_AVAR_IN]     = {READ_ASSIGNMENT_VAR, 0, 1, 0},
+    [DS_AOP]         = {READ_ASSIGNMENT_OPERATOR, 0, 0, 0},
+    [DS_CONST1_WAIT] = {READ_CONST1, 0, 0, 0},
+    [DS_CONST1_NUM]  = {READ_CONST1, 0, 0, 1},
+    [DS_SEMI1]       = {READ_SEMICOLON1, 0, 0, 0},
+    [DS_END1_K1]     = {READ_END1, 1, 0, 0},
+    [DS_END1_K2]     = {READ_END1, 2, 0, 0},
+    [DS_END1_K3]     = {READ_END1, 3, 0, 0},
+    [DS_ELSE_K0]     = {READ_ELSE, 0, 0, 0},
+    [DS_ELSE_K1]     = {READ_ELSE, 1, 0, 0},
+    [DS_ELSE_K2]     = {READ_ELSE, 2, 0, 0},
+    [DS_ELSE_K3]     = {READ_ELSE, 3, 0, 0},
+    [DS_BEGIN2_K0]   = {READ_BEGIN2, 0, 0, 0},
+    [DS_BEGIN2_K1]   = {READ_BEGIN2, 1, 0, 0},
+    [DS_BEGIN2_K2]   = {READ_BEGIN2, 2, 0, 0},
+    [DS_BEGIN2_K3]   = {READ_BEGIN2, 3, 0, 0},
+    [DS_BEGIN2_K4]   = {READ_BEGIN2, 4, 0, 0},
+    [DS_AVAR2_WAIT]  = {READ_ASSIGNMENT_VAR2, 0, 0, 0},
+    [DS_AVAR2_IN]    = {READ_ASSIGNMENT_VAR2, 0, 1, 0},
+    [DS_AOP2]        = {READ_ASSIGNMENT_OPERATOR2, 0, 0, 0},
+    [DS_CONST2_WAIT] = {READ_CONST2, 0, 0, 0},
+    [DS_CONST2_NUM]  = {READ_CONST2, 0, 0, 1},
+    [DS_SEMI2]       = {READ_SEMICOLON2, 0, 0, 0},
+    [DS_END2_K1]     = {READ_END2, 1, 0, 0},
+    [DS_END2_K2]     = {READ_END2, 2, 0, 0},
+    [DS_EVALUATE]    = {EVALUATE, -1, -1, -1},
+};
+
+// Keyword expected in a parser state, for the word-at-a-time match
+typedef struct
+{
+    char text[SWAR_WIDTH]; // Zero padded, so it doubles as the little-endian word
+    int length;            // Bytes taken by a match
+    bool paren_zero;       // Only valid while paren_count == 0
+    bool word_end;         // The byte after the match must not continue a name
+    int state;             // Parser state and DFA state after the match
+    int ds;
+} SwarKeyword;
+
+// The closing "end" stops before its 'd', process_char and end_at_boundary take it from there
+static const SwarKeyword swar_keywords[READ_COND_NOT + 1] = {
+    [IDLE]             = {"if", 2, false, false, READ_OPEN_PAREN, DS_OPEN_PAREN},
+    [READ_CLOSE_PAREN] = {"begin", 5, true, false, READ_ASSIGNMENT_VAR, DS_AVAR_WAIT},
+    [READ_SEMICOLON1]  = {"end", 3, true, true, READ_ELSE, DS_ELSE_K0},
+    [READ_ELSE]        = {"else", 4, false, false, READ_BEGIN2, DS_BEGIN2_K0},
+    [READ_BEGIN2]      = {"begin", 5, false, false, READ_ASSIGNMENT_VAR2, DS_AVAR2_WAIT},
+    [READ_SEMICOLON2]  = {"en", 2, true, false, READ_END2, DS_END2_K2},
+};
+
+// p has SWAR_WIDTH bytes, so the byte after the keyword can be looked at
+static inline bool swar_keyword_at(const SwarKeyword *kw, const char *p)
+{
+    uint64_t mask = ~0ULL >> (64 - 8 * kw->length);
+
+    return (swar_load(p) & mask) == swar_load(kw->text) && !(kw->word_end && is_id_byte(p[kw->length]));
+}
+
+// Switch engine counterpart of DFA_KEYWORD, returns the bytes taken or 0 to use process_char
+static size_t swar_keyword(Parser *parser, const char *p, const char *end)
+{
+    const SwarKeyword *kw = &swar_keywords[parser->state];
+
+    if (!SWAR_ENABLED || kw->length == 0 || *p != kw->text[0] || end - p < SWAR_WIDTH)
+        return 0;
+    if (parser->keyword_index != 0 || (kw->paren_zero && parser->paren_count != 0))
+        return 0;
+    if (!swar_keyword_at(kw, p))
+        return 0;
+
+    parser->state = kw->state;
+    parser->keyword_index = kw->state == READ_END2 ? 2 : 0;
+    if (kw->state == READ_ASSIGNMENT_VAR2)
+        parser->reading_var = false;
+    return (size_t)kw->length;
+}
+
+static unsigned char char_class[256];
+static DfaEntry dfa_table[DS_NUM][CC_NUM];
+static pthread_once_t dfa_once = PTHREAD_ONCE_INIT;
+
+static void dfa_set(int ds, int cc, int next, int action)
+{
+    dfa_table[ds][cc].next = (unsigned char)next;
+    dfa_table[ds][cc].action = (unsigned char)action;
+}
+
+// Same transition for every identifier character class
+static void dfa_set_id_chars(int ds, int next, int action, bool with_digits)
+{
+    for (int cc = CC_LETTER; cc <= CC_D; cc++)
+    {
+        if (cc != CC_UNDERSCORE || with_digits)
+            dfa_set(ds, cc, next, action);
+    }
+    if (with_digits)
+        dfa_set(ds, CC_DIGIT, next, action);
+}
+
+static void dfa_build(void)
+{
+    const char *keyword_letters = "ifbegnlsd";
+
+    for (int c = 0; c < 256; c++)
+    {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+            char_class[c] = CC_WS;
+        else if (isdigit(c))
+            char_class[c] = CC_DIGIT;
+        else if (c == '_')
+            char_class[c] = CC_UNDERSCORE;
+        else if (isalpha(c))
+            char_class[c] = strchr(keyword_letters, c) ? CC_I + (strchr(keyword_letters, c) - keyword_letters) : CC_LETTER;
+        else
+            char_class[c] = CC_OTHER;
+    }
+
+    for (int ds = 0; ds < DS_NUM; ds++)
+    {
+        for (int cc = 0; cc < CC_NUM; cc++)
+            dfa_set(ds, cc, ds, DFA_FALLBACK);
+    }
+
+    // Whitespace that process_char ignores
+    const int ws_states[] = {DS_IDLE, DS_OPEN_PAREN, DS_VAR_WAIT, DS_COND_OP, DS_COND_OP2, DS_VALC_WAIT,
+                             DS_VALC_NUM, DS_CLOSE_PAREN, DS_AVAR_WAIT, DS_AOP, DS_ELSE_K0, DS_ELSE_K1,
+                             DS_ELSE_K2, DS_ELSE_K3, DS_BEGIN2_K0, DS_BEGIN2_K1, DS_BEGIN2_K2, DS_BEGIN2_K3,
+                             DS_BEGIN2_K4, DS_AVAR2_WAIT, DS_AOP2};
+    for (size_t i = 0; i < sizeof(ws_states) / sizeof(ws_states[0]); i++)
+        dfa_set(ws_states[i], CC_WS, ws_states[i], DFA_SKIP_WS);
+    dfa_set(DS_CONST1_WAIT, CC_WS, DS_CONST1_WAIT, DFA_WS_CONST1);
+    dfa_set(DS_CONST2_WAIT, CC_WS, DS_CONST2_WAIT, DFA_WS_CONST2);
+    dfa_set(DS_SEMI1, CC_WS, DS_SEMI1, DFA_WS_SEMI);
+    dfa_set(DS_SEMI2, CC_WS, DS_SEMI2, DFA_WS_SEMI);
+
+    // "if"
+    dfa_set(DS_IDLE, CC_I, DS_READ_IF, DFA_KEYWORD);
+
+    // Condition variable
+    dfa_set_id_chars(DS_VAR_WAIT, DS_VAR_IN, DFA_NAME_START, false);
+    dfa_set_id_chars(DS_VAR_IN, DS_VAR_IN, DFA_NAME_APPEND, true);
+    dfa_set(DS_VAR_IN, CC_WS, DS_COND_OP, DFA_VAR_END);
+
+    // valC digits
+    dfa_set(DS_VALC_WAIT, CC_DIGIT, DS_VALC_NUM, DFA_DIGIT);
+    dfa_set(DS_VALC_NUM, CC_DIGIT, DS_VALC_NUM, DFA_DIGIT);
+
+    // "begin" of the true branch
+    dfa_set(DS_CLOSE_PAREN, CC_B, DS_BEGIN_K1, DFA_KEYWORD);
+    dfa_set(DS_BEGIN_K1, CC_E, DS_BEGIN_K2, DFA_NONE);
+    dfa_set(DS_BEGIN_K2, CC_G, DS_BEGIN_K3, DFA_NONE);
+    dfa_set(DS_BEGIN_K3, CC_I, DS_BEGIN_K4, DFA_NONE);
+    dfa_set(DS_BEGIN_K4, CC_N, DS_AVAR_WAIT, DFA_NONE);
+
+    // True branch assignment
+    dfa_set_id_chars(DS_AVAR_WAIT, DS_AVAR_IN, DFA_NAME_START, false);
+    dfa_set_id_chars(DS_AVAR_IN, DS_AVAR_IN, DFA_NAME_APPEND, true);
+    dfa_set(DS_AVAR_IN, CC_WS, DS_AOP, DFA_AVAR_END);
+    dfa_set(DS_CONST1_WAIT, CC_DIGIT, DS_CONST1_NUM, DFA_DIGIT);
+    dfa_set(DS_CONST1_NUM, CC_DIGIT, DS_CONST1_NUM, DFA_DIGIT);
+
+    // "end" of the true branch, ended by whitespace, then "else". A name char after the 'd'
+    // makes it an assignment instead
+    dfa_set(DS_SEMI1, CC_E, DS_END1_K1, DFA_KEYWORD);
+    dfa_set(DS_END1_K1, CC_N, DS_END1_K2, DFA_NONE);
+    dfa_set(DS_END1_K2, CC_D, DS_END1_K3, DFA_NONE);
+    dfa_set(DS_END1_K3, CC_WS, DS_ELSE_K0, DFA_SKIP_WS);
+    dfa_set(DS_ELSE_K0, CC_E, DS_ELSE_K1, DFA_KEYWORD);
+    dfa_set(DS_ELSE_K1, CC_L, DS_ELSE_K2, DFA_NONE);
+    dfa_set(DS_ELSE_K2, CC_S, DS_ELSE_K3, DFA_NONE);
+    dfa_set(DS_ELSE_K3, CC_E, DS_BEGIN2_K0, DFA_NONE);
+
+    // "begin" of the false branch, a 'b' restarts the keyword
+    for (int ds = DS_BEGIN2_K0; ds <= DS_BEGIN2_K4; ds++)
+        dfa_set(ds, CC_B, DS_BEGIN2_K1, DFA_KEYWORD);
+    dfa_set(DS_BEGIN2_K1, CC_E, DS_BEGIN2_K2, DFA_NONE);
+    dfa_set(DS_BEGIN2_K2, CC_G, DS_BEGIN2_K3, DFA_NONE);
+    dfa_set(DS_BEGIN2_K3, CC_I, DS_BEGIN2_K4, DFA_NONE);
+    dfa_set(DS_BEGIN2_K4, CC_N, DS_AVAR2_WAIT, DFA_NONE);
+
+    // False branch assignment
+    dfa_set_id_chars(DS_AVAR2_WAIT, DS_AVAR2_IN, DFA_NAME_START, false);
+    dfa_set_id_chars(DS_AVAR2_IN, DS_AVAR2_IN, DFA_NAME_APPEND, true);
+    dfa_set(DS_AVAR2_IN, CC_WS, DS_AOP2, DFA_AVAR2_END);
+    dfa_set(DS_CONST2_WAIT, CC_DIGIT, DS_CONST2_NUM, DFA_DIGIT);
+    dfa_set(DS_CONST2_NUM, CC_DIGIT, DS_CONST2_NUM, DFA_DIGIT);
+
+    // "end" of the false branch, process_char reads the final 'd' and end_at_boundary the
+    // char after it
+    dfa_set(DS_SEMI2, CC_E, DS_END2_K1, DFA_KEYWORD);
+    dfa_set(DS_END2_K1, CC_N, DS_END2_K2, DFA_NONE);
+
+    // Nothing happens once the block is parsed
+    for (int cc = 0; cc < CC_NUM; cc++)
+        dfa_set(DS_EVALUATE, cc, DS_EVALUATE, DFA_NONE);
+}
+
+// Find the DFA state matching the parser's current fields
+static int dfa_state_of(const Parser *parser)
+{
+    for (int ds = DS_SLOW + 1; ds < DS_NUM; ds++)
+    {
+        const DfaStateInfo *info = &dfa_state_info[ds];
+
+        if (info->state == parser->state &&
+            (info->keyword_index < 0 || info->keyword_index == parser->keyword_index) &&
+            (info->reading_var < 0 || info->reading_var == parser->reading_var) &&
+            (info->parsing_number < 0 || info->parsing_number == parser->parsing_number))
+            return ds;
+    }
+
+    return DS_SLOW;
+}
+
+// Write back the parser fields implied by a DFA state
+static void dfa_sync(Parser *parser, int ds)
+{
+    const DfaStateInfo *info = &dfa_state_info[ds];
+
+    if (info->state < 0)
+        return;
+
+    parser->state = info->state;
+    if (info->keyword_index >= 0)
+        parser->keyword_index = info->keyword_index;
+    if (info->reading_var >= 0)
+        parser->reading_var = info->reading_var;
+    if (info->parsing_number >= 0)
+        parser->parsing_number = info->parsing_number;
+}
+
+// Table-driven counterpart of the process_char loop in parse_buffer
+size_t parse_buffer_table(Parser *parser, const char *buf, size_t len)
+{
+    size_t i = 0;
+    int ds;
+
+    pthread_once(&dfa_once, dfa_build);
+    if (parser->parsing_done || parser->error_flag)
+        return 0;
+    ds = dfa_state_of(parser);
+
+    while (i < len)
+    {
+        unsigned char c = (unsigned char)buf[i++];
+        const DfaEntry *entry = &dfa_table[ds][char_class[c]];
+
+        switch (entry->action)
+        {
+        case DFA_NONE:
+            break;
+
+        case DFA_SKIP_WS:
+            i = (size_t)(skip_whitespace(buf + i, buf + len) - buf);
+            break;
+
+        case DFA_NAME_START:
+            parser->name_length = 0;
+            // fall through
+
+        case DFA_NAME_APPEND:
+        {
+            // Copy the whole run of identifier chars at once
+            size_t start = i - 1;
+
+            while (i < len && (unsigned)(char_class[(unsigned char)buf[i]] - CC_DIGIT) <= CC_D - CC_DIGIT)
+                i++;
+            if (!name_reserve(parser, i - start))
+            {
+                i = start;
+                goto failed;
+            }
+            memcpy(parser->name_buffer + parser->name_length, buf + start, i - start);
+            parser->name_length += i - start;
+            break;
+        }
+
+        case DFA_VAR_END:
+            if ((parser->cond_var_id = name_end(parser)) < 0)
+                goto failed;
+            break;
+
+        case DFA_AVAR_END:
+            if (name_is_if(parser))
+                goto fallback;
+            if ((parser->assignment_var_id = name_end(parser)) < 0)
+                goto failed;
+            break;
+
+        case DFA_AVAR2_END:
+            if (name_is_if(parser))
+                goto fallback;
+            if ((parser->assignment_var2_id = name_end(parser)) < 0)
+                goto failed;
+            break;
+
+        case DFA_DIGIT:
+        {
+            int state = dfa_state_info[ds].state;
+            size_t count = swar_accumulate_digits(parser, state, buf + i - 1, buf + len);
+
+            if (count != 0)
+            {
+                i += count - 1;
+                break;
+            }
+            if (parser->num_buffer > (literal_limit(parser, state) - (c - '0')) / 10)
+                goto fallback;
+            parser->num_buffer = (parser->num_buffer * 10) + (c - '0');
+            break;
+        }
+
+        case DFA_WS_CONST1:
+            if (parser->is_const1_negative)
+                goto fallback;
+            i = (size_t)(skip_whitespace(buf + i, buf + len) - buf);
+            break;
+
+        case DFA_WS_CONST2:
+            if (parser->is_const2_negative)
+                goto fallback;
+            i = (size_t)(skip_whitespace(buf + i, buf + len) - buf);
+            break;
+
+        case DFA_WS_SEMI:
+            if (parser->paren_count != 0)
+                goto fallback;
+            i = (size_t)(skip_whitespace(buf + i, buf + len) - buf);
+            break;
+
+        case DFA_KEYWORD:
+        {
+            const SwarKeyword *kw = &swar_keywords[dfa_state_info[ds].state];
+
+            if (kw->paren_zero && parser->paren_count != 0)
+                goto fallback;
+            if (SWAR_ENABLED && len - i + 1 >= SWAR_WIDTH && swar_keyword_at(kw, buf + i - 1))
+            {
+                i += kw->length - 1;
+                ds = kw->ds;
+                continue;
+            }
+            break;
+        }
+
+        default:
+            goto fallback;
+        }
+
+        ds = entry->next;
+        continue;
+
+    fallback:
+        dfa_sync(parser, ds);
+        if (end_at_boundary(parser, (char)c))
+            i--;
+        else
+            process_char(parser, (char)c);
+        if (parser->parsing_done || parser->error_flag)
+            return i;
+        ds = dfa_state_of(parser);
+    }
+
+    // End of the buffer, or OUT_OF_MEMORY flagged while storing an identifier
+failed:
+    dfa_sync(parser, ds);
+    return i;
+}
+
+const char *comparator_str(int comparator)
+{
+    switch (comparator)
+    {
+    case EQ: return "==";
+    case NE: return "!=";
+    case LT: return "<";
+    case GT: return ">";
+    case LE: return "<=";
+    case GE: return ">=";
+    default: return "??";
+    }
+}
+
+const char *error_message(int error_code)
+{
+    switch (error_code)
+    {
+    case INVALID_KEYWORD: return "Invalid keyword encountered";
+    case VAR_MISMATCH: return "Variable names don't match between if and else branches";
+    case INVALID_CHAR: return "Invalid character encountered";
+    case MISSING_SEMICOLON: return "Missing semicolon";
+    case MISSING_OPERATOR: return "Invalid or missing operator";
+    case SYNTAX_ERROR: return "Syntax error";
+    case NUM_OVERFLOW: return "Integer constant out of range";
+    case OUT_OF_MEMORY: return "Out of memory";
+    case COND_TOO_LARGE: return "Condition too large";
+    default: return "Unknown error";
+    }
+}
+
+// Function to evaluate the condition with the given input value
+bool evaluate_condition(const Parser *parser, int input_value) 
+{
+    bool condition_result = false;
+    
+    switch (parser->comparator) {
+        case EQ: condition_result = (input_value == parser->valC); break;
+        case NE: condition_result = (input_value != parser->valC); break;
+        case LT: condition_result = (input_value < parser->valC); break;
+        case GT: condition_result = (input_value > parser->valC); break;
+        case LE: condition_result = (input_value <= parser->valC); break;
+        case GE: condition_result = (input_value >= parser->valC); break;
+        default: condition_result = false; break;
+    }
+    
+    return condition_result;
+}
+
+// Evaluation
+//
+// In batch mode the parsed rule is evaluated against a whole stream of x values.
+// The comparator is turned into a 3-bit mask over the (x < valC, x == valC, x > valC)
+// outcomes once, so the per-value work is a compare-and-select with no branches.
+static const int comparator_mask[6] = {
+    CMP_EQ_BIT,              // EQ
+    CMP_LT_BIT | CMP_GT_BIT, // NE
+    CMP_LT_BIT,              // LT
+    CMP_GT_BIT,              // GT
+    CMP_LT_BIT | CMP_EQ_BIT, // LE
+    CMP_GT_BIT | CMP_EQ_BIT  // GE
+};
+
+// Compound conditions are run by a threaded interpreter: each op's handler ends by jumping
+// straight to the handler of the next op through a table of label addresses (a GNU C
+// extension), so there is no shared dispatch branch and each jump is predicted on its own.
+// The registers are loaded once, values[var_id] for each variable or x for all of them if
+// values is NULL.
+static bool condition_run(const Condition *cond, int x, const int *values)
+{
+    static const void *const dispatch[] = {
+        [EQ] = &&op_eq, [NE] = &&op_ne, [LT] = &&op_lt, [GT] = &&op_gt, [LE] = &&op_le, [GE] = &&op_ge,
+        [COND_TRUE] = &&op_true, [COND_FALSE] = &&op_false
+    };
+    const CondOp *ops = cond->ops;
+    const CondOp *op = ops;
+    const int *vars = (const int *)(ops + cond->op_count);
+    int regs[COND_MAX_REGS];
+
+    for (size_t r = 0; r < cond->reg_count; r++)
+        regs[r] = values != NULL ? values[vars[r]] : x;
+
+#define COND_NEXT(holds)                                \
+    do                                                  \
+    {                                                   \
+        op = (holds) ? ops + op->target : op + 1;       \
+        goto *dispatch[op->op];                         \
+    } while (0)
+
+    goto *dispatch[op->op];
+op_eq:
+    COND_NEXT(regs[op->reg] == op->value);
+op_ne:
+    COND_NEXT(regs[op->reg] != op->value);
+op_lt:
+    COND_NEXT(regs[op->reg] < op->value);
+op_gt:
+    COND_NEXT(regs[op->reg] > op->value);
+op_le:
+    COND_NEXT(regs[op->reg] <= op->value);
+op_ge:
+    COND_NEXT(regs[op->reg] >= op->value);
+op_true:
+    return true;
+op_false:
+    return false;
+#undef COND_NEXT
+}
+
+const int *condition_variables(const Condition *cond)
+{
+    return (const int *)(cond->ops + cond->op_count);
+}
+
+const CondTerm *condition_terms(const Condition *cond)
+{
+    return (const CondTerm *)(condition_variables(cond) + cond->reg_count);
+}
+
+bool condition_evaluate(const Condition *cond, int x)
+{
+    return condition_run(cond, x, NULL);
+}
+
+bool condition_evaluate_vars(const Condition *cond, const int *values)
+{
+    return condition_run(cond, 0, values);
+}
+
+// One pass over the nodes of a nested block, values[var_id] being the value of each condition
+// variable, or x for all of them if values is NULL. An assignment goes to out[slot], or to
+// pairs[slot].value if pairs is set, or with first_only to *out if it is to the first variable.
+// Every jump is forward, so the nodes are read in memory order.
+static inline __attribute__((always_inline)) void ast_walk(const Ast *ast, int x, const int *values, int *out,
+                                                           Assignment *pairs, bool first_only)
+{
+    const AstNode *nodes = ast->nodes;
+    size_t count = ast->node_count;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        const AstNode *node = &nodes[i];
+
+        if (node->kind == AST_ASSIGN)
+        {
+            if (pairs != NULL)
+                pairs[node->slot].value = node->value;
+            else if (!first_only)
+                out[node->slot] = node->value;
+            else if (node->slot == 0)
+                *out = node->value;
+            i = node->jump;
+        }
+        else if (node->comparator == COMPOUND)
+        {
+            i = condition_run(ast_condition(ast, node), x, values) ? i + 1 : node->jump;
+        }
+        else
+        {
+            int v = values != NULL ? values[node->var_id] : x;
+            int outcome = v < node->value ? CMP_LT_BIT : v == node->value ? CMP_EQ_BIT : CMP_GT_BIT;
+
+            i = (comparator_mask[node->comparator] & outcome) != 0 ? i + 1 : node->jump;
+        }
+    }
+}
+
+const int *ast_variables(const Ast *ast)
+{
+    return (const int *)(ast->nodes + ast->node_count);
+}
+
+const Condition *ast_condition(const Ast *ast, const AstNode *node)
+{
+    return (const Condition *)((const unsigned char *)(ast_variables(ast) + ast->var_count) + node->value);
+}
+
+void ast_evaluate(const Ast *ast, int x, int *out)
+{
+    ast_walk(ast, x, NULL, out, NULL, false);
+}
+
+void ast_evaluate_vars(const Ast *ast, const int *values, int *out)
+{
+    ast_walk(ast, 0, values, out, NULL, false);
+}
+
+// Evaluate n values of x and store the assigned value for each one in out[]
+void evaluate_batch(const BlockResult *block, const int *xs, int *out, size_t n)
+{
+    if (block->ast != NULL)
+    {
+        for (size_t i = 0; i < n; i++)
+            ast_walk(block->ast, xs[i], NULL, &out[i], NULL, true);
+        return;
+    }
+
+    if (block->ladder != NULL)
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = ladder_evaluate(block->ladder, xs[i]);
+        return;
+    }
+
+    int mask = (block->comparator >= 0 && block->comparator < 6) ? comparator_mask[block->comparator] : 0;
+    int valC = block->valC;
+    int const2 = block->const2;
+    int diff = block->const1 ^ block->const2;
+
+    // All-ones / all-zeros selectors for the three outcomes
+    int sel_lt = -((mask & CMP_LT_BIT) != 0);
+    int sel_eq = -((mask & CMP_EQ_BIT) != 0);
+    int sel_gt = -((mask & CMP_GT_BIT) != 0);
+    size_t i = 0;
+
+#ifdef __SSE2__
+    __m128i v_valC = _mm_set1_epi32(valC);
+    __m128i v_const2 = _mm_set1_epi32(const2);
+    __m128i v_diff = _mm_set1_epi32(diff);
+    __m128i v_sel_lt = _mm_set1_epi32(sel_lt);
+    __m128i v_sel_eq = _mm_set1_epi32(sel_eq);
+    __m128i v_sel_gt = _mm_set1_epi32(sel_gt);
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i v_x = _mm_loadu_si128((const __m128i *)(xs + i));
+        __m128i lt = _mm_and_si128(_mm_cmplt_epi32(v_x, v_valC), v_sel_lt);
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi32(v_x, v_valC), v_sel_eq);
+        __m128i gt = _mm_and_si128(_mm_cmpgt_epi32(v_x, v_valC), v_sel_gt);
+        __m128i cond = _mm_or_si128(_mm_or_si128(lt, eq), gt);
+        __m128i p = _mm_xor_si128(v_const2, _mm_and_si128(cond, v_diff));
+        _mm_storeu_si128((__m128i *)(out + i), p);
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        int x = xs[i];
+        int cond = (-(x < valC) & sel_lt) | (-(x == valC) & sel_eq) | (-(x > valC) & sel_gt);
+        out[i] = const2 ^ (cond & diff);
+    }
+}
+
+// Assigned value for a single x
+int evaluate_block(const BlockResult *block, int x)
+{
+    int out;
+
+    evaluate_batch(block, &x, &out, 1);
+    return out;
+}
+
+const int *ladder_thresholds(const Ladder *ladder)
+{
+    return (const int *)(ladder->arms + ladder->arm_count);
+}
+
+const int *ladder_branches(const Ladder *ladder)
+{
+    return ladder_thresholds(ladder) + ladder->threshold_count;
+}
+
+static bool arm_holds(const LadderArm *arm, int x)
+{
+    int outcome = x < arm->valC ? CMP_LT_BIT : x == arm->valC ? CMP_EQ_BIT : CMP_GT_BIT;
+
+    return arm->comparator >= 0 && arm->comparator < 6 && (comparator_mask[arm->comparator] & outcome) != 0;
+}
+
+// Branch of a ladder taken for x, arm_count for the final else. The search keeps the
+// interval holding x in the count entries from base, halving count with a select rather
+// than a branch, so the loop runs log2(threshold_count) times whatever x is.
+size_t ladder_branch(const Ladder *ladder, int x)
+{
+    if (ladder->threshold_count == 0)
+    {
+        size_t a = 0;
+
+        while (a < ladder->arm_count && !arm_holds(&ladder->arms[a], x))
+            a++;
+        return a;
+    }
+
+    const int *thresholds = ladder_thresholds(ladder);
+    const int *base = thresholds;
+    size_t count = ladder->threshold_count;
+
+    while (count > 1)
+    {
+        size_t half = count / 2;
+        base = base[half] <= x ? base + half : base;
+        count -= half;
+    }
+    return (size_t)ladder_branches(ladder)[base - thresholds];
+}
+
+size_t ladder_branch_arms(const Ladder *ladder, const int *values)
+{
+    size_t a = 0;
+
+    while (a < ladder->arm_count && !arm_holds(&ladder->arms[a], values[a]))
+        a++;
+    return a;
+}
+
+int ladder_evaluate(const Ladder *ladder, int x)
+{
+    size_t branch = ladder_branch(ladder, x);
+
+    return branch < ladder->arm_count ? ladder->arms[branch].value : ladder->default_value;
+}
+
+int ladder_evaluate_arms(const Ladder *ladder, const int *values)
+{
+    size_t branch = ladder_branch_arms(ladder, values);
+
+    return branch < ladder->arm_count ? ladder->arms[branch].value : ladder->default_value;
+}
+
+// Assignment vectors
+//
+// A block that assigns one variable has no BranchAssignments; its single pair is built
+// from the flat fields, so callers can treat every block alike.
+size_t block_assignment_count(const BlockResult *block)
+{
+    if (block->ast != NULL)
+        return block->ast->var_count;
+    return block->branches != NULL ? block->branches->count : 1;
+}
+
+// Branch taken for x: an arm of a ladder, or 0 (true) / 1 (else) for a plain if-else
+size_t block_branch(const BlockResult *block, int x)
+{
+    if (block->ladder != NULL)
+        return ladder_branch(block->ladder, x);
+
+    int mask = (block->comparator >= 0 && block->comparator < 6) ? comparator_mask[block->comparator] : 0;
+    int outcome = x < block->valC ? CMP_LT_BIT : x == block->valC ? CMP_EQ_BIT : CMP_GT_BIT;
+    return (mask & outcome) == 0;
+}
+
+// Copy the pairs of a branch to out (block_assignment_count entries), returns the count
+size_t branch_assignments(const BlockResult *block, size_t branch, Assignment *out)
+{
+    if (block->branches != NULL)
+    {
+        size_t count = block->branches->count;
+
+        memcpy(out, block->branches->pairs + branch * count, count * sizeof(Assignment));
+        return count;
+    }
+
+    size_t last = block->ladder != NULL ? block->ladder->arm_count : 1;
+    out[0].var_id = block->assignment_var_id;
+    if (block->ladder != NULL && branch < last)
+        out[0].value = block->ladder->arms[branch].value;
+    else if (block->ladder != NULL)
+        out[0].value = block->ladder->default_value;
+    else
+        out[0].value = branch == 0 ? block->const1 : block->const2;
+    return 1;
+}
+
+// Every assignment the block makes for x
+size_t evaluate_assignments(const BlockResult *block, int x, Assignment *out)
+{
+    if (block->ast != NULL)
+    {
+        const int *vars = ast_variables(block->ast);
+
+        for (size_t i = 0; i < block->ast->var_count; i++)
+            out[i].var_id = vars[i];
+        ast_walk(block->ast, x, NULL, NULL, out, false);
+        return block->ast->var_count;
+    }
+    return branch_assignments(block, block_branch(block, x), out);
+}
+
+
+// Parsing
+
+// process_char loop with the whitespace, digit and keyword fast paths
+static size_t parse_buffer_switch(Parser *parser, const char *buf, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && !parser->parsing_done && !parser->error_flag)
+    {
+        size_t taken = 0;
+
+        if (!parser->debug_mode)
+        {
+            if (is_ws_char(buf[i]) && whitespace_is_noop(parser))
+            {
+                i = (size_t)(skip_whitespace(buf + i, buf + len) - buf);
+                continue;
+            }
+
+            // Digits always accumulate in these states
+            if ((parser->state == READ_VALC || parser->state == READ_CONST1 || parser->state == READ_CONST2) &&
+                isdigit((unsigned char)buf[i]))
+            {
+                taken = swar_accumulate_digits(parser, parser->state, buf + i, buf + len);
+                if (taken != 0)
+                    parser->parsing_number = true;
+            }
+            else
+            {
+                taken = swar_keyword(parser, buf + i, buf + len);
+            }
+        }
+
+        if (taken != 0)
+        {
+            i += taken;
+            continue;
+        }
+        if (end_at_boundary(parser, buf[i]))
+            continue;
+        process_char(parser, buf[i++]);
+    }
+
+    return i;
+}
+
+// Feed len bytes to the parser, stopping early once a block is complete or an error is
+// flagged. Returns the number of bytes consumed. Both engines stop right after the byte that
+// raised an error, so the error offset is the last byte consumed.
+size_t parse_buffer(Parser *parser, const char *buf, size_t len)
+{
+    size_t used = 0;
+    CacheKey key = {0};
+    bool failed = parser->error_flag;
+
+    // A block that starts here may have been parsed by an earlier run
+    if (parser->cache != NULL && !parser->debug_mode && parser->state == IDLE && !parser->error_flag &&
+        parser->offset == parser->block_start && block_cache_key(buf, len, &key))
+        used = block_cache_lookup(parser->cache, &key, parser);
+
+    if (used == 0)
+    {
+        if (parser->engine == ENGINE_TABLE && !parser->debug_mode)
+            used = parse_buffer_table(parser, buf, len);
+        else
+            used = parse_buffer_switch(parser, buf, len);
+
+        if (key.len > 0 && (parser->parsing_done || parser->error_flag))
+            block_cache_store(parser->cache, &key, used, parser);
+    }
+
+    // An "end" closed by the first byte of buf fails at its 'd', the last byte consumed
+    if (parser->error_flag && !failed)
+        parser->error_offset = parser->offset + used - 1;
+    parser->offset += used;
+    return used;
+}
+
+// The end of the input closes an "end" that parse_buffer is still holding open
+void parse_buffer_end(Parser *parser)
+{
+    if (parser->parsing_done || parser->error_flag || !end_at_boundary(parser, ' '))
+        return;
+    if (parser->error_flag)
+        parser->error_offset = parser->offset - 1;
+}
+
+// Chunk-fed API
+
+// Copy the parser's current block into a BlockResult
+void parser_block_result(const Parser *parser, BlockResult *block)
+{
+    block->index = parser->next_block_index;
+    block->parsing_done = parser->parsing_done;
+    block->error_flag = parser->error_flag;
+    block->error_code = parser->error_code;
+    block->error_offset = parser->error_offset;
+    block->start_offset = parser->block_start;
+    block->end_offset = parser->offset;
+
+    block->cond_var_id = parser->cond_var_id;
+    block->comparator = parser->comparator;
+    block->valC = parser->valC;
+    block->assignment_var_id = parser->assignment_var_id;
+    block->assignment_var = symbol_name(parser->symbols, parser->assignment_var_id);
+    block->const1 = parser->const1;
+    block->const2 = parser->const2;
+    block->ladder = parser->ladder;
+    block->branches = parser->branches;
+    block->ast = parser->ast;
+    block->symbols = parser->symbols;
+
+    // Several variables: the flat fields describe the first one
+    if (parser->branches != NULL)
+    {
+        const BranchAssignments *branches = parser->branches;
+
+        block->assignment_var_id = branches->pairs[0].var_id;
+        block->assignment_var = symbol_name(parser->symbols, block->assignment_var_id);
+        block->const1 = branches->pairs[0].value;
+        block->const2 = branches->pairs[(branches->branch_count - 1) * branches->count].value;
+    }
+
+    // A ladder is described by its first arm
+    if (parser->ladder != NULL)
+    {
+        block->cond_var_id = parser->ladder->arms[0].cond_var_id;
+        block->comparator = parser->ladder->arms[0].comparator;
+        block->valC = parser->ladder->arms[0].valC;
+        block->const1 = parser->ladder->arms[0].value;
+    }
+
+    // Nested statements: the outermost condition and the first variable
+    if (parser->ast != NULL)
+    {
+        const AstNode *root = &parser->ast->nodes[0];
+
+        block->cond_var_id = root->var_id;
+        block->comparator = root->comparator;
+        block->valC = root->comparator == COMPOUND ? 0 : root->value;
+        block->assignment_var_id = ast_variables(parser->ast)[0];
+        block->assignment_var = symbol_name(parser->symbols, block->assignment_var_id);
+        block->const1 = 0;
+        block->const2 = 0;
+    }
+    block->cond_var = symbol_name(parser->symbols, block->cond_var_id);
+}
+
+// Queue the current block, returns false if the queue could not grow
+static bool push_block(Parser *parser)
+{
+    if (parser->block_count == parser->block_capacity)
+    {
+        size_t capacity = parser->block_capacity ? parser->block_capacity * 2 : 16;
+        BlockResult *blocks = malloc(capacity * sizeof(BlockResult));
+
+        if (blocks == NULL)
+            return false;
+
+        // Unwrap the ring into the new array
+        for (size_t i = 0; i < parser->block_count; i++)
+            blocks[i] = parser->blocks[(parser->block_head + i) % parser->block_capacity];
+
+        free(parser->blocks);
+        parser->blocks = blocks;
+        parser->block_head = 0;
+        parser->block_capacity = capacity;
+    }
+
+    parser_block_result(parser, &parser->blocks[(parser->block_head + parser->block_count) % parser->block_capacity]);
+    parser->block_count++;
+    parser->next_block_index++;
+    return true;
+}
+
+// Recovery: skip to the next "if" whose 'i' does not continue an identifier and whose 'f' is
+// followed by a non-identifier byte. Returns the bytes skipped. When an "if" is found,
+// resyncing is cleared and buf + the return value is its 'i'. An "if" cut by the end of the
+// buffer is held back in resync_held until the next buffer shows how it goes on; one that
+// the next buffer confirms is fed to the parser before anything else.
+static size_t resync(Parser *parser, const char *buf, size_t len)
+{
+    size_t i = 0;
+
+    if (len == 0)
+        return 0;
+
+    if (parser->resync_held == 1 && buf[0] == 'f' && len == 1)
+    {
+        parser->resync_held = 2;
+        parser->offset++;
+        return 1;
+    }
+    if (parser->resync_held > 0)
+    {
+        int held = parser->resync_held;
+        size_t next = held == 1 ? 1 : 0; // The byte after the 'f'
+
+        parser->resync_held = 0;
+        if ((held == 2 || buf[0] == 'f') && !is_id_byte(buf[next]))
+        {
+            parser->resyncing = false;
+            parser->block_start = parser->offset - held;
+            process_char(parser, 'i');
+            if (held == 2)
+                process_char(parser, 'f');
+            return 0;
+        }
+        parser->resync_prev = held == 2 ? 'f' : 'i';
+    }
+
+    while (i < len)
+    {
+        const char *hit = memchr(buf + i, 'i', len - i);
+        size_t k;
+
+        if (hit == NULL)
+            break;
+        k = (size_t)(hit - buf);
+        if (!is_id_byte(k > 0 ? buf[k - 1] : parser->resync_prev))
+        {
+            if (k + 1 == len || (k + 2 == len && buf[k + 1] == 'f'))
+            {
+                parser->resync_held = (int)(len - k);
+                parser->offset += len;
+                return len;
+            }
+            if (buf[k + 1] == 'f' && !is_id_byte(buf[k + 2]))
+            {
+                parser->resyncing = false;
+                parser->offset += k;
+                parser->block_start = parser->offset;
+                return k;
+            }
+        }
+        i = k + 1;
+    }
+
+    parser->resync_prev = buf[len - 1];
+    parser->offset += len;
+    return len;
+}
+
+size_t parser_feed(Parser *parser, const char *buf, size_t len)
+{
+    size_t i = 0;
+
+    for (;;)
+    {
+        // A finished block stays in the parser until it has been queued
+        if (parser->parsing_done)
+        {
+            if (!push_block(parser))
+                return i;
+            parser_reset_block(parser);
+            parser->block_start = parser->offset;
+        }
+        if (parser->resyncing)
+            i += resync(parser, buf + i, len - i);
+        if (parser->error_flag || parser->resyncing || i == len)
+            break;
+
+        i += parse_buffer(parser, buf + i, len - i);
+
+        if (parser->error_flag && !push_block(parser))
+            return i;
+        if (parser->error_flag)
+        {
+            if (!parser->recover || parser->error_code == OUT_OF_MEMORY)
+                break;
+
+            // Look for the next block from the byte that raised the error on, it may be the
+            // 'i' of an "if" that a broken block ran into
+            size_t at = parser->error_offset - (parser->offset - i);
+
+            parser_reset_block(parser);
+            parser->resyncing = true;
+            parser->resync_prev = at > 0 ? buf[at - 1] : ' ';
+            parser->offset -= i - at;
+            i = at;
+        }
+    }
+
+    return i;
+}
+
+void parser_finish(Parser *parser)
+{
+    bool failed = parser->error_flag;
+
+    // An "if" at the very end of the input starts a block that is cut off by it
+    if (parser->resyncing && parser->resync_held == 2)
+    {
+        parser->resyncing = false;
+        parser->resync_held = 0;
+        parser->block_start = parser->offset - 2;
+        process_char(parser, 'i');
+        process_char(parser, 'f');
+    }
+
+    // The input may end right after the final "end" of a block
+    if (!parser->resyncing)
+        parse_buffer_end(parser);
+    if (parser->parsing_done || parser->error_flag != failed)
+    {
+        if (push_block(parser))
+            parser_reset_block(parser);
+    }
+    else if (!parser->error_flag && parser->state != IDLE)
+    {
+        // Block cut off by the end of the input
+        if (push_block(parser))
+            parser_reset_block(parser);
+    }
+}
+
+// Diagnostics
+
+void line_cursor_init(LineCursor *cursor)
+{
+    cursor->offset = 0;
+    cursor->line = 1;
+    cursor->line_start = 0;
+}
+
+void line_cursor_advance(LineCursor *cursor, const char *data, size_t data_offset, size_t len, size_t offset)
+{
+    size_t from = cursor->offset > data_offset ? cursor->offset : data_offset;
+    size_t to = offset < data_offset + len ? offset : data_offset + len;
+    const char *p = data + (from - data_offset);
+    const char *end = data + (to - data_offset);
+    const char *newline;
+
+    if (from >= to)
+        return;
+
+    while ((newline = memchr(p, '\n', (size_t)(end - p))) != NULL)
+    {
+        cursor->line++;
+        cursor->line_start = data_offset + (size_t)(newline - data) + 1;
+        p = newline + 1;
+    }
+    cursor->offset = to;
+}
+
+size_t line_cursor_column(const LineCursor *cursor, size_t offset)
+{
+    return offset - cursor->line_start + 1;
+}
+
+bool parser_poll(Parser *parser, BlockResult *block)
+{
+    if (parser->block_count == 0)
+        return false;
+
+    *block = parser->blocks[parser->block_head];
+    parser->block_head = (parser->block_head + 1) % parser->block_capacity;
+    parser->block_count--;
+    return true;
+}
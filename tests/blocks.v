@@ -0,0 +1,1607 @@
+if (x > 1 && y < 2) begin a <= 1; end else begin a <= 2; end
+if (!(a == 1 || b > 5) && c != 0) begin r <= 1; end else begin r <= 0; end
+if (x > 1 & y > 2) begin a <= 1; end else begin a <= 2; end
+if (!x > 1) begin a <= 1; end else begin a <= 2; end
+if (x > 1 &&) begin a <= 1; end else begin a <= 2; end
+if ((x ) > 1 && y < 2) begin a <= 1; end else begin a <= 2; end
+if (x > 1) && (y > 2) begin a <= 1; end else begin a <= 2; end
+if (x > (5) && y < 2) begin a <= 1; end else begin a <= 2; end
+if (!(x ) > 1) begin a <= 1; end else begin a <= 2; end
+if (((x > 1)) || ((y < 2))) begin a <= 1; end else begin a <= 2; end
+if (x > 1 || y < 2)) begin a <= 1; end else begin a <= 2; end
+if ((x > 1 && y < 2) begin a <= 1; end else begin a <= 2; end
+if (! ! (x == 1)) begin a <= 1; end else begin a <= 2; end
+if (x == 1 |& y == 2) begin a <= 1; end else begin a <= 2; end
+if (x == 1 && y == 2 || z == 3 && !(w == 4)) begin a <= 1; end else begin a <= 2; end
+if (x > 1) begin a <= 1; end_flag <= 2; end else begin end_flag <= 3; a <= 4; end
+if (x > 1) begin a <= 1; endx <= 2; end else begin a <= 3; endx <= 4; end
+if (x > 1) begin a <= 1; en <= 2; end else begin a <= 3; en <= 4; end
+if (x > 1) begin a <= 1; e <= 2; end else begin e <= 3; a <= 4; end
+if (x > 1) begin a <= 1; end0 <= 2; end else begin a <= 3; end0 <= 4; end
+if (x > 1) begin a <= 1; end else begin a <= 3; end
+if (x > 1) begin a <= 1; end else begin a <= 3; endif (y == 2) begin b <= 1; end else begin b <= 2; end
+if (x > 1) begin a <= 1; end else begin b <= 3; end
+if (x > 1) begin if (y < 2) begin a <= 1; end_q <= 5; end else begin a <= 2; end_q <= 6; end end_r <= 7; end else begin a <= 3; end_q <= 1; end_r <= 2; end
+if (x > 1) begin a <= 1; end	else begin a <= 3; end;
+if (x > 1) begin a <= 1; end else begin a <= 3; end
+if (x >= -2147483648) begin a <= -2147483648; end else begin a <= 2147483647; end
+if (x == -2147483648) begin a <= 1; end else begin a <= -2147483648; end
+if (x > -2147483648 && y <= -2147483648) begin a <= 1; end else begin a <= 2; end
+if (x == 2147483647) begin a <= 1; end else begin a <= 2; end
+if (x == -2147483649) begin a <= 1; end else begin a <= 2; end
+if (x == 2147483648) begin a <= 1; end else begin a <= 2; end
+if (x == 1) begin a <= -2147483649; end else begin a <= 2; end
+if (x == 1) begin a <= 1; end else begin a <= 2147483648; end
+if (x == 1) begin a <= 1; end else begin a <= -21474836480; end
+if (x <= -000002147483648) begin a <= 1; end else begin a <= 2; end
+if (x==-2147483648)begin a<=-2147483648;end else begin a<=-2147483648;end
+if (v < 0) begin a <= 1; end else if (w == 5) begin a <= 2; end else begin a <= 3; end
+if (v < 0) begin a <= 1; end else if (v == 5) begin b <= 2; end else begin a <= 3; end
+if (v < 0) begin a <= 1; end else if (v == 5) begin a <= 2; end else begin b <= 3; end
+if (v < 0) begin a <= 1; end elseif(v>4) begin a <= 2; end else begin a <= 3; end
+if (v < 0) begin a <= 1; end else if (v == 5) begin a <= 2; end else if (v > 1) begin a<=9; end
+if (x < 3) begin a = 1; b <= 2; end else begin b = 4; a = 3; end
+if (x == 5) begin enable = 1; end else begin enable = 0; end
+if (x > 1) begin a = 1; en = 2; e = 3; end else if (x > 5) begin e = 7; en = 8; a = 9; end else begin a = 0; e = 0; en = 0; end
+if (x > 1) begin a = 1; b = 2; end else begin a = 3; end
+if (x > 1) begin a = 1; end else begin a = 3; c = 4; end
+if (x > 1) begin a = 1; a = 5; end else begin a = 3; end
+junk
+  if (a == 1)
+ begin
+ b = 2;
+ end
+ else begin b = 3; end
+ tail end
+if (x > 1) begin a <= 1; end elxe begin a <= 2; end
+ifx <= 3; iffy if_a ifif (x == 2) begin b <= 1; end else begin b <= 2; end
+if (x > 1) begin a <= ; end else begin a <= 2; end if(x<2) begin a <= 1; end else begin a <= 2; end
+if(x < 17) begin
+  if(x <=-13) 
+begin
+  a 
+<= 49; enda <=	1; enda <= -89; 
+end	else
+  begin a
+  <=	-64; enda
+  <= 43; 
+end 
+a
+  <=	63; 
+if
+((x ) != -5 ||
+  y <=11	||
+  (( x	== 12 ) ||	!((x )	> 6)) || (t ) 
+== 15) begin 
+endc	<=
+  -20; end 
+else if
+(!((!(x >=
+-1) ||	((y ) >= 2 || 
+y<
+10)) &&
+  (y!=
+-5	|| 
+y ==
+-10))) begin 
+endc <= 40; end	else if
+(!(x	!= -6 
+&&	(t ) != -4 
+||	x	> 14 
+|| 
+t	< 12))	begin 
+endc 
+<=
+  31; 
+end else	begin endc <=	89;	endc	<=
+  1; end end	else begin a <= -85;
+  enda
+  <= 12;
+  if(y <=-19)	begin	enda <= -62; a	<= 
+54; endc	<=
+  24;	end else
+  begin
+  endc
+  <= -79; a
+  <= 
+-13; a	<=	22; enda <=	-95;
+  end 
+end
+if
+(! (x >=-15) && 
+((x	> 20) 
+&& 
+t > 3
+  && (!(x !=
+-4)	&& x<
+20))) begin 
+endc
+  <=
+  -55; en
+  <= 
+-36; endc 
+<= 87; k <=	-52; if ((y<=-1))	begin
+  ende
+  <=	-42;	end	else if (( t	>= 20 )) begin
+  ende <= 
+-12;	end
+  else if((
+(x ) == 20))
+  begin
+  ende 
+<= 
+-35;
+  end else
+  begin ende	<=	70; end endend <= -28;	end	else	begin
+  if(y!=2) begin
+  ende	<= -3;
+  ende <= 28;
+  en
+  <=
+  -37;
+  end else if((x )	!= 5) begin
+  ende <=
+  -24; en <= 49;
+  end	else if
+(x>= 18)	begin en 
+<= 
+84;	ende <= 85; end	else	begin 
+ende
+  <=	83; en <= 
+87; end k <=	92; ende	<=
+  -96; endc
+  <=
+  82; endend
+  <=
+  -42; endc	<= -66;
+  end
+if ((
+x==
+6)) begin n <= -8;	n
+  <=
+  35;	en	<=
+  -45;	endc <= -2;	r <=
+  14;	if ((y )	!= -14)	begin endc
+  <=	74; 
+endend <= 79; 
+endend
+  <= 
+95; 
+end0	<= 98; 
+end0 <=	-41; 
+end 
+else if
+(x	>=-1) 
+begin endend <=	11; endc	<=
+  -82; end0
+  <= -51;	end else if(!(( x<=-5 ) 
+&& y	>=-1 || x> 6) 
+&&
+  x >=
+7) begin
+  endend
+  <=	78; 
+end0	<= 74; 
+endc <=	-26; 
+end else 
+begin
+  endc
+  <=
+  -49; end0	<=	-41; endend <= -25; endend <=	26;	end	e
+  <= 
+24;	end_b
+  <= 52;	a <=
+  -87;	if
+(t>=
+9)	begin	en <= -16; r <= -80; endc	<= 
+-69; end_b <= -3; ende
+  <=	10; endc	<=
+  -50; 
+end else	begin
+  en
+  <=	21; endc
+  <=	-37; r <=	96; ende <=
+  18; ende
+  <= -35; endc
+  <=
+  -84; end_b	<=	-31;	end	if
+(( x	== -1
+  &&	x <= -5 || 
+y> 3 )
+  || 
+!(( x	!= 6 ))
+  && (
+x >
+15) 
+||
+  !(( y==
+-16 ))) begin 
+endend
+  <=	7; endc <= 14; en	<=	17; 
+end else	begin	en	<= 98; endc	<= -25; endend 
+<= 
+-5; end	endend <=
+  -53;	if(! ((
+x	<=17	&& (
+x <
+12))
+  && (t	==-14 || t	<=2)
+  ||
+  y< 11)) begin
+  endc
+  <=	87;
+  end_b	<=
+  -98;
+  ende 
+<=
+  -5;
+  a 
+<=
+  -48;
+  ende <=	40; end
+  else begin
+  endc <= 
+1;
+  end_b <= 36;
+  end_b	<= 
+1;
+  a	<= 
+4;
+  ende 
+<= 6;	end
+  end else begin if(t	< 12 
+||	y	< 10) begin endend	<= 92; ende <= -50; n <=	-89; end0 <= -87;
+  end else if(x	>=
+19)	begin endend <=	57;
+  n 
+<= 
+-54;
+  ende <=	32;
+  end0 
+<= 
+-62; end else if(x	==
+15) begin	endend 
+<= 53; 
+end0	<=	99; 
+ende 
+<= 49; 
+n <=	-6; end else begin	end0 <= 25; ende <= 58; n <= -55; endend	<= -83; endend
+  <= 
+-7; end ende	<= 29; en <=
+  -90; end_b <= -79; ende
+  <= 
+-20; r	<=	-87; end_b
+  <= 67; if
+(( (t ) 
+!= -16 ))
+  begin 
+end0	<= 
+-36; e <=
+  -30;
+  end 
+else	begin	end0 <= 28; e
+  <= 51;	end if(( t>=5 
+&&
+  ((y ) 
+<= -11 
+|| x >
+6)	||	t	== -2 ))
+  begin	endc 
+<= 91; end0
+  <= -26; end0 
+<= 10; end_b
+  <= 
+-88; end0	<=
+  56; endend 
+<= -95; ende 
+<= 
+-10; r	<=	33; ende <= 49;
+  end 
+else if (y	!=-12)
+  begin 
+r	<=	-63; endend 
+<= 2; end_b 
+<=
+  -86; ende <= -11; end0	<= 
+54; endc 
+<=
+  -37; 
+end
+  else if((x	> 9))
+  begin
+  ende 
+<=
+  68; 
+r	<= 
+-49; 
+end_b <= 65; 
+endc <=	-56; 
+endend
+  <= 60; 
+endend
+  <=	100; 
+end0 <= 37; 
+end_b
+  <= 
+90; end
+  else
+  begin 
+end0 <= -34; 
+r <= -15; 
+ende 
+<=	-33; 
+endend 
+<= 
+41; 
+endc <=
+  33; 
+end_b
+  <=	-45; 
+ende <=	-97; 
+end a 
+<= 90; if((((y <=17) || x !=
+-18)	&& (x	<=
+-10) 
+|| x	>= -19)	&& x>= 20) begin r
+  <= -84;
+  en 
+<= -49;
+  end_b <=
+  70;
+  en 
+<=	-73;
+  e <= -48;
+  e <=
+  92; end else if
+(t	>=-2) begin	r
+  <=
+  93;
+  end_b	<= -14;
+  e
+  <=	-35;
+  en	<= 94;	end else if ((
+!((y> 17)) && 
+! (x	<= -2)	&& x	<= -8	|| x	==2))	begin 
+end_b	<= -53; r
+  <=	31; e	<= -28; en <= -41;
+  end 
+else
+  begin
+  r
+  <=	78; en <=
+  -17; end_b	<=	1; e <= 8; 
+end endc <= -23; if
+(x>
+15)
+  begin	endend <= 12;
+  end_b <=	-41;
+  end_b
+  <=	64;
+  en <= -40;
+  end else begin	endend
+  <= 
+58; 
+en <=	-37; 
+end_b <= 
+-11;
+  end end
+if ((
+t >
+17)) begin	endc <=
+  22; ende <= -32; if
+((y	>= 4))	begin end_b <= 
+26; 
+ende <=
+  37; 
+end0 <=
+  -78; 
+end0
+  <= -54; 
+e
+  <= 42; end
+  else 
+begin 
+end0	<= 89;
+  end_b 
+<=
+  53;
+  ende <=
+  -39;
+  e 
+<=
+  -76; 
+end e <= 19; end_b <=
+  28; if(t <=
+13) 
+begin	r <=	-15; n <= 44; e
+  <= 2; ende <= 
+32; ende
+  <=	-10; endend <= 
+8; k
+  <= 
+-73;
+  end	else if (!(! (x >
+5))) begin n 
+<= 
+59; e	<=	-91; ende <=	33; e	<= -90; r 
+<= 
+-22; k <=
+  -85; endend
+  <= 
+31; end
+  else begin 
+n <= -25; 
+ende <=
+  -30; 
+r	<=
+  39; 
+e 
+<=	77; 
+endend	<=
+  -49; 
+k
+  <= 40;
+  end end0 
+<=	-93; if((!(y > 2) || (!(t>=-11)
+  &&
+  !(x	>= -8)))	&& 
+((t	>= 20 || x	> 14)
+  && 
+t	<= -13 ||
+  ! (y<=
+18 &&
+  y >= 9)))	begin 
+ende <= 
+52;
+  n <= 90;
+  e
+  <=
+  13;
+  en
+  <= 
+-63;
+  a 
+<=
+  -41;
+  end0 <= -18;
+  end0 
+<= 55; 
+end else
+  begin 
+en	<=
+  44;
+  a	<= 37;
+  ende	<=
+  11;
+  n <=
+  75;
+  e
+  <= 
+-90;
+  end0 <= -98;
+  end if (t	== -10) begin 
+en 
+<= -81;
+  k <= -72; end else 
+begin en <= 
+30; k
+  <= -60; end if ((( ( t<=
+-3 ) && ( t<=-11 )
+  && ((
+x !=13)
+  ||	x	==-14) ) 
+||
+  t >
+9)
+  && (((x < 3)
+  ||
+  y>=-14) 
+&& (y	<=
+4 
+&&
+  x	>
+17))) 
+begin	endend
+  <=
+  -37; 
+ende 
+<= 
+50; 
+endc
+  <= 16; 
+n
+  <= 26; 
+end	else begin
+  endend <=	49; endc <= 82; ende 
+<= -38; endc <= -9; n 
+<= 
+-99; end a 
+<= -71; endend
+  <= 
+-15; if(x	< 14) begin 
+en
+  <= -4; r	<=	-24; n <=
+  -42; ende	<=	80; endend <=
+  12; k <= -37; end0 <= -68; end_b	<=
+  31; n <= 88; endc 
+<=	-2; endc	<=	-21; end else
+  begin endc	<= -73;
+  endend <=
+  28;
+  end_b <=
+  -51;
+  n	<=
+  -78;
+  end0
+  <=	-68;
+  n <= 
+-9;
+  k <=	98;
+  ende
+  <= -67;
+  endend
+  <=
+  -7;
+  en <=
+  -11;
+  r <=	80; end end
+  else 
+begin 
+end0 <= 
+55;	if (((t )	< 20))
+  begin k <= 74; ende <=
+  -19; endc <= 
+-12; end0
+  <= 77; ende <=	57; e	<= -77; endend	<=
+  13; a	<=
+  89; end 
+else if ((t ) 
+> 12) 
+begin	end0 <= -52; endend
+  <= 43; ende <= 39; e	<= -40; endc 
+<=	-85; k <= -77; endend <= 
+-66; a <= 
+23; 
+end else 
+begin
+  e <=
+  -66;	ende <= 44;	endend <=
+  -70;	endc <= -57;	end0
+  <=
+  18;	a <= -48;	e <= 
+-97;	k <=	-48;	e 
+<=
+  -23;
+  end	n <=
+  14;	if
+(!(x	>=-2	||
+  (x!=-19 ||	y!=-2)) || 
+t	<=-10) begin ende 
+<= -17; endc <=	-9; n 
+<=
+  41; r	<= 
+-36;
+  end	else if
+(!(! (y	<=
+17)) 
+&& 
+(t> 15	&&
+  y	> 8
+  && y	==
+-18)
+  ||	(x	>=-17 || !(! (y	== -9)))) begin r <= 44;	n
+  <=	20;	n
+  <=	32;	ende <=	36;	endc <=
+  2;	end else if(x>=
+1)	begin r	<=
+  23;
+  endc	<= -13;
+  ende	<=	-52;
+  n <= 
+76;
+  n <= 42; end
+  else	begin 
+n 
+<=
+  1; r 
+<=
+  -49; endc	<=
+  -36; ende <= 
+71; end	ende <= 
+-43;	k
+  <= 88;	end_b 
+<= -80;	endc
+  <= 
+12;	r
+  <=
+  40;	e
+  <= 93;	endend
+  <=	84;	en <= 
+75;	end
+if (x <= -8)
+  begin
+  if((t )	== -14) begin n <= 
+79; endend <= 21; en
+  <= 1; end else if ((x	>=-6))	begin endend 
+<=
+  -90;	n <= 
+-16;	en <= -70;	n <=
+  46;	end else
+  begin 
+endend	<=	92; en <=
+  74; n
+  <= -86;	end en 
+<= -65; endend	<=	60; e 
+<=
+  -52; e 
+<= 
+-99; end0 <= 33;
+  end else if (y <=
+5)	begin 
+if(t	>=3)
+  begin	n <= -64;	e
+  <= 
+-49;	endend	<=
+  69;	endend <=
+  -98;	end 
+else begin endend	<=	44;	n 
+<=
+  -44;	e	<= 81;
+  end endend 
+<= 3; e <=
+  -48; en	<=	63; if
+(t >=-10) begin	en 
+<= 84;	endend <= -46; end	else begin	endend
+  <= 83;
+  en
+  <= -76; end endend
+  <= 
+6; if(x==-10) 
+begin end0	<= 
+-25; end else begin end0	<= 
+-19;
+  end
+  end else 
+begin 
+if (t<=
+-15)
+  begin	end0
+  <=
+  -53;
+  e
+  <=	-71;
+  e 
+<= -69;
+  en	<=	-47;
+  end else if (t	== -2) 
+begin en	<= 100; 
+end0
+  <=	-77; 
+e <= -23;
+  end else begin 
+e 
+<= 20; 
+en	<= -42; 
+end0 
+<=
+  48; end	if(y	!= -13) begin	end0
+  <=
+  16;	end0
+  <= -72;	endend 
+<=	52;	en <= 
+-90;
+  end else if (!(( t >=-10 ) && 
+t==1)
+  &&
+  t> 1)
+  begin
+  end0
+  <=	-39;	en	<=
+  -31;	en <= -70;	endend 
+<=	45; 
+end	else begin
+  endend <=
+  -50; en 
+<=	-68; end0 
+<=	36; end	if(y==7)
+  begin n	<= 32;
+  n <= 
+-79; 
+end
+  else
+  begin 
+n
+  <= -45; end	end0 
+<= 81;	e 
+<=	-82; end
+if((y >= -16)	||	! (( y !=
+16 ) &&	t	!=
+-11)	&&	x	<= -13) begin ende 
+<= 66;	if
+(y	>=
+-16) begin endc	<= 54;	end else if (x	< 14)	begin
+  endc <=	45; end	else begin endc <= 
+-8; endc <= 
+-69; 
+end	if(!((y	==10) 
+&& t	< 1))	begin	endc 
+<= -47; r <= 47; 
+end	else begin endc	<= -56; endc 
+<= 8; r 
+<= 
+61;
+  end	endc <= 2; end else if ((x<
+14 ||	y	==
+10)) begin r <= 
+74; 
+endc	<=	-52; 
+if(!(t	>= -8) && ((t<= -19	&&
+  x	> 20
+  ||	(t != 16	|| 
+(
+y<
+14))) &&
+  x >=
+2)) begin
+  ende 
+<= 82; r <= -73;
+  end	else
+  begin
+  ende 
+<= 20; r	<= -14; end 
+end else if
+(x	==
+13) 
+begin endc <=
+  -47; r <=
+  -51; ende	<= 32; end 
+else	begin 
+if
+(t	<=4)
+  begin endc <=
+  -78; 
+end 
+else begin endc <=	46;
+  end r <= -14; r <= 
+18; ende <= -48; endc
+  <= -10; end
+if (x	==
+-15)
+  begin
+  r
+  <= 
+66; 
+ende
+  <= -43; 
+if
+(x	!=-10) begin	r <=	95; endend <= 
+64; ende	<=
+  -99; r 
+<= 
+-4; end_b	<= -40; e <= 
+24; end0 <= 42; end0	<=
+  -77; k <= 
+-56;	end	else
+  begin end_b
+  <= 13;	k <=	42;	endend
+  <= -44;	r <=
+  -45;	endend
+  <=
+  -4;	end0 <= 
+34;	e 
+<= 
+33;	ende	<= 
+-46;	end0
+  <=	-33;	end0
+  <=	17;	end 
+r <= 61; 
+if
+(t >=
+-18) 
+begin enda	<= -63;
+  a
+  <= 
+-18;
+  en <=	-6;
+  n	<= 79;
+  end_b <= 85;
+  end_b <= -91;
+  r	<= 
+-65;	end else
+  begin
+  r <= -58; 
+n <= -41; 
+n 
+<=
+  -5; 
+a
+  <= 25; 
+end_b <= -45; 
+enda	<= -21; 
+en
+  <=
+  -43; end 
+if (t >
+12)	begin 
+end_b	<= 6; 
+end_b <=	33; 
+enda	<=
+  -18; 
+n <=	-41; 
+endend <=	15;	end 
+else if ((( y== -19 )	|| (x !=6 
+&&
+  y <
+12) || (t<=
+17 
+|| 
+(t !=7	|| y<=4)))
+  &&	t	< 5)
+  begin n <=
+  -82; 
+endend
+  <= 74; 
+end_b 
+<= -98; 
+enda	<= 94; end 
+else begin n 
+<= -41; 
+endend <= -47; 
+enda
+  <= -66; 
+end_b <= 
+88; end 
+endend
+  <= -7; 
+n	<= 63; 
+if((
+x>=
+-2
+  && 
+((y ) >= -4 && x <= 9
+  &&	((x ) 
+<= 14	&& t	<
+19)) && x !=-15))
+  begin 
+endend
+  <=
+  82; en
+  <= 
+-94; end_b <= -50; n <= -15; en <= -19; end_b 
+<= 91; k <=
+  -86; e 
+<= 
+-33; endend 
+<= -87; 
+end	else if(y!=
+1) begin	k <= 43; e <=
+  77; end_b <= -96; n	<= 
+20; endend	<=	-62; endend
+  <=	81; en <= -41; end	else 
+begin k 
+<= 49; en <= 17; end_b
+  <= 8; endend
+  <= -86; e
+  <= -94; n	<=
+  -26; e <= 
+16;	end 
+if (!(t <
+15)) begin 
+a <= 
+61;	end0 <=	-50;	end_b <= 83;	k <=
+  83;	n 
+<= -81;	k
+  <= 59; end 
+else begin 
+n <= 71;	k <=	22;	end_b
+  <=	80;	a <= 85;	end0	<= -74; end 
+end0	<= -66; 
+if (( t!= 13
+  &&
+  x <
+10 ))	begin en <= 95; a <= 
+-8; en <=
+  17; enda <=	-71; endend 
+<=	21; endend
+  <= -53; end	else 
+begin	enda <= 
+87;
+  endend	<= 25;
+  a <= -37;
+  en	<=	31;
+  a <= -62; end 
+if
+(y	!= 0) begin end0 <= -28;
+  a <= 
+-97;
+  r
+  <=
+  5;
+  a <=
+  45;
+  enda	<=
+  64;
+  e <=	86;
+  endend	<= -22; end else begin 
+end0 <= 38;	enda
+  <= -86;	a <=	-19;	r <= 90;	endend <= -88;	e <=
+  16; end 
+ende
+  <= 
+91; 
+if(t	>
+1) 
+begin 
+en
+  <= 
+-21; ende <=	-73; end_b
+  <= 32; enda
+  <=
+  6; n 
+<= 
+70; end0 
+<= 38; a 
+<=
+  78; k 
+<= 45; r 
+<= -94; r	<=	9; enda 
+<= -26; end 
+else
+  begin
+  k	<=
+  88; r 
+<=	81; r <= 
+-49; n 
+<=	-16; en 
+<=
+  25; end0
+  <=	71; ende <=
+  -4; enda	<=
+  -58; end_b <=	41; a
+  <=
+  45;	end
+  end else
+  begin a	<=
+  -93; en
+  <= -34; if(x	<= -13)	begin 
+ende
+  <= -87; 
+en
+  <=
+  -78; 
+e	<= 43; 
+end_b <=	17; 
+endend <=
+  39; end
+  else	begin endend
+  <=	-9; en	<=
+  -59; ende	<= -64; e
+  <= 29; end_b <= 12;
+  end endend
+  <= -30; if
+((y ) <= 15)	begin	enda <=
+  58; n 
+<= 69; en <=
+  75; n	<= 
+73; end0	<= 
+-17; e
+  <= -13; k	<=	41; end	else if (x	<=0) begin k <= -95; 
+n <= 
+-17; 
+en 
+<= 
+-15; 
+enda <=
+  44; 
+e <= -6; 
+end0 <= 60;	end 
+else 
+begin
+  end0 <= 
+-4; en
+  <= 
+-47; k 
+<= -65; en 
+<=	-44; en <= -33; e <=	-73; enda
+  <=	41; e
+  <= 97; n <= -51; end0
+  <=	86; end if
+(x<= 2) begin 
+endend
+  <=
+  4; 
+enda	<=	-94; 
+r	<= -56; 
+a <=	-11; 
+end0	<= 14; 
+end 
+else begin 
+end0 
+<=	-95;	enda <= 1;	a
+  <=	-88;	endend <=
+  -64;	r	<= -60; end enda <= -99; end0 <= -8; e
+  <= 45; end_b	<=	-15; enda 
+<=	57; n
+  <=
+  -52; 
+end
+if (x	< 10)
+  begin 
+endend <= 14; if(y <=
+10)
+  begin	ende <= 
+-34;
+  end_b	<= 79;
+  n
+  <=	30;
+  a 
+<=
+  36;
+  ende
+  <= 
+87;
+  endend
+  <= 
+-66;
+  e <= -49; 
+end	else if(t !=8) 
+begin
+  n
+  <= -58;
+  endend	<= 
+-73;
+  endend
+  <= 
+-92;
+  ende 
+<= 76;
+  e	<=	-32;
+  end_b
+  <= 
+33;
+  endend <= -42;
+  a 
+<= 76; 
+end else begin
+  n
+  <=
+  -67; end_b 
+<= -82; a	<=	-70; ende <= 79; endend
+  <= 88; a <=	12; e 
+<=	41; end end_b <=	-42; a	<=	69; enda <=
+  -64; en 
+<=
+  -4; r	<= 
+-50; if(t	>
+19) 
+begin
+  e	<= 87; 
+endend <= -60; 
+endc <= 
+-53; 
+n <=
+  -50; 
+en
+  <=	46; 
+ende	<=
+  -30;
+  end 
+else if((t <=
+-7)) 
+begin 
+ende	<=
+  -65; endend <= 
+60; e <= -57; endc 
+<= 73; n
+  <=
+  72; en
+  <= -75;
+  end else	begin en <=	11;	endc	<= -54;	n	<=	-59;	endend <= 12;	ende <=	-75;	e
+  <= 13;	e <= 
+96; end ende	<=	-45; e 
+<= 
+-22; ende <= 46;	end
+  else begin ende 
+<= 87;
+  if (t	> 13)	begin 
+en	<= 25; endc 
+<=	-47; enda
+  <=
+  -1; endend	<= 0; n <= 58; end_b 
+<=
+  12; a 
+<=	35; end
+  else if
+((y ) 
+> 7) begin en
+  <=
+  30;
+  a
+  <=	-6;
+  endc 
+<=	-98;
+  enda	<=	24;
+  end_b	<= 
+-51;
+  endend
+  <= -24;
+  n 
+<= -48;
+  endc <= 68;
+  enda <= -25;
+  endc <= 84;	end
+  else begin
+  a	<= 71;	n <= -25;	n <=	39;	endc <= -77;	end_b	<= -24;	enda <=	-6;	enda	<= 
+57;	endend <=	6;	en <= 18; end
+  enda 
+<=	11;
+  end_b <=
+  -49;
+  endend
+  <=	-4;
+  e	<=	-29;
+  en <= 
+66;
+  r <=
+  -49;
+  a <= 
+56;
+  if((y >= -16)) begin	n	<=
+  29;	enda <= 
+-4;	endc	<= 
+-78;	endc
+  <= 28;	end
+  else	begin 
+n	<= 
+41; enda 
+<=	-65; endc <=	12; end	end
+if(!(t<=19)) begin	if(t>= -19)	begin
+  k 
+<= 41;	endend <=	-63; end 
+else if(t>=-17 && 
+(t	!=
+-4 &&	(
+y!=13)) &&	(t	> 2
+  &&
+  y!=15 
+&&	(x	<=
+-3 
+|| (
+x==
+-10))
+  || t>= -16 && x !=
+4)) 
+begin	endend
+  <=	38;	k <= -69; end
+  else 
+begin k	<=	-64; 
+endend
+  <= 
+-70;	end
+  a <= -42;
+  if
+(t	<=
+0)
+  begin	k	<=	-20;
+  endend <=	-63; 
+end 
+else begin endend <=
+  -36; k
+  <= 57; end end	else
+  begin	a	<= 
+-69; 
+if (t > 14) begin	a 
+<=
+  -11; endend
+  <= -47; k <= 
+-77; k
+  <=	2; k <= 16; end else	begin
+  endend	<=
+  4; k
+  <=	1; a <=
+  11; end 
+endend	<= 79; end
+if
+(y ==-20) begin
+  endend <= 10; 
+end_b <= -23; end else if
+(x	< 7)	begin
+  endend
+  <= 22;	end_b <= -4;	endend	<= 
+47;	end else if ((x )
+  <= 14)	begin endend 
+<= 65; 
+if
+((x > 18)) 
+begin
+  end_b <=	-45;
+  end	else if (t< 2) begin end_b 
+<= 95; 
+end_b	<= 87; 
+end else if(x < 14)
+  begin
+  end_b	<= -53; 
+end else
+  begin	end_b	<=
+  -21;
+  end 
+end_b
+  <= 
+-11; end else	begin end_b <=
+  -56; if
+(y	<=6) begin endend <= 
+16; 
+end_b <= 91; 
+end	else if((
+y	<
+20))
+  begin 
+end_b
+  <= -18; endend	<= -33; end else if (t <
+12 ||	(x ) >= 3) begin	endend	<=	-54; end_b <= 14; 
+end	else begin 
+endend
+  <=
+  98;	end_b <= 7; end	end
+if (y	>=
+20) begin 
+endc
+  <= -58;
+  ende <=	-47;
+  k <=	-70;
+  end_b	<= -70;
+  ende <=
+  65;
+  a	<= 48; 
+end
+  else 
+begin a
+  <= 93;	if
+(y<
+3) 
+begin 
+endc <= 
+-18; 
+ende
+  <= 
+14; 
+k <= -91; 
+end_b
+  <=
+  -87;	end else if
+(!(x != -5))
+  begin
+  ende <=
+  -71; end_b <=
+  -7; k
+  <=
+  -63; endc <=	8; k	<= 13;
+  end
+  else if(t	==
+6 &&
+  ! (! ((
+(y	<
+7)
+  && y	== 8)))) 
+begin ende 
+<= 
+86;	k <= 55;	end_b <= 5;	end_b <=	-56;	endc 
+<= -92; end else begin endc <=	-22; ende 
+<= 31; k <= 
+75; end_b 
+<=	-61;	end	if(!(!(y	==7))	|| (t<
+7	|| y	!=
+-12)) begin	k 
+<= -8; end
+  else	begin	k 
+<= 31;	end	if ((y ) 
+<= 11 &&
+  x	<
+3) 
+begin	ende
+  <= 
+44; 
+end_b 
+<= 
+-89; 
+ende
+  <=	-34; 
+endc <=	-80; end	else if (y	!=-5) begin end_b <= -22; ende
+  <= -70; endc	<=
+  100;
+  end else begin 
+ende
+  <= 
+54;	end_b	<= 
+-28;	endc
+  <= 
+-41; end	ende	<=	-3;	if((t )	<= 12)
+  begin ende <=	-72; 
+endc <= -6; 
+a
+  <=
+  41; 
+end 
+else begin
+  endc 
+<=
+  -5; ende
+  <=	-19; a 
+<= -85;
+  end	end_b
+  <=
+  76;
+  end
+if (y!=12) begin	if
+(!((y<
+14))) begin	k	<= 36; end else
+  begin k 
+<=	-8; k	<=	47;	end end 
+else if(x< 6) begin 
+if (t==-5) begin k	<= 
+35;	end	else 
+begin k <=
+  -14; k
+  <= -11; end 
+k
+  <= 89;	end else if
+((y ) > 5) 
+begin	k <= 
+83; end else
+  begin	if ((! ((
+x	<=
+14 && x !=8))
+  || (y )	> 17	||
+  x ==
+-15)) begin	k 
+<=
+  39;
+  k 
+<=	13; end
+  else if((t ) >= -9) begin 
+k <=	93;	k <= -19;
+  end else if(!(t	==
+8)) begin k 
+<= -81; 
+end	else 
+begin 
+k 
+<= -42; end end
+if
+(t !=-1) 
+begin 
+enda
+  <= 88; 
+if
+((y	<=
+-13)) begin en	<= 83; en <= 
+-48;
+  end
+  else if((t )
+  <= -6)
+  begin en
+  <=
+  7;
+  end
+  else begin en
+  <= 
+-62;	end end else begin	en <=	-56;	enda <= 19;	enda 
+<=	-45; 
+end
+if (( t>
+3 )) begin 
+end_b
+  <= -34;	end	else begin if(x>
+13)
+  begin	end_b <=	-66; end 
+else if (! (! (x !=-9)	&&	x	> 2) &&	(t==-19 
+&& 
+t	<= 18
+  && (x	<= 6 &&
+  y<
+5)
+  || x!=
+-10
+  && (y!=
+7) &&	((x	>
+7)
+  &&	(y )	>= -1))) begin end_b <= 
+11;	end 
+else begin end_b
+  <=	71; end end
+if(x < 9) begin if (( y	==
+19 )) begin	en 
+<= -79;	a	<= 
+-43;	end_b
+  <=	-40;	a <=	67;
+  end 
+else 
+begin 
+en <=
+  33; 
+end_b	<= -92; 
+a <= 30; 
+en
+  <= 
+91; end	if
+((
+t!=
+-20	&&
+  (x!=
+-4 && (x == -14))) && (( x <=6	&& 
+t ==
+-13 )	&& (
+x>= -17)) || 
+x<
+4) 
+begin n	<= 48;
+  a	<= 15;
+  endend	<= 11;
+  enda <=
+  54;
+  end_b 
+<= 
+49; end	else	begin
+  endend	<= 29;	a	<=	27;	n <=	61;	n	<=	-35;	end_b
+  <=	-93;	enda <= 95;
+  end	if(! (( x == 9 ) && ((t )
+  < 18
+  && t	<=11))) 
+begin k 
+<= -28; end_b 
+<= 24; end_b 
+<=	-18; n
+  <= 
+59; a 
+<= 21; r 
+<= 
+-37; a <=	-93; endend <= -74; end else 
+begin	endend
+  <=	-96; k 
+<= 
+-69; n <= 
+98; r
+  <= 65; end_b 
+<=	-32; a
+  <=	-13; end	e 
+<= -9;	k <=	42;	en <= 98;	r
+  <=
+  -74;	if
+((y > 15)) begin e <= 38;
+  endc <=
+  38;
+  en
+  <= 81;
+  r 
+<=	7; end
+  else if(x	!= -2) begin endc <= -31;	r 
+<= 
+97;	e <= -76;	en <=
+  98; end else if
+(t >
+10)
+  begin 
+en <=
+  20;
+  r
+  <= 
+-26;
+  endc
+  <= 45;
+  r	<= 
+19;
+  e 
+<=
+  41; end else
+  begin en 
+<=
+  30; endc <=
+  -60; e <=	12; r 
+<=	54; 
+end	if
+(!(x	>= -11
+  &&	!(!(x >=-17))))
+  begin
+  end_b <= 31; 
+endend 
+<=	-26; 
+enda	<=
+  18; 
+enda 
+<= 
+-7; 
+a 
+<=	-87; end else	begin end_b
+  <= 8;
+  a	<= -7;
+  enda <=
+  -98;
+  endend <= 86; 
+end	k <=	-52;	endend	<=
+  -7;	k 
+<= -97; 
+end	else 
+begin	endc 
+<= 
+-66; 
+en <=
+  40; 
+r	<= 61; 
+k
+  <=
+  -14; 
+e <= 
+90; 
+e 
+<= -26; 
+enda 
+<= -87; 
+end_b	<=
+  86; 
+if(( t >
+11 ))	begin k
+  <= 
+-79; endc	<= -85; a
+  <= 
+80; endc	<=
+  40; 
+end	else 
+begin
+  endc <= -73; k <=
+  7; a	<= -29; endc <= -52; 
+end 
+end_b <=
+  -11; 
+if
+(( t <=
+2 
+|| (! (y != 2)	|| 
+(
+(x )	>= 1)) )) begin
+  enda
+  <=
+  79; endend 
+<= 
+-36; n <= 
+72; n 
+<=	55; r 
+<= 
+89; endend
+  <=
+  21; k
+  <=	-5; n
+  <= -78; end 
+else if
+(y <
+3)
+  begin k	<=
+  -84; enda 
+<= 
+-5; n	<=
+  -58; endend	<= -67; r 
+<= 
+-27;	end
+  else
+  begin
+  enda <= 
+-63; n <= -49; enda <=
+  47; k <= 
+96; endend
+  <=
+  -30; n
+  <=	-47; r <= -61; end 
+if
+(t <=
+11) begin enda
+  <= 0; 
+a <= 77; 
+r <= 
+81; 
+endend <= 
+-28; 
+end_b	<= 68; 
+end
+  else begin	a	<= -66; r <=
+  44; end_b <= -58; endend <= 
+-72; enda <=	33; end
+  end
@@ -0,0 +1,107 @@
+#!/bin/sh
+# Command-line checks for make check, run from the top of the tree once everything is built:
+# the block cache, the rule store round trip, watch mode and the C model of the RTL.
+set -e
+
+tmp=$(mktemp -d)
+watcher=
+trap 'test -z "$watcher" || kill $watcher 2>/dev/null; rm -rf "$tmp"' EXIT
+
+fail()
+{
+    echo "check_cli: $*"
+    exit 1
+}
+
+# -r exits with 1 when a block failed, anything else is a crash or a usage error
+recover()
+{
+    out=$1
+    shift
+    ./carser "$@" > "$out" < /dev/null || test $? -eq 1 || fail "carser $* crashed"
+}
+
+# Block cache: a cold and a warm run print exactly what an uncached run prints
+for input in tests/blocks.v check_corpus.v; do
+    recover "$tmp/plain" -r "$input"
+    recover "$tmp/cold" -c "$tmp/cache.bin" -r "$input"
+    recover "$tmp/warm" -c "$tmp/cache.bin" -r "$input"
+    cmp "$tmp/plain" "$tmp/cold" || fail "$input: the first cached run differs from an uncached one"
+    cmp "$tmp/plain" "$tmp/warm" || fail "$input: the second cached run differs from an uncached one"
+done
+echo "block cache: cached runs match uncached ones"
+
+# Rule store: 3000 rules written with -r -o list back exactly as they were parsed
+./carser_bench -n 3000 -r 1 -o "$tmp/rules.v" > /dev/null
+./carser -r -o "$tmp/rules.store" "$tmp/rules.v" > "$tmp/written" < /dev/null
+grep -q "^Wrote 3000 rules to " "$tmp/written" || fail "the rule store did not take 3000 rules"
+grep "^block " "$tmp/written" | sed 's/^block /rule /' > "$tmp/expected"
+./carser -l "$tmp/rules.store" > "$tmp/listed"
+cmp "$tmp/expected" "$tmp/listed" || fail "the rule store does not list the rules it was written with"
+
+# Blocks the format cannot hold are counted and fail the run
+recover "$tmp/skipped" -r -o "$tmp/skipped.store" tests/blocks.v
+grep -q "skipped [1-9][0-9]* unsupported blocks" "$tmp/skipped" || fail "skipped blocks are not reported"
+
+# A damaged header is refused, never read: bytes written at offset, and a truncated file
+corrupt()
+{
+    cp "$tmp/rules.store" "$tmp/bad.store"
+    printf "$2" | dd of="$tmp/bad.store" bs=1 seek="$1" conv=notrunc 2>/dev/null
+    status=0
+    ./carser -l "$tmp/bad.store" > "$tmp/bad" || status=$?
+    test $status -eq 1 && grep -q "is not a rule store" "$tmp/bad" || fail "a store damaged at byte $1 was not refused"
+}
+corrupt 0 'X'                                   # magic
+corrupt 8 '\377'                                # version
+corrupt 12 '\000'                               # byte order
+corrupt 16 '\377\377\377\377\377\377\377\000'   # rule count
+corrupt 40 '\001'                               # first section offset, misaligned
+corrupt 96 '\000\000\000\000\000\001'           # names section offset, past the end
+head -c 1000 "$tmp/rules.store" > "$tmp/bad.store"
+./carser -l "$tmp/bad.store" > "$tmp/bad" && fail "a truncated store was not refused"
+test $? -eq 1 || fail "a truncated store crashed carser -l"
+echo "rule store: 3000 rules round-trip, damaged headers are refused"
+
+# Watch mode: an edit to one block reparses and prints that block only
+i=0
+while test $i -lt 200; do
+    echo "if (x > $i) begin a <= $i; end else begin a <= -$i; end"
+    i=$((i + 1))
+done > "$tmp/watched.v"
+
+# Wait up to 10 seconds for a line in the watcher's output
+wait_for()
+{
+    n=0
+    until grep -q "$1" "$tmp/watch"; do
+        n=$((n + 1))
+        test $n -le 100 || fail "watch mode never printed \"$1\""
+        sleep 0.1
+    done
+}
+
+./carser -w "$tmp/watched.v" > "$tmp/watch" < /dev/null &
+watcher=$!
+wait_for "^200 blocks, 200 reparsed"
+sed -i 's/begin a <= 100;/begin a <= 777;/' "$tmp/watched.v"
+wait_for "^200 blocks, 1 reparsed, 1 changed, 0 removed"
+kill $watcher
+wait $watcher 2>/dev/null || true
+watcher=
+grep -q "^block 100: if (x > 100) a = 777; else a = -100;$" "$tmp/watch" || fail "watch mode did not print the edited block"
+test "$(grep -c '^block ' "$tmp/watch")" -eq 201 || fail "watch mode printed blocks that were not edited"
+echo "watch mode: one edited block reparsed"
+
+# C model of if_else_parser_2 on the stimulus c_parser_2 writes for input.v
+./carser_rtl -x 3 tests/c_parser_2_stimulus.hex | grep -q "p=-73 var=My_assign_Var" || fail "carser_rtl: x=3 does not give -73"
+./carser_rtl -x 6 tests/c_parser_2_stimulus.hex | grep -q "p=37 var=My_assign_Var" || fail "carser_rtl: x=6 does not give 37"
+./carser_rtl -x 3 -t "$tmp/model.log" tests/c_parser_2_stimulus.hex > /dev/null
+./carser_rtl -x 3 -l "$tmp/model.log" tests/c_parser_2_stimulus.hex > /dev/null || fail "carser_rtl does not follow its own trace"
+
+# Traces the RTL wrote with if_else_parser_tb.v +trace=1: input.v at x = 3, and a block with a missing ')'
+./carser_rtl -x 3 -l tests/if_else_parser_tb_trace.log tests/c_parser_2_stimulus.hex > /dev/null ||
+    fail "carser_rtl does not follow the RTL trace of input.v"
+./carser_rtl -x 0 -l tests/paren_error_trace.log tests/paren_error_stimulus.hex > /dev/null ||
+    fail "carser_rtl does not follow the RTL trace of tests/paren_error.v"
+echo "carser_rtl: input.v evaluates to -73 and 37, recorded RTL traces followed"
@@ -0,0 +1,124 @@
+#!/bin/sh
+# Simulation checks for make sim, run from the top of the tree with iverilog and vvp on the PATH
+# once carser_bench and carser_rtl are built: the trace levels of if_else_parser_2, the wide parser
+# against it, the parser array's dispatcher, drain counter and lane resets, and the streaming
+# interface.
+set -e
+
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+fail()
+{
+    echo "check_rtl: $*"
+    exit 1
+}
+
+# Trace levels, on input.v at x = 3. The level 2 dump prints the NUL of an idle ascii_char, which
+# is dropped before comparing.
+iverilog -o "$tmp/parser_tb" if_else_parser_2.v if_else_parser_tb.v
+for level in 0 1 2 3; do
+    vvp "$tmp/parser_tb" +x=3 +stim=tests/c_parser_2_stimulus.hex +trace=$level | tr -d '\000' > "$tmp/trace$level"
+done
+grep -q "^Test passed! Value *-73 " "$tmp/trace0" || fail "parser_tb: input.v does not give -73 for x = 3"
+! grep -q "^cycle \|^State: \|^EVALUATING: " "$tmp/trace0" || fail "+trace=0 is not silent"
+./carser_rtl -x 3 -l "$tmp/trace1" tests/c_parser_2_stimulus.hex > /dev/null || fail "carser_rtl does not follow the +trace=1 trace"
+grep -q "^EVALUATING: " "$tmp/trace1" && ! grep -q "^State: " "$tmp/trace1" || fail "+trace=1 does not print level 1 only"
+grep -v "^cycle " "$tmp/trace2" | cmp - tests/if_else_parser_tb_debug.log || fail "+trace=2 differs from the old debug output"
+grep "^cycle " "$tmp/trace1" > "$tmp/cycles1"
+grep "^cycle " "$tmp/trace2" | cmp - "$tmp/cycles1" || fail "+trace=2 does not have the +trace=1 lines"
+cmp "$tmp/trace2" "$tmp/trace3" || fail "+trace=3 is not clamped to TRACE_MAX = 2"
+
+# A lower TRACE_MAX clamps the level, and TRACE_MAX = 0 compiles the tracing out
+for max in 0 1; do
+    iverilog -Pif_else_parser_tb.TRACE_MAX=$max -o "$tmp/parser_tb$max" if_else_parser_2.v if_else_parser_tb.v
+    vvp "$tmp/parser_tb$max" +x=3 +stim=tests/c_parser_2_stimulus.hex +trace=2 | tr -d '\000' > "$tmp/trace_max$max"
+    cmp "$tmp/trace_max$max" "$tmp/trace$max" || fail "TRACE_MAX = $max, +trace=2 is not +trace=$max"
+done
+# The RTL traces check_cli.sh holds carser_rtl to are still what the RTL writes
+vvp "$tmp/parser_tb" +x=3 +stim=tests/c_parser_2_stimulus.hex +trace=1 +trace_file="$tmp/rtl.log" > /dev/null
+cmp "$tmp/rtl.log" tests/if_else_parser_tb_trace.log || fail "tests/if_else_parser_tb_trace.log is out of date"
+vvp "$tmp/parser_tb" +x=0 +stim=tests/paren_error_stimulus.hex +trace=1 +trace_file="$tmp/rtl.log" > /dev/null
+cmp "$tmp/rtl.log" tests/paren_error_trace.log || fail "tests/paren_error_trace.log is out of date"
+echo "parser trace: level 0 silent, 1 followed by carser_rtl, 2 the old debug output, clamped to TRACE_MAX"
+
+# A carser_bench corpus as a $readmemh stimulus, each block ended by 00 and the last one by 00 00.
+# Every block ends with "end" and the next one starts with "if", which no identifier spells.
+blocks=500
+./carser_bench -n $blocks -E 0.1 -r 1 -o "$tmp/corpus.v" > /dev/null
+od -An -v -tx1 "$tmp/corpus.v" | tr -s ' ' '\n' | awk '
+    NF == 0 { next }
+    $1 == "69" && ws && last == "656e64" { print "00" }
+    { print }
+    $1 == "20" || $1 == "09" || $1 == "0a" || $1 == "0d" { ws = 1; next }
+    { ws = 0; last = substr(last $1, length(last $1) - 5) }
+    END { print "00"; print "00" }' > "$tmp/corpus.hex"
+
+# Wide parser: every lane count gives the 1-char parser's result for every block
+for lanes in 1 2 3 4 8; do
+    iverilog -Pif_else_parser_wide_tb.LANES=$lanes -o "$tmp/wide_tb" if_else_parser_2.v if_else_parser_wide.v if_else_parser_wide_tb.v
+    vvp "$tmp/wide_tb" +x=3 +stim=tests/c_parser_2_stimulus.hex > "$tmp/wide"
+    grep -q "^block 0: $lanes-lane parser: value -73 assigned" "$tmp/wide" || fail "$lanes lanes: input.v does not give -73 for x = 3"
+    for x in -50000 0 50000; do
+        vvp "$tmp/wide_tb" +x=$x +stim="$tmp/corpus.hex" +trace=1 +trace_file="$tmp/wide.log" > "$tmp/wide"
+        grep -q "^Results match the 1-char parser in $blocks blocks\.$" "$tmp/wide" ||
+            fail "$lanes lanes, x = $x: $(grep -m 1 MISMATCH "$tmp/wide" || tail -n 1 "$tmp/wide")"
+
+        # Each parser traces to a file of its own, and both evaluate the same blocks the same way
+        grep -v "^cycle " "$tmp/wide.log.if_else_parser_wide_tb.uut_1" > "$tmp/wide_1.log"
+        grep -q "^EVALUATING: " "$tmp/wide_1.log" || fail "$lanes lanes, x = $x: the 1-char parser's trace is empty"
+        cmp "$tmp/wide_1.log" "$tmp/wide.log.if_else_parser_wide_tb.uut_n" ||
+            fail "$lanes lanes, x = $x: the traces of the two parsers differ"
+    done
+done
+echo "wide parser: 1 to 8 lanes match if_else_parser_2 on $blocks blocks"
+
+# Parser array: every third block is cut in half and must be posted incomplete by the drain
+# counter, results wait behind a stalling consumer, and every other block, including the next
+# one on a lane after its reset, gives carser_rtl's result for its x
+iverilog -o "$tmp/array_tb" if_else_parser_2.v if_else_parser_array.v if_else_parser_array_tb.v
+vvp "$tmp/array_tb" +x=5 +stim=tests/c_parser_2_stimulus.hex +cut=3 +stall=1 +trace=1 +trace_file="$tmp/array.log" > "$tmp/array"
+grep -q "^All 64 results match the single-lane array\.$" "$tmp/array" ||
+    fail "parser array: $(grep -m 1 "^MISMATCH\|^Missing" "$tmp/array" || tail -n 1 "$tmp/array")"
+test "$(grep -c "^block [0-9]*: x=-*[0-9]* p=0 done=0 error=0 cut$" "$tmp/array")" -eq 21 ||
+    fail "parser array: the cut blocks are not all posted incomplete"
+grep "^block [0-9]*: .* done=1 error=0$" "$tmp/array" | sed 's/^block [0-9]*: x=\([^ ]*\) p=\([^ ]*\) .*/\1 \2/' > "$tmp/array_full"
+test "$(wc -l < "$tmp/array_full")" -eq 43 || fail "parser array: not every whole block was parsed"
+while read -r x p; do
+    ./carser_rtl -x "$x" tests/c_parser_2_stimulus.hex | grep -q ": p=$p var=" ||
+        fail "parser array: block with x = $x gave $p, carser_rtl does not"
+done < "$tmp/array_full"
+
+# One trace file per lane, each with the blocks that lane parsed and nothing overwritten
+test ! -e "$tmp/array.log" || fail "parser array: a lane traced to the shared file"
+started=0
+parsed=0
+for lane in 0 1 2 3; do
+    log="$tmp/array.log.if_else_parser_array_tb.uut_n.lane[$lane].parser"
+    n=$(grep -c ": state 0 -> 1$" "$log") || fail "parser array: lane $lane got no block"
+    started=$((started + n))
+    parsed=$((parsed + $(grep -c ": parsing_done$" "$log" || true)))
+done
+test $started -eq 64 && test $parsed -eq 43 ||
+    fail "parser array: the lane traces start $started blocks and finish $parsed, not 64 and 43"
+echo "parser array: 4 lanes, cut blocks drained, lanes reset between blocks"
+
+# Streaming interface: without stalls, one cycle per character plus at most two after each of
+# the 4 incomplete blocks in 50; with random and with long consumer stalls, every result still
+# comes back in order while results wait for m_ready and characters for s_ready
+iverilog -o "$tmp/stream_tb" if_else_parser_2.v if_else_parser_stream.v if_else_parser_stream_tb.v
+vvp "$tmp/stream_tb" +x=5 +blocks=50 +stall=0 > "$tmp/stream"
+grep -q "^All 50 blocks returned in order with the expected results\.$" "$tmp/stream" ||
+    fail "stream, no stalls: $(grep -m 1 "^Block\|^Extra\|^FAILED" "$tmp/stream")"
+awk '/ characters in / { exit !($4 <= $1 + 1 + 2 * 4) }' "$tmp/stream" ||
+    fail "stream, no stalls: $(grep " characters in " "$tmp/stream"), not one cycle per character"
+for stall in 1 2; do
+    for seed in 1 2 3; do
+        vvp "$tmp/stream_tb" +x=5 +blocks=300 +stall=$stall +seed=$seed > "$tmp/stream"
+        grep -q "^All 300 blocks returned in order with the expected results\.$" "$tmp/stream" ||
+            fail "stream, stall $stall, seed $seed: $(grep -m 1 "^Block\|^Extra\|^FAILED" "$tmp/stream")"
+    done
+done
+grep -q "^Results waited for m_ready on [1-9][0-9]* cycles, characters waited for s_ready on [1-9][0-9]*$" "$tmp/stream" ||
+    fail "stream: long stalls never held back both a result and a character"
+echo "streaming interface: 950 blocks in order, with and without stalls"
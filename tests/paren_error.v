@@ -0,0 +1,5 @@
+if ((v <= 5) begin
+  a <= 1;
+end else begin
+  a <= 2;
+end